@@ -107,7 +107,7 @@ watches = {
 #    hand, bitmapParams, vectorParams
 #
 #  For bitmapParams:
-#     (filename, colorMode, asymmetric, pivot, scale)
+#     (filename, colorMode, asymmetric, pivot, scale[, rotate])
 #
 #   hand - the hand type being defined.
 #   filename - the png image that defines this hand, pointing upward.
@@ -124,6 +124,11 @@ watches = {
 #   pivot - the (x, y) pixel point of the center of rotation of the
 #       hand in its image.
 #   scale - a scale factor for reducing the hand to its final size.
+#   rotate - optional; True to store only a single bitmap of the hand
+#       pointing upward and rotate it at runtime (see wright.c), or a
+#       list of platforms on which to do this.  This trades CPU time
+#       for resource storage, and frees the hand from the resource
+#       cost of NUM_STEPS, but the hand is drawn less smoothly.
 #
 #  For vectorParams:
 #     [(fillType, points, scale), (fillType, points, scale), ...]
@@ -607,6 +612,39 @@ numStepsSweep = {
 # type, if we are enabling caching.
 resourceCacheSize = {}
 
+# This gets populated with the (w, h) of the largest (by area) of the
+# bitmaps for each (hand, platform), so wright.c can allocate one
+# buffer big enough to decode any of them into.  The masks, where
+# present, are the same size as their images.
+handMaxSize = {}
+
+# This gets populated with the (hand, platform) pairs of the hands
+# that are rotated at runtime.
+rotatedHands = set()
+
+# The number of bytes of heap set aside on each platform for the
+# resource cache, which keeps the decoded bitmaps of the second and
+# chrono-second hands (see bwd.c).  This is enough to hold every
+# flipped variant of the second hand of most styles.
+resourceCacheBudget = {
+    'aplite' : 6144,
+    'basalt' : 10240,
+    'chalk' : 12288,
+    'diorite' : 6144,
+    'emery' : 16384,
+    }
+
+# The number of bytes of heap set aside on each platform for the
+# compressed rle cache, which keeps the raw bytes of the small rle
+# resources we read most often (see bwd.c).  0 to disable it.
+rleCacheBudget = {
+    'aplite' : 1536,
+    'basalt' : 4096,
+    'chalk' : 4096,
+    'diorite' : 2048,
+    'emery' : 6144,
+    }
+
 thresholdMask = [0] + [255] * 255
 threshold1Bit = [0] * 128 + [255] * 128
 threshold2Bit = [0] * 64 + [85] * 64 + [170] * 64 + [255] * 64
@@ -676,6 +714,54 @@ def applyLabel(outputFilename, faceIndex, platforms = None):
         outputFilename = prefix + outputBasename + faceVariant + outputExt
         face.save(outputFilename)
 
+# The names of the 64 opaque Pebble colors, as in GColorBlack
+# and so on, in order of their rgb bits.
+pebbleColorNames = [
+    'Black', 'OxfordBlue', 'DukeBlue', 'Blue', 'DarkGreen', 'MidnightGreen',
+    'CobaltBlue', 'BlueMoon', 'IslamicGreen', 'JaegerGreen', 'TiffanyBlue',
+    'VividCerulean', 'Green', 'Malachite', 'MediumSpringGreen', 'Cyan',
+    'BulgarianRose', 'ImperialPurple', 'Indigo', 'ElectricUltramarine',
+    'ArmyGreen', 'DarkGray', 'Liberty', 'VeryLightBlue', 'KellyGreen',
+    'MayGreen', 'CadetBlue', 'PictonBlue', 'BrightGreen', 'ScreaminGreen',
+    'MediumAquamarine', 'ElectricBlue', 'DarkCandyAppleRed', 'JazzberryJam',
+    'Purple', 'VividViolet', 'WindsorTan', 'RoseVale', 'Purpureus',
+    'LavenderIndigo', 'Limerick', 'Brass', 'LightGray', 'BabyBlueEyes',
+    'SpringBud', 'Inchworm', 'MintGreen', 'Celeste', 'Red', 'Folly',
+    'FashionMagenta', 'Magenta', 'Orange', 'SunsetOrange', 'BrilliantRose',
+    'ShockingPink', 'ChromeYellow', 'Rajah', 'Melon',
+    'RichBrilliantLavender', 'Yellow', 'Icterine', 'PastelYellow', 'White'
+    ]
+
+def remapColorBank(cb, c1, c2, c3):
+    """ Returns the 64-entry palette bank for the indicated colors
+    (each a name from pebbleColorNames): the rgb bits that each color
+    becomes when its r, g, and b channels are replaced with c1, c2,
+    and c3 over cb.  This must match the blend done by remap_palette()
+    in bwd.c, which consults this bank in its place. """
+
+    def channels(name):
+        i = pebbleColorNames.index(name)
+        return ((i >> 4) & 3, (i >> 2) & 3, i & 3)
+
+    def blend(v, p, c):
+        # Blend from v to c by p / 3.  The numerator is never
+        # negative, so this rounds down just as C does.
+        return (3 * v + p * (c - v)) // 3
+
+    cb, c1, c2, c3 = map(channels, (cb, c1, c2, c3))
+    bank = []
+    for pi in range(64):
+        p = channels(pebbleColorNames[pi])
+        result = []
+        for ch in range(3):
+            v = cb[ch]
+            v = blend(v, p[0], c1[ch])
+            v = blend(v, p[1], c2[ch])
+            v = blend(v, p[2], c3[ch])
+            result.append(min(v, 3))
+        bank.append((result[0] << 4) | (result[1] << 2) | result[2])
+    return bank
+
 def makeFaces(generatedTable, generatedDefs):
 
     resourceStr = ''
@@ -746,6 +832,21 @@ def makeFaces(generatedTable, generatedDefs):
         cb, db = faceColors[i]
         print >> generatedTable, "  { GColor%sARGB8, GColor%sARGB8, GColor%sARGB8, GColor%sARGB8, GColor%sARGB8, GColor%sARGB8 }," % (cb[0], cb[1], cb[2], cb[3], db[0], db[1])
     print >> generatedTable, "};"
+
+    # The palette banks for each of the above, one for REMAP_BANK_CLOCK
+    # and one for REMAP_BANK_DATE (see get_remap_clock() and
+    # get_remap_date() in wright.c).
+    print >> generatedTable, "uint8_t clock_face_remap_bank[NUM_FACE_COLORS][NUM_REMAP_BANKS][REMAP_BANK_SIZE] = {"
+    for i in range(len(faceColors)):
+        cb, db = faceColors[i]
+        print >> generatedTable, "  {"
+        for bank in [remapColorBank(*cb), remapColorBank(db[0], db[1], db[0], db[0])]:
+            print >> generatedTable, "    {"
+            for row in range(0, 64, 16):
+                print >> generatedTable, "      %s," % (', '.join(['0x%02x' % (v) for v in bank[row : row + 16]]))
+            print >> generatedTable, "    },"
+        print >> generatedTable, "  },"
+    print >> generatedTable, "};"
     print >> generatedTable, "#endif  // PBL_BW\n"
 
     return resourceStr
@@ -812,37 +913,50 @@ def getMaskResourceCacheSize(hand, platform):
 
     return resourceCacheSize.get((hand, platform), [0, 0])[1]
 
-def makeBitmapHands(generatedTable, generatedDefs, useRle, hand, scaleFactors, sourceBasename, colorMode, asymmetric, pivot, scale):
+def getRotate(rotate, platform):
+    # Returns true if the hand should be rotated at runtime on the
+    # indicated platform, according to the rotate entry of its
+    # bitmapParams.
+    if isinstance(rotate, (list, tuple)):
+        return platform in rotate
+    return bool(rotate)
+
+def makeBitmapHands(generatedTable, generatedDefs, useRle, hand, scaleFactors, sourceBasename, colorMode, asymmetric, pivot, scale, rotate = False):
     resourceStr = ''
 
     for platform in targetPlatforms:
         shape = getPlatformShape(platform)
         color = getPlatformColor(platform)
         scaleFactor = scaleFactors.get(shape, 1.0)
+        rotatePlatform = getRotate(rotate, platform)
+        if rotatePlatform:
+            rotatedHands.add((hand, platform))
 
         print >> generatedTable, "#ifdef PBL_PLATFORM_%s" % (platform.upper())
 
         if color == 'bw':
-            resourceStr += makeBitmapHandsBW(generatedTable, useRle, hand, sourceBasename, colorMode, asymmetric, pivot, scale * scaleFactor, platform)
+            resourceStr += makeBitmapHandsBW(generatedTable, useRle, hand, sourceBasename, colorMode, asymmetric, pivot, scale * scaleFactor, rotatePlatform, platform)
         else:
-            resourceStr += makeBitmapHandsColor(generatedTable, useRle, hand, sourceBasename, colorMode, asymmetric, pivot, scale * scaleFactor, platform)
+            resourceStr += makeBitmapHandsColor(generatedTable, useRle, hand, sourceBasename, colorMode, asymmetric, pivot, scale * scaleFactor, rotatePlatform, platform)
 
         print >> generatedTable, "#endif  // PBL_PLATFORM_%s" % (platform.upper())
 
     return resourceStr
 
-def makeBitmapHandsBW(generatedTable, useRle, hand, sourceBasename, colorMode, asymmetric, pivot, scale, platform):
+def makeBitmapHandsBW(generatedTable, useRle, hand, sourceBasename, colorMode, asymmetric, pivot, scale, rotate, platform):
     resourceStr = ''
     maskResourceStr = ''
 
     compress = (hand not in ['second', 'chrono_second'])
 
-    handLookupEntry = """  { %(cx)s, %(cy)s },  // %(symbolName)s"""
+    handLookupEntry = """  { %(cx)s, %(cy)s, %(w)s, %(h)s },  // %(symbolName)s"""
     handTableEntry = """  { %(lookup_index)s, %(flip_x)s, %(flip_y)s },"""
 
     handLookupLines = {}
     maxLookupIndex = -1
+    maxSize = (0, 0)
     handTableLines = []
+    variants = set()
 
     paintChannel, useTransparency, dither = parseColorMode(colorMode)
 
@@ -887,7 +1001,14 @@ def makeBitmapHandsBW(generatedTable, useRle, hand, sourceBasename, colorMode, a
     large1Mask.paste(source1Mask, (center[0] - pivot[0], center[1] - pivot[1]))
 
     numStepsHand = getNumSteps(hand, platform)
-    for i in range(numStepsHand):
+
+    # A hand that is rotated at runtime needs only its first step, the
+    # hand pointing straight up.
+    numTableSteps = numStepsHand
+    if rotate:
+        numTableSteps = 1
+
+    for i in range(numTableSteps):
         flip_x = False
         flip_y = False
         angle = i * 360.0 / numStepsHand
@@ -975,6 +1096,11 @@ def makeBitmapHandsBW(generatedTable, useRle, hand, sourceBasename, colorMode, a
             # It's important to take the crop from the alpha mask, not
             # from the color.
             cropbox = pm1.getbbox()
+            if rotate:
+                # Leave a clear border of one pixel around a bitmap
+                # that is rotated at runtime; wright.c fills in the
+                # corners of the rotated bitmap from its pixel (0, 0).
+                cropbox = (cropbox[0] - 1, cropbox[1] - 1, cropbox[2] + 1, cropbox[3] + 1)
             p1 = p1.crop(cropbox)
             pm1 = pm1.crop(cropbox)
 
@@ -1020,9 +1146,13 @@ def makeBitmapHandsBW(generatedTable, useRle, hand, sourceBasename, colorMode, a
                 'symbolName' : symbolName,
                 'cx' : cx,
                 'cy' : cy,
+                'w' : p1.size[0],
+                'h' : p1.size[1],
                 }
             handLookupLines[i] = line
             maxLookupIndex = max(maxLookupIndex, i)
+            if p1.size[0] * p1.size[1] > maxSize[0] * maxSize[1]:
+                maxSize = p1.size
 
         line = handTableEntry % {
             'lookup_index' : i,
@@ -1030,13 +1160,19 @@ def makeBitmapHandsBW(generatedTable, useRle, hand, sourceBasename, colorMode, a
             'flip_y' : int(flip_y),
             }
         handTableLines.append(line)
+        variants.add((i, flip_x, flip_y))
 
     numBitmaps = maxLookupIndex + 1
+
+    # The resource cache keeps each bitmap already flipped, so it
+    # needs an entry for each combination of bitmap and flip we use.
+    numVariants = len(variants)
     if useTransparency:
-        numMaskBitmaps = numBitmaps
+        numMaskVariants = numVariants
     else:
-        numMaskBitmaps = 0
-    resourceCacheSize[hand, platform] = numBitmaps, numMaskBitmaps
+        numMaskVariants = 0
+    resourceCacheSize[hand, platform] = numVariants, numMaskVariants
+    handMaxSize[hand, platform] = maxSize
 
     print >> generatedTable, "struct BitmapHandCenterRow %s_hand_bitmap_lookup[] = {" % (hand)
     for i in range(numBitmaps):
@@ -1044,25 +1180,30 @@ def makeBitmapHandsBW(generatedTable, useRle, hand, sourceBasename, colorMode, a
         print >> generatedTable, line
     print >> generatedTable, "};\n"
 
-    print >> generatedTable, "struct BitmapHandTableRow %s_hand_bitmap_table[NUM_STEPS_%s] = {" % (hand, hand.upper())
+    tableSize = 'NUM_STEPS_%s' % (hand.upper())
+    if rotate:
+        tableSize = '1'
+    print >> generatedTable, "struct BitmapHandTableRow %s_hand_bitmap_table[%s] = {" % (hand, tableSize)
     for line in handTableLines:
         print >> generatedTable, line
     print >> generatedTable, "};\n"
 
     return resourceStr + maskResourceStr
 
-def makeBitmapHandsColor(generatedTable, useRle, hand, sourceBasename, colorMode, asymmetric, pivot, scale, platform):
+def makeBitmapHandsColor(generatedTable, useRle, hand, sourceBasename, colorMode, asymmetric, pivot, scale, rotate, platform):
     resourceStr = ''
     maskResourceStr = ''
 
     compress = (hand not in ['second', 'chrono_second'])
 
-    handLookupEntry = """  { %(cx)s, %(cy)s },  // %(symbolName)s"""
+    handLookupEntry = """  { %(cx)s, %(cy)s, %(w)s, %(h)s },  // %(symbolName)s"""
     handTableEntry = """  { %(lookup_index)s, %(flip_x)s, %(flip_y)s },"""
 
     handLookupLines = {}
     maxLookupIndex = -1
+    maxSize = (0, 0)
     handTableLines = []
+    variants = set()
 
     paintChannel, useTransparency, dither = parseColorMode(colorMode)
 
@@ -1105,7 +1246,14 @@ def makeBitmapHandsColor(generatedTable, useRle, hand, sourceBasename, colorMode
         largeMaskExplicit.paste(sourceMaskExplicit, (center[0] - pivot[0], center[1] - pivot[1]))
 
     numStepsHand = getNumSteps(hand, platform)
-    for i in range(numStepsHand):
+
+    # A hand that is rotated at runtime needs only its first step, the
+    # hand pointing straight up.
+    numTableSteps = numStepsHand
+    if rotate:
+        numTableSteps = 1
+
+    for i in range(numTableSteps):
         flip_x = False
         flip_y = False
         angle = i * 360.0 / numStepsHand
@@ -1190,6 +1338,11 @@ def makeBitmapHandsColor(generatedTable, useRle, hand, sourceBasename, colorMode
             # It's important to take the crop from the alpha mask, not
             # from the color.
             cropbox = pm2.getbbox()
+            if rotate:
+                # Leave a clear border of one pixel around a bitmap
+                # that is rotated at runtime; wright.c fills in the
+                # corners of the rotated bitmap from its pixel (0, 0).
+                cropbox = (cropbox[0] - 1, cropbox[1] - 1, cropbox[2] + 1, cropbox[3] + 1)
             p2 = p2.crop(cropbox)
             pm2 = pm2.crop(cropbox)
 
@@ -1269,9 +1422,13 @@ def makeBitmapHandsColor(generatedTable, useRle, hand, sourceBasename, colorMode
                 'symbolName' : symbolName,
                 'cx' : cx,
                 'cy' : cy,
+                'w' : p2.size[0],
+                'h' : p2.size[1],
                 }
             handLookupLines[i] = line
             maxLookupIndex = max(maxLookupIndex, i)
+            if p2.size[0] * p2.size[1] > maxSize[0] * maxSize[1]:
+                maxSize = p2.size
 
         line = handTableEntry % {
             'lookup_index' : i,
@@ -1279,13 +1436,19 @@ def makeBitmapHandsColor(generatedTable, useRle, hand, sourceBasename, colorMode
             'flip_y' : int(flip_y),
             }
         handTableLines.append(line)
+        variants.add((i, flip_x, flip_y))
 
     numBitmaps = maxLookupIndex + 1
+
+    # The resource cache keeps each bitmap already flipped, so it
+    # needs an entry for each combination of bitmap and flip we use.
+    numVariants = len(variants)
     if useTransparency:
-        numMaskBitmaps = numBitmaps
+        numMaskVariants = numVariants
     else:
-        numMaskBitmaps = 0
-    resourceCacheSize[hand, platform] = numBitmaps, numMaskBitmaps
+        numMaskVariants = 0
+    resourceCacheSize[hand, platform] = numVariants, numMaskVariants
+    handMaxSize[hand, platform] = maxSize
 
     print >> generatedTable, "struct BitmapHandCenterRow %s_hand_bitmap_lookup[] = {" % (hand)
     for i in range(numBitmaps):
@@ -1293,7 +1456,10 @@ def makeBitmapHandsColor(generatedTable, useRle, hand, sourceBasename, colorMode
         print >> generatedTable, line
     print >> generatedTable, "};\n"
 
-    print >> generatedTable, "struct BitmapHandTableRow %s_hand_bitmap_table[NUM_STEPS_%s] = {" % (hand, hand.upper())
+    tableSize = 'NUM_STEPS_%s' % (hand.upper())
+    if rotate:
+        tableSize = '1'
+    print >> generatedTable, "struct BitmapHandTableRow %s_hand_bitmap_table[%s] = {" % (hand, tableSize)
     for line in handTableLines:
         print >> generatedTable, line
     print >> generatedTable, "};\n"
@@ -1313,6 +1479,8 @@ struct HandDef %(hand)s_hand_def = {
     %(resourceId)s, %(resourceMaskId)s,
     %(placeX)s, %(placeY)s,
     %(useRle)s,
+    %(rotate)s,
+    %(maxW)s, %(maxH)s,
     %(bitmapCenters)s,
     %(bitmapTable)s,
     %(vectorTable)s,
@@ -1383,6 +1551,9 @@ struct HandDef %(hand)s_hand_def = {
                 'placeX' : placeX,
                 'placeY' : placeY,
                 'useRle' : int(bool(useRle)),
+                'rotate' : int((hand, platform) in rotatedHands),
+                'maxW' : handMaxSize.get((hand, platform), (0, 0))[0],
+                'maxH' : handMaxSize.get((hand, platform), (0, 0))[1],
                 'bitmapCenters' : bitmapCenters,
                 'bitmapTable' : bitmapTable,
                 'vectorTable' : vectorTable,
@@ -1706,11 +1877,14 @@ def configWatch():
             'dateWindowSizeY' : dateWindowSizes[platform][1],
             'pebbleLabelSizeX' : pebbleLabelSizes[platform][0],
             'pebbleLabelSizeY' : pebbleLabelSizes[platform][1],
+            'supportHandRotation' : int(platform in [p for h, p in rotatedHands]),
             'limitResourceCache' : int('limit_cache' in defaults or 'limit_cache_' + platform in defaults),
             'secondResourceCacheSize' : getResourceCacheSize('second', platform),
             'chronoSecondResourceCacheSize' : getResourceCacheSize('chrono_second', platform),
             'secondMaskResourceCacheSize' : getMaskResourceCacheSize('second', platform),
             'chronoSecondMaskResourceCacheSize' : getMaskResourceCacheSize('chrono_second', platform),
+            'resourceCacheBudget' : resourceCacheBudget.get(platform, 0),
+            'rleCacheBudget' : rleCacheBudget.get(platform, 0),
             }
 
     print >> config, configIn % {
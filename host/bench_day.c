@@ -0,0 +1,160 @@
+// bench_day: runs the watchface under the pebble.h stand-in for whole
+// simulated days, once for each combination of the settings that
+// decide how often it wakes up and how much it draws (the second
+// hand, sweep seconds, and the chronograph dial, as far as the
+// current configuration supports them), and reports a line of
+// energy proxies for each: wakeups, frames, resource reads, bytes
+// decoded, pixels drawn, allocations, and buzzes.
+//
+// bench_day [opts]
+//
+//   -d days       simulated days per combination (default 1)
+//   -t time       simulated start time, seconds since the epoch
+//   -H bytes      heap ceiling (default: the platform's app RAM)
+//   -r dir        resources directory (default ../resources)
+//   -k name=value hold a config setting fixed for every combination,
+//                 e.g. -k hour_buzzer=1 -k top_subdial=2.  May repeat.
+//   -T file       write a trace of every heap allocation and free,
+//                 from startup on, for heap_sim to replay
+//   -v            pass the app's log output through
+//
+// The simulated clock only goes forward, so each combination picks up
+// where the one before left off; the counters are reset after the
+// watch has settled into the new settings.
+
+#define PEBBLE_HOST_IMPLEMENTATION 1
+#include "pebble_host.h"
+#include "../src/bwd.h"
+#include "../src/config_options.h"
+#include <getopt.h>
+
+// Defined in src/, which is compiled with main renamed.
+extern void handle_init();
+extern void handle_deinit();
+
+// The -k settings, held fixed for every combination.
+static struct HostConfig host_config;
+
+// The time allowed for the watch to take up new settings before the
+// counters are reset.
+#define SETTLE_MS 2000
+
+// Delivers the -k settings along with the indicated combination,
+// lets the watch settle, then runs it for the indicated number of
+// days and prints a row of counters.
+static void run_combination(int days, int second_hand, int sweep_seconds, int chrono_dial) {
+  struct HostConfig config = host_config;
+  host_config_set(&config, CK_second_hand, second_hand);
+  host_config_set(&config, CK_sweep_seconds, sweep_seconds);
+  host_config_set(&config, CK_chrono_dial, chrono_dial);
+
+  host_queue_config(0, &config);
+  host_run_for(SETTLE_MS);
+
+  host_reset_stats();
+  memset(&bwd_stats, 0, sizeof(bwd_stats));
+  bwd_resource_reads = 0;
+  bwd_load_calls = 0;
+  bwd_load_bytes = 0;
+  bwd_load_bytes_reread = 0;
+
+  host_run_for((uint64_t)days * 86400 * 1000);
+
+  struct HostStats stats;
+  host_get_stats(&stats);
+  printf("%6d %6d %6d %10u %8u %8d %12llu %14llu %9u %6u\n",
+         second_hand, sweep_seconds, chrono_dial,
+         (stats.ticks + stats.timers) / days, stats.frames / days,
+         bwd_resource_reads / days,
+         (unsigned long long)(bwd_stats.decoded_bytes / days),
+         (unsigned long long)((stats.pixels_blitted + bwd_stats.drawn_pixels) / days),
+         stats.heap_allocs / days, stats.vibes / days);
+}
+
+static void usage(const char *progname) {
+  fprintf(stderr, "usage: %s [-d days] [-t start_time] [-H heap_bytes] [-r resource_dir] [-k name=value ...] [-T trace_file] [-v]\n", progname);
+  exit(1);
+}
+
+int main(int argc, char *argv[]) {
+  int days = 1;
+  const char *trace_filename = NULL;
+  host_set_resource_dir("../resources");
+
+  int opt;
+  while ((opt = getopt(argc, argv, "d:t:H:r:k:T:vh")) != -1) {
+    switch (opt) {
+    case 'd':
+      days = atoi(optarg);
+      break;
+    case 't':
+      host_set_start_time((time_t)atol(optarg));
+      break;
+    case 'H':
+      host_set_heap_limit((size_t)atol(optarg));
+      break;
+    case 'r':
+      host_set_resource_dir(optarg);
+      break;
+    case 'k':
+      host_config_add(&host_config, optarg);
+      break;
+    case 'T':
+      trace_filename = optarg;
+      break;
+    case 'v':
+      host_set_verbose(true);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if (days < 1) {
+    usage(argv[0]);
+  }
+
+  FILE *trace = NULL;
+  if (trace_filename != NULL) {
+    trace = fopen(trace_filename, "w");
+    if (trace == NULL) {
+      perror(trace_filename);
+      exit(1);
+    }
+    host_set_heap_trace(trace);
+  }
+
+  handle_init();
+
+  printf("platform: %s, per simulated day\n", host_platform_name());
+  printf("second  sweep chrono    wakeups   frames   reads  bytes decoded  pixels drawn    allocs  buzzes\n");
+
+  int num_sweep = 1;
+#if ENABLE_SWEEP_SECONDS
+  num_sweep = 2;
+#endif  // ENABLE_SWEEP_SECONDS
+
+  int num_chrono = 1;
+#ifdef ENABLE_CHRONO_DIAL
+  num_chrono = CDM_dual + 1;
+#endif  // ENABLE_CHRONO_DIAL
+
+  for (int second_hand = 0; second_hand <= 1; ++second_hand) {
+    for (int sweep_seconds = 0; sweep_seconds < num_sweep; ++sweep_seconds) {
+      if (sweep_seconds && !second_hand) {
+        // Sweep seconds means nothing without the second hand.
+        continue;
+      }
+      for (int chrono_dial = 0; chrono_dial < num_chrono; ++chrono_dial) {
+        run_combination(days, second_hand, sweep_seconds, chrono_dial);
+      }
+    }
+  }
+
+  handle_deinit();
+
+  if (trace != NULL) {
+    host_set_heap_trace(NULL);
+    fclose(trace);
+  }
+  return 0;
+}
@@ -0,0 +1,258 @@
+// bench_frame: runs the watchface under the pebble.h stand-in for a
+// span of simulated time, and reports the wall time spent drawing
+// each frame (in clock_face_layer_update_callback() and, for frames
+// that only redraw the second hand, second_hand_layer_update_callback()),
+// along with the heap and resource traffic the run generated.
+//
+// bench_frame [opts]
+//
+//   -s seconds    simulated seconds to run (default 60)
+//   -t time       simulated start time, seconds since the epoch
+//   -H bytes      heap ceiling (default: the platform's app RAM)
+//   -r dir        resources directory (default ../resources)
+//   -k name=value deliver a config setting one second into the run;
+//                 name is one of the messageKeys in package.json.in,
+//                 e.g. -k second_hand=1 -k face_index=2.  May repeat.
+//   -o file.ppm   write the final frame to the indicated file
+//   -v            pass the app's log output through
+//
+// The checksum printed at the end covers the final frame, so that a
+// change meant to be invisible can be checked against a baseline.
+//
+// The launch line measures what a user switching to the watchface
+// waits for: the wall time from the start of handle_init() to the end
+// of the first frame, and the heap and resource traffic up to then.
+
+#define PEBBLE_HOST_IMPLEMENTATION 1
+#include "pebble_host.h"
+#include "../src/bwd.h"
+#include <getopt.h>
+
+// Defined in src/, which is compiled with main renamed.
+extern void handle_init();
+extern void handle_deinit();
+extern void clock_face_layer_update_callback(Layer *me, GContext *ctx);
+extern void second_hand_layer_update_callback(Layer *me, GContext *ctx);
+extern bool partial_redraw_now;
+extern bool drew_from_hands_face;
+
+// The -k settings, delivered a second after launch.
+static struct HostConfig host_config;
+
+static uint64_t *frame_ns = NULL;
+static int num_frames = 0;
+static int max_frames = 0;
+
+// The frames that redrew only the part of the face the second hand
+// swept, and the total pixels they redrew.
+static int num_partial_frames = 0;
+static uint64_t partial_pixels = 0;
+static bool frame_is_partial = false;
+
+// The frames that restored the face from hands_face, with the hour
+// and minute hands already drawn.
+static int num_hands_face_frames = 0;
+
+// The time handle_init() was called, and the time from then to the end
+// of the first frame, with the stats as they stood at that point.
+static uint64_t launch_ns = 0;
+static uint64_t first_pixel_ns = 0;
+static struct HostStats first_pixel_stats;
+static int first_pixel_bwd_reads = 0;
+
+static void layer_timing(Layer *layer, LayerUpdateProc update_proc, uint64_t elapsed_ns) {
+  if (update_proc == clock_face_layer_update_callback) {
+    if (num_frames == 0) {
+      first_pixel_ns = host_clock_ns() - launch_ns;
+      host_get_stats(&first_pixel_stats);
+      first_pixel_bwd_reads = bwd_resource_reads;
+    }
+    if (num_frames >= max_frames) {
+      max_frames = max_frames ? max_frames * 2 : 1024;
+      frame_ns = (uint64_t *)realloc(frame_ns, max_frames * sizeof(uint64_t));
+    }
+    frame_ns[num_frames++] = elapsed_ns;
+
+    // clock_face_layer_update_callback() leaves this set when it
+    // leaves the frame to second_hand_layer.
+    frame_is_partial = partial_redraw_now;
+    if (!frame_is_partial) {
+      num_hands_face_frames += drew_from_hands_face;
+    }
+
+  } else if (update_proc == second_hand_layer_update_callback && num_frames != 0) {
+    // This is part of the same frame.
+    frame_ns[num_frames - 1] += elapsed_ns;
+    if (frame_is_partial) {
+      GRect frame = layer_get_frame(layer);
+      ++num_partial_frames;
+      partial_pixels += frame.size.w * frame.size.h;
+      num_hands_face_frames += drew_from_hands_face;
+      frame_is_partial = false;
+    }
+  }
+}
+
+static int compare_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+// Returns the color of pixel (x, y) of the framebuffer as 8-bit ARGB.
+static uint8_t get_fb_pixel(GBitmap *fb, int x, int y) {
+  uint8_t *row = gbitmap_get_data(fb) + y * gbitmap_get_bytes_per_row(fb);
+  if (gbitmap_get_format(fb) == GBitmapFormat1Bit) {
+    return ((row[x >> 3] >> (x & 7)) & 1) ? GColorWhiteARGB8 : GColorBlackARGB8;
+  }
+  return row[x];
+}
+
+static uint32_t frame_checksum(GBitmap *fb) {
+  // FNV-1a over the visible pixels.
+  GRect bounds = gbitmap_get_bounds(fb);
+  uint32_t hash = 2166136261u;
+  for (int y = 0; y < bounds.size.h; ++y) {
+    GBitmapDataRowInfo info = gbitmap_get_data_row_info(fb, y);
+    for (int x = info.min_x; x <= info.max_x; ++x) {
+      hash = (hash ^ get_fb_pixel(fb, x, y)) * 16777619u;
+    }
+  }
+  return hash;
+}
+
+static void write_ppm(GBitmap *fb, const char *filename) {
+  FILE *file = fopen(filename, "wb");
+  if (file == NULL) {
+    perror(filename);
+    exit(1);
+  }
+  GRect bounds = gbitmap_get_bounds(fb);
+  fprintf(file, "P6\n%d %d\n255\n", bounds.size.w, bounds.size.h);
+  for (int y = 0; y < bounds.size.h; ++y) {
+    for (int x = 0; x < bounds.size.w; ++x) {
+      GColor color;
+      color.argb = get_fb_pixel(fb, x, y);
+      fputc(color.r * 85, file);
+      fputc(color.g * 85, file);
+      fputc(color.b * 85, file);
+    }
+  }
+  fclose(file);
+}
+
+static void usage(const char *progname) {
+  fprintf(stderr, "usage: %s [-s seconds] [-t start_time] [-H heap_bytes] [-r resource_dir] [-k name=value ...] [-p rows] [-o file.ppm] [-v]\n", progname);
+  exit(1);
+}
+
+int main(int argc, char *argv[]) {
+  int seconds = 60;
+  int obstructed_rows = 0;
+  const char *ppm_filename = NULL;
+  host_set_resource_dir("../resources");
+
+  int opt;
+  while ((opt = getopt(argc, argv, "s:t:H:r:k:p:o:vh")) != -1) {
+    switch (opt) {
+    case 's':
+      seconds = atoi(optarg);
+      break;
+    case 't':
+      host_set_start_time((time_t)atol(optarg));
+      break;
+    case 'H':
+      host_set_heap_limit((size_t)atol(optarg));
+      break;
+    case 'r':
+      host_set_resource_dir(optarg);
+      break;
+    case 'k':
+      host_config_add(&host_config, optarg);
+      break;
+    case 'p':
+      obstructed_rows = atoi(optarg);
+      break;
+    case 'o':
+      ppm_filename = optarg;
+      break;
+    case 'v':
+      host_set_verbose(true);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  host_set_layer_timing_callback(layer_timing);
+
+  launch_ns = host_clock_ns();
+  handle_init();
+  uint64_t init_ns = host_clock_ns() - launch_ns;
+
+  if (obstructed_rows != 0) {
+    // A timeline peek arrives just after launch.
+    host_set_obstructed_rows(obstructed_rows);
+  }
+
+  host_queue_config(1000, &host_config);
+  host_run_for((uint64_t)seconds * 1000);
+
+  struct HostStats stats;
+  host_get_stats(&stats);
+  GBitmap *fb = host_get_frame_buffer();
+  uint32_t checksum = frame_checksum(fb);
+  if (ppm_filename != NULL) {
+    write_ppm(fb, ppm_filename);
+  }
+  handle_deinit();
+
+  printf("platform:          %s\n", host_platform_name());
+  printf("simulated seconds: %d\n", seconds);
+  printf("handle_init:       %.1f us\n", init_ns / 1000.0);
+  printf("frames:            %d (%d redraws, %u ticks, %u timers, %u health events)\n",
+         num_frames, stats.frames, stats.ticks, stats.timers, stats.health_events);
+  if (num_frames != 0) {
+    uint64_t first = frame_ns[0];
+    uint64_t total = 0;
+    for (int i = 0; i < num_frames; ++i) {
+      total += frame_ns[i];
+    }
+    qsort(frame_ns, num_frames, sizeof(uint64_t), compare_u64);
+    printf("first frame:       %.1f us\n", first / 1000.0);
+    printf("launch:            %.1f us to the first pixel, %u allocs, %u resource loads, %d bwd reads\n",
+           first_pixel_ns / 1000.0, first_pixel_stats.heap_allocs, first_pixel_stats.resource_loads, first_pixel_bwd_reads);
+    printf("min/median/p95/max: %.1f / %.1f / %.1f / %.1f us\n",
+           frame_ns[0] / 1000.0, frame_ns[num_frames / 2] / 1000.0,
+           frame_ns[(num_frames * 95) / 100] / 1000.0, frame_ns[num_frames - 1] / 1000.0);
+    printf("total:             %.1f ms (%.1f us per simulated second)\n",
+           total / 1000000.0, seconds ? total / 1000.0 / seconds : 0.0);
+  }
+  if (num_partial_frames != 0) {
+    GSize size = gbitmap_get_bounds(fb).size;
+    printf("partial frames:    %d, %.0f pixels each (%.1f%% of the screen)\n",
+           num_partial_frames, (double)partial_pixels / num_partial_frames,
+           100.0 * partial_pixels / num_partial_frames / (size.w * size.h));
+  }
+  if (num_frames != 0) {
+    printf("hands_face frames: %d of %d\n", num_hands_face_frames, num_frames);
+  }
+  printf("text draws:        %u\n", stats.texts_drawn);
+  printf("heap:              %zu peak of %zu, %u allocs, %u frees, %u failures\n",
+         stats.heap_peak, stats.heap_limit, stats.heap_allocs, stats.heap_frees, stats.heap_failures);
+  printf("resources:         %u handles, %u loads, %zu bytes, %d bwd reads\n",
+         stats.resource_handles, stats.resource_loads, stats.resource_bytes, bwd_resource_reads);
+  printf("rle loads:         %d calls, %d bytes, %d bytes reread\n",
+         bwd_load_calls, bwd_load_bytes, bwd_load_bytes_reread);
+#ifdef SUPPORT_RLE_CACHE
+  printf("rle cache:         %d hits, %d misses, %zu bytes held of %d\n",
+         rle_cache_hits, rle_cache_misses, rle_cache_bytes, RLE_CACHE_BUDGET);
+#endif  // SUPPORT_RLE_CACHE
+#ifdef SUPPORT_RESOURCE_CACHE
+  printf("resource cache:    %d hits, %d misses, %d evictions, %zu bytes held of %d\n",
+         resource_cache_hits, resource_cache_misses, resource_cache_evictions, resource_cache_bytes, RESOURCE_CACHE_BUDGET);
+#endif  // SUPPORT_RESOURCE_CACHE
+  printf("final frame:       %08x\n", (unsigned int)checksum);
+
+  return 0;
+}
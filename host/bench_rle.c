@@ -0,0 +1,334 @@
+// bench_rle: decodes .rle resources repeatedly through bwd.c's
+// rle_bwd_create(), and reports the cost of each, grouped by bitmap
+// format, chunk size n, and codec.
+//
+// bench_rle [opts] [file.rle ...]
+//
+//   -n count      decodes per resource (default 200)
+//   -r dir        resources directory (default ../resources)
+//   -t count      list the count most expensive resources (default 10)
+//   -v            list every resource
+//   -f x|y|xy     decode each resource flipped in x and/or y, through
+//                 rle_bwd_create_transformed()
+//
+// With no files named, every .rle resource of the current
+// configuration (that is, every raw resource in package.json for this
+// platform) is decoded.  config_watch.py must have been run with -x,
+// or there won't be any.
+//
+// The checksum printed at the end covers the decoded pixels and
+// palettes of all of the resources, so that a change to the decoder
+// can be checked against a baseline.
+
+#define PEBBLE_HOST_IMPLEMENTATION 1
+#include "pebble_host.h"
+#include "../src/bwd.h"
+#include <getopt.h>
+
+static const char *format_names[] = {
+  "1Bit", "8Bit", "1BitPalette", "2BitPalette", "4BitPalette", "8BitCircular",
+};
+
+struct RleResult {
+  const char *name;
+  int width, height;
+  int n;
+  bool unscreen;
+  int format;
+  int codec;
+  size_t file_size;
+
+  // Per decode.
+  double ns;
+  double bytes;
+  double loads;
+  double rl2_calls;
+  double allocs;
+};
+
+struct RleGroup {
+  int format;
+  int n;
+  bool unscreen;
+  int codec;
+  int num_files;
+  double pixels;
+  double ns;
+  double bytes;
+  double loads;
+  double rl2_calls;
+  double allocs;
+};
+
+#define MAX_RESULTS 4096
+static struct RleResult results[MAX_RESULTS];
+static int num_results = 0;
+
+#define MAX_GROUPS 64
+static struct RleGroup groups[MAX_GROUPS];
+static int num_groups = 0;
+
+static uint32_t checksum = 2166136261u;
+
+static bool flip_x = false;
+static bool flip_y = false;
+
+static void checksum_bytes(const uint8_t *data, size_t size) {
+  // FNV-1a.
+  for (size_t i = 0; i < size; ++i) {
+    checksum = (checksum ^ data[i]) * 16777619u;
+  }
+}
+
+static void checksum_bitmap(GBitmap *bitmap) {
+  GRect bounds = gbitmap_get_bounds(bitmap);
+  size_t stride = gbitmap_get_bytes_per_row(bitmap);
+  checksum_bytes(gbitmap_get_data(bitmap), stride * bounds.size.h);
+
+  int palette_count = 0;
+  switch (gbitmap_get_format(bitmap)) {
+  case GBitmapFormat1BitPalette: palette_count = 2; break;
+  case GBitmapFormat2BitPalette: palette_count = 4; break;
+  case GBitmapFormat4BitPalette: palette_count = 16; break;
+  default: break;
+  }
+  if (palette_count != 0) {
+    checksum_bytes((const uint8_t *)gbitmap_get_palette(bitmap), palette_count);
+  }
+}
+
+// Decodes the resource num_decodes times, and records the average
+// cost of each decode.
+static void bench_resource(uint32_t resource_id, int num_decodes) {
+  const struct HostResource *resource = host_get_resource(resource_id);
+  ResHandle h = resource_get_handle(resource_id);
+  // Enough for either version of the header; see make_rle.py.
+  uint8_t header[18];
+  size_t header_size = (resource_size(h) > 0 && resource_load_byte_range(h, 0, header, 1) == 1 && header[0] == 0) ? 18 : 8;
+  if (resource_size(h) < header_size ||
+      resource_load_byte_range(h, 0, header, header_size) != header_size) {
+    fprintf(stderr, "%s is too short\n", resource->name);
+    return;
+  }
+  if (num_results >= MAX_RESULTS) {
+    fprintf(stderr, "too many resources\n");
+    exit(1);
+  }
+
+  struct RleResult *r = &results[num_results++];
+  r->name = resource->name;
+  if (header_size == 8) {
+    r->width = header[0];
+    r->height = header[1];
+    r->n = header[2] & 0x7f;
+    r->unscreen = (header[2] & 0x80) != 0;
+    r->format = header[3] & 0x7f;  // without the row index flag
+    r->codec = 0;
+  } else {
+    r->codec = header[2];
+    r->n = header[3] & 0x7f;
+    r->unscreen = (header[3] & 0x80) != 0;
+    r->format = header[4] & 0x7f;
+    r->width = header[6] | (header[7] << 8);
+    r->height = header[8] | (header[9] << 8);
+  }
+  r->file_size = resource_size(h);
+
+  // Decode once to warm up (and to verify the result), then time the
+  // rest.
+  BitmapWithData bwd = rle_bwd_create_transformed(resource_id, flip_x, flip_y, NULL);
+  if (bwd.bitmap == NULL) {
+    fprintf(stderr, "%s failed to decode\n", resource->name);
+    exit(1);
+  }
+  checksum_bitmap(bwd.bitmap);
+  bwd_destroy(&bwd);
+
+  host_reset_stats();
+  memset(&bwd_stats, 0, sizeof(bwd_stats));
+  uint64_t start = host_clock_ns();
+  for (int i = 0; i < num_decodes; ++i) {
+    bwd = rle_bwd_create_transformed(resource_id, flip_x, flip_y, NULL);
+    bwd_destroy(&bwd);
+  }
+  uint64_t elapsed = host_clock_ns() - start;
+
+  struct HostStats stats;
+  host_get_stats(&stats);
+  r->ns = (double)elapsed / num_decodes;
+  r->bytes = (double)stats.resource_bytes / num_decodes;
+  r->loads = (double)stats.resource_loads / num_decodes;
+  r->rl2_calls = (double)bwd_stats.rl2_getc_calls / num_decodes;
+  r->allocs = (double)stats.heap_allocs / num_decodes;
+
+  struct RleGroup *g = NULL;
+  for (int i = 0; i < num_groups; ++i) {
+    if (groups[i].format == r->format && groups[i].n == r->n && groups[i].unscreen == r->unscreen && groups[i].codec == r->codec) {
+      g = &groups[i];
+      break;
+    }
+  }
+  if (g == NULL) {
+    if (num_groups >= MAX_GROUPS) {
+      fprintf(stderr, "too many formats\n");
+      exit(1);
+    }
+    g = &groups[num_groups++];
+    memset(g, 0, sizeof(*g));
+    g->format = r->format;
+    g->n = r->n;
+    g->unscreen = r->unscreen;
+    g->codec = r->codec;
+  }
+  ++g->num_files;
+  g->pixels += r->width * r->height;
+  g->ns += r->ns;
+  g->bytes += r->bytes;
+  g->loads += r->loads;
+  g->rl2_calls += r->rl2_calls;
+  g->allocs += r->allocs;
+}
+
+static const char *format_name(int format) {
+  if (format >= 0 && format < (int)ARRAY_LENGTH(format_names)) {
+    return format_names[format];
+  }
+  return "?";
+}
+
+static void print_result(struct RleResult *r) {
+  printf("  %-32s %3dx%-3d %-11s n=%d%s c=%d %8.0f ns %6.2f ns/px %6.0f bytes %4.0f loads %6.0f rl2 %3.0f allocs\n",
+         r->name, r->width, r->height, format_name(r->format), r->n, r->unscreen ? "u" : " ", r->codec,
+         r->ns, r->ns / (r->width * r->height), r->bytes, r->loads, r->rl2_calls, r->allocs);
+}
+
+static int compare_groups(const void *a, const void *b) {
+  const struct RleGroup *x = (const struct RleGroup *)a;
+  const struct RleGroup *y = (const struct RleGroup *)b;
+  if (x->format != y->format) {
+    return x->format - y->format;
+  }
+  if (x->n != y->n) {
+    return x->n - y->n;
+  }
+  if (x->unscreen != y->unscreen) {
+    return x->unscreen - y->unscreen;
+  }
+  return x->codec - y->codec;
+}
+
+static int compare_cost(const void *a, const void *b) {
+  const struct RleResult *x = (const struct RleResult *)a;
+  const struct RleResult *y = (const struct RleResult *)b;
+  return (x->ns < y->ns) - (x->ns > y->ns);
+}
+
+static bool ends_with(const char *str, const char *suffix) {
+  size_t len = strlen(str);
+  size_t suffix_len = strlen(suffix);
+  return len >= suffix_len && strcmp(str + len - suffix_len, suffix) == 0;
+}
+
+static void usage(const char *progname) {
+  fprintf(stderr, "usage: %s [-n decodes] [-r resource_dir] [-t count] [-v] [-f x|y|xy] [file.rle ...]\n", progname);
+  exit(1);
+}
+
+int main(int argc, char *argv[]) {
+  int num_decodes = 200;
+  int top_count = 10;
+  bool verbose = false;
+  host_set_resource_dir("../resources");
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:r:t:vf:h")) != -1) {
+    switch (opt) {
+    case 'n':
+      num_decodes = atoi(optarg);
+      break;
+    case 'r':
+      host_set_resource_dir(optarg);
+      break;
+    case 't':
+      top_count = atoi(optarg);
+      break;
+    case 'v':
+      verbose = true;
+      break;
+    case 'f':
+      flip_x = (strchr(optarg, 'x') != NULL);
+      flip_y = (strchr(optarg, 'y') != NULL);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if (num_decodes < 1) {
+    usage(argv[0]);
+  }
+
+#ifndef SUPPORT_RLE
+  fprintf(stderr, "SUPPORT_RLE is not defined; run config_watch.py with -x.\n");
+  return 1;
+#endif  // SUPPORT_RLE
+
+  // The whole heap is available to the decoder.
+  host_set_heap_limit((size_t)1 << 30);
+
+  if (optind < argc) {
+    for (int i = optind; i < argc; ++i) {
+      char *path = realpath(argv[i], NULL);
+      if (path == NULL) {
+        perror(argv[i]);
+        return 1;
+      }
+      const char *name = strrchr(argv[i], '/') ? strrchr(argv[i], '/') + 1 : argv[i];
+      bench_resource(host_add_resource_file(name, path, "raw"), num_decodes);
+      free(path);
+    }
+  } else {
+    uint32_t num_resources = host_get_num_resources();
+    for (uint32_t resource_id = 1; resource_id <= num_resources; ++resource_id) {
+      if (ends_with(host_get_resource(resource_id)->file, ".rle")) {
+        bench_resource(resource_id, num_decodes);
+      }
+    }
+  }
+
+  printf("platform %s: %d resources, %d decodes each\n", host_platform_name(), num_results, num_decodes);
+  if (num_results == 0) {
+    return 0;
+  }
+
+  printf("%-12s %2s %2s %2s %5s %8s %8s %8s %8s %8s %8s\n",
+         "format", "n", "u", "c", "files", "px", "ns/px", "bytes", "loads", "rl2", "allocs");
+  qsort(groups, num_groups, sizeof(groups[0]), compare_groups);
+  double total_ns = 0.0, total_pixels = 0.0;
+  for (int i = 0; i < num_groups; ++i) {
+    struct RleGroup *g = &groups[i];
+    printf("%-12s %2d %2s %2d %5d %8.0f %8.2f %8.0f %8.1f %8.0f %8.1f\n",
+           format_name(g->format), g->n, g->unscreen ? "u" : "", g->codec,
+           g->num_files, g->pixels / g->num_files, g->ns / g->pixels,
+           g->bytes / g->num_files, g->loads / g->num_files,
+           g->rl2_calls / g->num_files, g->allocs / g->num_files);
+    total_ns += g->ns;
+    total_pixels += g->pixels;
+  }
+  printf("%-12s %2s %2s %2s %5d %8.0f %8.2f\n", "all", "", "", "", num_results,
+         total_pixels / num_results, total_ns / total_pixels);
+  printf("(px, bytes, loads, rl2 calls, and allocs are per decode of one file)\n");
+
+  qsort(results, num_results, sizeof(results[0]), compare_cost);
+  if (verbose) {
+    printf("all resources, most expensive first:\n");
+    top_count = num_results;
+  } else if (top_count > 0) {
+    printf("most expensive resources:\n");
+  }
+  for (int i = 0; i < top_count && i < num_results; ++i) {
+    print_result(&results[i]);
+  }
+
+  printf("decode checksum: %08x\n", (unsigned int)checksum);
+  return 0;
+}
@@ -0,0 +1,26 @@
+#! /bin/sh
+#
+# Runs bench_rle over the .rle resources of every style and platform.
+# This reconfigures the watch (with config_watch.py -x) for each style
+# in turn, so re-run config_watch.py afterwards to restore the
+# configuration you want.
+#
+# Run from the host directory:
+#
+#   ./bench_rle.sh [bench_rle options]
+#
+# STYLES and PLATFORMS may be set in the environment to narrow the run.
+
+STYLES=${STYLES:-"a b c c2 d e"}
+PLATFORMS=${PLATFORMS:-"aplite basalt chalk diorite emery"}
+PYTHON=${PYTHON:-python}
+
+for style in $STYLES; do
+  (cd .. && $PYTHON config_watch.py -s$style -x > /dev/null) || exit
+  for platform in $PLATFORMS; do
+    make -s PLATFORM=$platform PYTHON="$PYTHON" build/$platform/bench_rle || exit
+    echo "style $style"
+    ./build/$platform/bench_rle "$@" || exit
+    echo
+  done
+done
@@ -0,0 +1,383 @@
+// heap_sim: replays a heap trace written by bench_day -T through a
+// model of the watch's first-fit heap, and reports how close the
+// watchface came to running out: the peak use, the largest free block
+// at the peak and at the tightest moment, the fragmentation left at
+// the end, and the allocations that would not have found a large
+// enough free block, with the memory panic level (see
+// reset_memory_panic() in wright.c) they would have escalated to.
+// The simulated heap in pebble_host.c only counts bytes, so it can't
+// see fragmentation; this can.
+//
+// heap_sim [opts] trace_file
+//
+//   -H bytes      heap size (default: the heap recorded in the trace)
+//   -n count      list only the count busiest sites (default all)
+//
+// The trace is a line per event, after a header line that begins
+// with "#":
+//
+//   a ms id size site   allocation number id of size bytes
+//   x ms size site      allocation the trace's own heap refused
+//   f ms id             free of allocation id
+//
+// where ms is the simulated time, and site is the innermost
+// HEAP_TRACE_BEGIN() site (see bwd.h), or "-".
+//
+// The replay is open-loop: the trace records what the watchface did
+// on the heap it had, so after the first failure here, the watchface
+// on the watch would have shed load and gone on differently.  Levels
+// beyond the first are an upper bound.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+
+// The level past which reset_memory_panic() has nothing more to give
+// up.
+#define MAX_PANIC_LEVEL 10
+
+// What each level of reset_memory_panic() gives up, beyond halving
+// the rle and resource cache budgets again.
+static const char *panic_level_names[MAX_PANIC_LEVEL + 1] = {
+  "none",
+  "face asset and hands_face no longer kept",
+  "assets no longer kept",
+  "caches only",
+  "second hand off",
+  "framebuffer no longer saved",
+  "battery gauge and bluetooth indicator off",
+  "top subdial off",
+  "date windows hidden",
+  "chrono dial off",
+  "clock face hidden",
+};
+
+#define MAX_SITE_NAME 64
+#define MAX_SITES 64
+
+struct SimSite {
+  char name[MAX_SITE_NAME];
+  unsigned int allocs;
+  unsigned int failures;
+  size_t live_bytes;
+  size_t peak_bytes;
+  unsigned int frees;
+  uint64_t lifetime_ms;  // summed over the frees
+};
+
+// An allocation of the trace, by id.  size is 0 once it is freed, or
+// if it was never placed.
+struct SimBlock {
+  uint32_t offset;
+  uint32_t size;
+  uint16_t site;
+  uint64_t alloc_ms;
+};
+
+// A run of free bytes in the modeled heap.
+struct SimExtent {
+  uint32_t offset;
+  uint32_t size;
+};
+
+static struct SimSite sites[MAX_SITES];
+static int num_sites = 0;
+
+static struct SimBlock *blocks = NULL;
+static size_t num_blocks = 0;
+
+// Kept in order by offset, and coalesced.
+static struct SimExtent *extents = NULL;
+static int num_extents = 0;
+static int max_extents = 0;
+
+static int find_site(const char *name) {
+  for (int i = 0; i < num_sites; ++i) {
+    if (strcmp(sites[i].name, name) == 0) {
+      return i;
+    }
+  }
+  if (num_sites >= MAX_SITES) {
+    fprintf(stderr, "too many sites in trace\n");
+    exit(1);
+  }
+  struct SimSite *site = &sites[num_sites];
+  memset(site, 0, sizeof(*site));
+  snprintf(site->name, MAX_SITE_NAME, "%s", name);
+  return num_sites++;
+}
+
+static struct SimBlock *get_block(size_t id) {
+  if (id >= num_blocks) {
+    size_t new_num_blocks = num_blocks ? num_blocks : 4096;
+    while (new_num_blocks <= id) {
+      new_num_blocks *= 2;
+    }
+    blocks = (struct SimBlock *)realloc(blocks, new_num_blocks * sizeof(struct SimBlock));
+    if (blocks == NULL) {
+      fprintf(stderr, "out of memory\n");
+      exit(1);
+    }
+    memset(blocks + num_blocks, 0, (new_num_blocks - num_blocks) * sizeof(struct SimBlock));
+    num_blocks = new_num_blocks;
+  }
+  return &blocks[id];
+}
+
+static void insert_extent(int index, uint32_t offset, uint32_t size) {
+  if (num_extents >= max_extents) {
+    max_extents = max_extents ? max_extents * 2 : 64;
+    extents = (struct SimExtent *)realloc(extents, max_extents * sizeof(struct SimExtent));
+    if (extents == NULL) {
+      fprintf(stderr, "out of memory\n");
+      exit(1);
+    }
+  }
+  memmove(&extents[index + 1], &extents[index], (num_extents - index) * sizeof(struct SimExtent));
+  extents[index].offset = offset;
+  extents[index].size = size;
+  ++num_extents;
+}
+
+static void remove_extent(int index) {
+  --num_extents;
+  memmove(&extents[index], &extents[index + 1], (num_extents - index) * sizeof(struct SimExtent));
+}
+
+// Places size bytes at the lowest offset that has room, as the
+// watch's allocator does, and returns true, or returns false if no
+// free extent is large enough.
+static bool sim_alloc(uint32_t size, uint32_t *offset) {
+  for (int i = 0; i < num_extents; ++i) {
+    if (extents[i].size >= size) {
+      *offset = extents[i].offset;
+      extents[i].offset += size;
+      extents[i].size -= size;
+      if (extents[i].size == 0) {
+        remove_extent(i);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns size bytes at offset to the free extents, merging them with
+// their neighbors.
+static void sim_free(uint32_t offset, uint32_t size) {
+  int i = 0;
+  while (i < num_extents && extents[i].offset < offset) {
+    ++i;
+  }
+  if (i > 0 && extents[i - 1].offset + extents[i - 1].size == offset) {
+    extents[i - 1].size += size;
+    if (i < num_extents && offset + size == extents[i].offset) {
+      extents[i - 1].size += extents[i].size;
+      remove_extent(i);
+    }
+  } else if (i < num_extents && offset + size == extents[i].offset) {
+    extents[i].offset = offset;
+    extents[i].size += size;
+  } else {
+    insert_extent(i, offset, size);
+  }
+}
+
+static uint32_t largest_free(void) {
+  uint32_t largest = 0;
+  for (int i = 0; i < num_extents; ++i) {
+    if (extents[i].size > largest) {
+      largest = extents[i].size;
+    }
+  }
+  return largest;
+}
+
+static int compare_sites(const void *a, const void *b) {
+  const struct SimSite *sa = (const struct SimSite *)a;
+  const struct SimSite *sb = (const struct SimSite *)b;
+  if (sa->peak_bytes != sb->peak_bytes) {
+    return (sa->peak_bytes < sb->peak_bytes) ? 1 : -1;
+  }
+  return strcmp(sa->name, sb->name);
+}
+
+static void usage(const char *progname) {
+  fprintf(stderr, "usage: %s [-H heap_bytes] [-n count] trace_file\n", progname);
+  exit(1);
+}
+
+int main(int argc, char *argv[]) {
+  size_t heap_size = 0;
+  int max_sites_listed = MAX_SITES;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "H:n:h")) != -1) {
+    switch (opt) {
+    case 'H':
+      heap_size = (size_t)atol(optarg);
+      break;
+    case 'n':
+      max_sites_listed = atoi(optarg);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if (optind + 1 != argc) {
+    usage(argv[0]);
+  }
+
+  const char *trace_filename = argv[optind];
+  FILE *trace = fopen(trace_filename, "r");
+  if (trace == NULL) {
+    perror(trace_filename);
+    exit(1);
+  }
+
+  char platform[32] = "unknown";
+  size_t trace_heap_size = 0;
+  int overhead = 0;
+  char line[256];
+  if (fgets(line, sizeof(line), trace) == NULL ||
+      sscanf(line, "# heap trace: platform %31[^,], heap %zu, overhead %d", platform, &trace_heap_size, &overhead) != 3) {
+    fprintf(stderr, "%s is not a heap trace\n", trace_filename);
+    exit(1);
+  }
+  if (heap_size == 0) {
+    heap_size = trace_heap_size;
+  }
+  insert_extent(0, 0, (uint32_t)heap_size);
+
+  unsigned int allocs = 0, frees = 0, trace_failures = 0, failures = 0, panics = 0;
+  uint64_t first_ms = 0, last_panic_ms = 0;
+  bool any_event = false;
+  size_t used = 0, peak_used = 0;
+  uint64_t peak_ms = 0, tightest_ms = 0;
+  uint32_t peak_largest = (uint32_t)heap_size, tightest_largest = (uint32_t)heap_size;
+  size_t tightest_used = 0;
+
+  while (fgets(line, sizeof(line), trace) != NULL) {
+    char kind;
+    unsigned long long ms;
+    size_t id, size;
+    char site_name[MAX_SITE_NAME];
+    bool failed = false;
+    int site_index = 0;
+
+    if (sscanf(line, "a %llu %zu %zu %63s", &ms, &id, &size, site_name) == 4) {
+      kind = 'a';
+    } else if (sscanf(line, "x %llu %zu %63s", &ms, &size, site_name) == 3) {
+      kind = 'x';
+    } else if (sscanf(line, "f %llu %zu", &ms, &id) == 2) {
+      kind = 'f';
+    } else {
+      fprintf(stderr, "bad line in trace: %s", line);
+      exit(1);
+    }
+    if (!any_event) {
+      first_ms = ms;
+      any_event = true;
+    }
+
+    if (kind == 'a') {
+      ++allocs;
+      site_index = find_site(site_name);
+      struct SimSite *site = &sites[site_index];
+      ++site->allocs;
+      uint32_t charge = (uint32_t)(size + overhead);
+      uint32_t offset;
+      if (sim_alloc(charge, &offset)) {
+        struct SimBlock *block = get_block(id);
+        block->offset = offset;
+        block->size = charge;
+        block->site = site_index;
+        block->alloc_ms = ms;
+        used += charge;
+        site->live_bytes += charge;
+        if (site->live_bytes > site->peak_bytes) {
+          site->peak_bytes = site->live_bytes;
+        }
+        if (used > peak_used) {
+          peak_used = used;
+          peak_ms = ms;
+          peak_largest = largest_free();
+        }
+        uint32_t largest = largest_free();
+        if (largest < tightest_largest) {
+          tightest_largest = largest;
+          tightest_ms = ms;
+          tightest_used = used;
+        }
+      } else {
+        failed = true;
+      }
+
+    } else if (kind == 'x') {
+      ++trace_failures;
+      site_index = find_site(site_name);
+      ++sites[site_index].allocs;
+      failed = true;
+
+    } else {
+      struct SimBlock *block = (id < num_blocks) ? &blocks[id] : NULL;
+      if (block != NULL && block->size != 0) {
+        // Frees of allocations we never placed (or that were made
+        // before the trace began) are ignored.
+        ++frees;
+        struct SimSite *site = &sites[block->site];
+        sim_free(block->offset, block->size);
+        used -= block->size;
+        site->live_bytes -= block->size;
+        ++site->frees;
+        site->lifetime_ms += ms - block->alloc_ms;
+        block->size = 0;
+      }
+    }
+
+    if (failed) {
+      // Allocations that fail within the same simulated millisecond
+      // are handled by a single reset_memory_panic().
+      ++failures;
+      ++sites[site_index].failures;
+      if (panics == 0 || ms != last_panic_ms) {
+        ++panics;
+        last_panic_ms = ms;
+      }
+    }
+  }
+  fclose(trace);
+
+  uint32_t end_largest = largest_free();
+  size_t end_free = heap_size - used;
+  int panic_level = (panics < MAX_PANIC_LEVEL) ? panics : MAX_PANIC_LEVEL;
+
+  printf("platform: %s, %zu-byte heap, %d bytes overhead per block\n", platform, heap_size, overhead);
+  printf("events: %u allocations, %u frees, %u failed in the trace\n", allocs + trace_failures, frees, trace_failures);
+  printf("peak use: %zu bytes at %.3f s, largest free block then %u bytes\n",
+         peak_used, (peak_ms - first_ms) / 1000.0, peak_largest);
+  printf("tightest: largest free block %u bytes at %.3f s, with %zu bytes in use\n",
+         tightest_largest, (tightest_ms - first_ms) / 1000.0, tightest_used);
+  printf("end: %zu bytes in use, %zu free, largest free block %u bytes (%d%% fragmented)\n",
+         used, end_free, end_largest, end_free ? (int)(100 - (uint64_t)end_largest * 100 / end_free) : 0);
+  printf("failures: %u, in %u memory panics\n", failures, panics);
+  printf("panic level reached: %d (%s)\n", panic_level, panic_level_names[panic_level]);
+  for (int level = 1; level < panic_level; ++level) {
+    printf("  level %d: %s\n", level, panic_level_names[level]);
+  }
+
+  qsort(sites, num_sites, sizeof(struct SimSite), compare_sites);
+  printf("\n%-24s %9s %8s %10s %12s\n", "site", "allocs", "failures", "peak bytes", "mean life s");
+  for (int i = 0; i < num_sites && i < max_sites_listed; ++i) {
+    struct SimSite *site = &sites[i];
+    printf("%-24s %9u %8u %10zu %12.3f\n", site->name, site->allocs, site->failures, site->peak_bytes,
+           site->frees ? site->lifetime_ms / 1000.0 / site->frees : 0.0);
+  }
+
+  free(blocks);
+  free(extents);
+  return 0;
+}
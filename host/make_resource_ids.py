@@ -0,0 +1,219 @@
+#! /usr/bin/env python
+
+import sys
+import os
+import re
+import json
+import getopt
+
+rootDir = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.append(os.path.join(rootDir, 'resources'))
+from peb_platform import getPlatformColor
+
+help = """
+make_resource_ids.py
+
+Reads the package.json generated by config_watch.py and writes the
+RESOURCE_ID_* definitions and resource table for the pebble.h
+stand-in, for one platform.  Resource IDs are numbered from 1 in the
+order the resources appear in package.json, as the SDK numbers them.
+
+Bitmap resources are converted, as the SDK would convert them, to .pbi
+files in the output directory, so that the stand-in doesn't need to
+decode png's.
+
+make_resource_ids.py [opts] package.json platform
+
+Options:
+
+    -o dir
+        Write resource_ids.auto.h and resource_table.auto.c (and any
+        .pbi files) into the indicated directory.  The default is the
+        current directory.
+
+    -r dir
+        Specify the resources directory that the filenames in
+        package.json are relative to.  The default is the resources
+        directory next to package.json.
+
+"""
+
+def usage(code, msg = ''):
+    print >> sys.stderr, help
+    print >> sys.stderr, msg
+    sys.exit(code)
+
+# These match the GBitmapFormat enum.
+GBitmapFormat1Bit = 0
+GBitmapFormat8Bit = 1
+GBitmapFormat1BitPalette = 2
+GBitmapFormat2BitPalette = 3
+GBitmapFormat4BitPalette = 4
+
+def readPackage(filename):
+    text = open(filename, 'r').read()
+
+    # The generated file may have a trailing comma after the last
+    # media entry, which json doesn't accept.
+    text = re.sub(r',(\s*[\]}])', r'\1', text)
+    return json.loads(text)
+
+def getPlatformResources(package, platform):
+    """ Returns the list of media entries that apply to the indicated
+    platform, in resource ID order. """
+
+    resources = []
+    seen = set()
+    for entry in package['pebble']['resources']['media']:
+        platforms = entry.get('targetPlatforms')
+        if platforms is not None and platform not in platforms:
+            continue
+        name = entry['name']
+        if name in seen:
+            continue
+        seen.add(name)
+        resources.append(entry)
+
+    return resources
+
+def packArgb8(pixel):
+    r, g, b, a = pixel
+    if a < 0x40:
+        # Fully transparent pixels are all the same color.
+        return 0
+    return ((a >> 6) << 6) | ((r >> 6) << 4) | ((g >> 6) << 2) | (b >> 6)
+
+def makePbi(pngFilename, pbiFilename, entry, platform):
+    """ Converts the png file to a .pbi file, the SDK's in-memory
+    GBitmap layout: a 12-byte header, followed by the rows of pixel
+    data, followed by the palette, if any. """
+
+    import PIL.Image
+
+    image = PIL.Image.open(pngFilename).convert('RGBA')
+    w, h = image.size
+    pixels = list(image.getdata())
+
+    memoryFormat = entry.get('memoryFormat', 'Smallest')
+    if memoryFormat == '1Bit' or getPlatformColor(platform) == 'bw':
+        # 1-bit rows are word-aligned and least-significant-bit first.
+        format = GBitmapFormat1Bit
+        stride = ((w + 31) / 32) * 4
+        palette = []
+        data = ''
+        for y in range(h):
+            row = [0] * stride
+            for x in range(w):
+                r, g, b, a = pixels[y * w + x]
+                if a >= 0x80 and r + g + b >= 384:
+                    row[x / 8] |= (1 << (x % 8))
+            data += ''.join(map(chr, row))
+
+    else:
+        colors = map(packArgb8, pixels)
+        palette = sorted(set(colors))
+        if memoryFormat == '8Bit' or len(palette) > 16:
+            format = GBitmapFormat8Bit
+            bpp = 8
+            palette = []
+        elif len(palette) > 4:
+            format, bpp = GBitmapFormat4BitPalette, 4
+        elif len(palette) > 2:
+            format, bpp = GBitmapFormat2BitPalette, 2
+        else:
+            format, bpp = GBitmapFormat1BitPalette, 1
+
+        # Palette rows are byte-aligned and most-significant-bit first.
+        stride = (w * bpp + 7) / 8
+        lookup = dict([(c, i) for i, c in enumerate(palette)])
+        if palette:
+            palette += [0] * ((1 << bpp) - len(palette))
+        data = ''
+        for y in range(h):
+            row = [0] * stride
+            for x in range(w):
+                c = colors[y * w + x]
+                if bpp == 8:
+                    row[x] = c
+                else:
+                    shift = 8 - bpp - (x * bpp) % 8
+                    row[(x * bpp) / 8] |= lookup[c] << shift
+            data += ''.join(map(chr, row))
+
+    # The info_flags word holds the format in bits 1..5 and the
+    # version (1) in bits 12..15.
+    infoFlags = (1 << 12) | (format << 1)
+    header = [stride & 0xff, stride >> 8, infoFlags & 0xff, infoFlags >> 8,
+              0, 0, 0, 0, w & 0xff, w >> 8, h & 0xff, h >> 8]
+    pbi = open(pbiFilename, 'wb')
+    pbi.write(''.join(map(chr, header)))
+    pbi.write(data)
+    pbi.write(''.join(map(chr, palette)))
+
+def makeResourceIds(package, platform, resourcesDir, outputDir):
+    resources = getPlatformResources(package, platform)
+
+    table = []
+    for entry in resources:
+        name, file, type = entry['name'], entry['file'], entry['type']
+        if type == 'bitmap':
+            # The converted file is named by absolute path; the others
+            # are relative to the resources directory given at runtime.
+            pbiFilename = os.path.abspath(os.path.join(outputDir, 'pbi', '%s.pbi' % (name)))
+            if not os.path.isdir(os.path.dirname(pbiFilename)):
+                os.makedirs(os.path.dirname(pbiFilename))
+            makePbi(os.path.join(resourcesDir, file), pbiFilename, entry, platform)
+            file = pbiFilename
+        table.append((name, file, type))
+
+    idsFile = open(os.path.join(outputDir, 'resource_ids.auto.h'), 'w')
+    print >> idsFile, '// Generated by make_resource_ids.py for %s' % (platform)
+    print >> idsFile, ''
+    print >> idsFile, '#ifndef RESOURCE_IDS_AUTO_H'
+    print >> idsFile, '#define RESOURCE_IDS_AUTO_H'
+    print >> idsFile, ''
+    print >> idsFile, '#define RESOURCE_ID_FONT_FALLBACK 0'
+    for i in range(len(table)):
+        name, file, type = table[i]
+        print >> idsFile, '#define RESOURCE_ID_%s %s' % (name, i + 1)
+    print >> idsFile, ''
+    print >> idsFile, '#endif  // RESOURCE_IDS_AUTO_H'
+
+    tableFile = open(os.path.join(outputDir, 'resource_table.auto.c'), 'w')
+    print >> tableFile, '// Generated by make_resource_ids.py for %s' % (platform)
+    print >> tableFile, ''
+    print >> tableFile, '#define PEBBLE_HOST_IMPLEMENTATION 1'
+    print >> tableFile, '#include "pebble_host.h"'
+    print >> tableFile, ''
+    print >> tableFile, 'const struct HostResource host_resource_table[] = {'
+    for name, file, type in table:
+        print >> tableFile, '  { "%s", "%s", "%s" },' % (name, file, type)
+    print >> tableFile, '};'
+    print >> tableFile, ''
+    print >> tableFile, 'const int host_num_resources = %s;' % (len(table))
+
+# Main.
+try:
+    opts, args = getopt.getopt(sys.argv[1:], 'o:r:h')
+except getopt.error, msg:
+    usage(1, msg)
+
+outputDir = '.'
+resourcesDir = None
+for opt, arg in opts:
+    if opt == '-o':
+        outputDir = arg
+    elif opt == '-r':
+        resourcesDir = arg
+    elif opt == '-h':
+        usage(0)
+
+if len(args) != 2:
+    usage(1, 'Specify package.json and a platform.')
+
+packageFilename, platform = args
+if resourcesDir is None:
+    resourcesDir = os.path.join(os.path.dirname(os.path.abspath(packageFilename)), 'resources')
+
+package = readPackage(packageFilename)
+makeResourceIds(package, platform, resourcesDir, outputDir)
@@ -0,0 +1,638 @@
+#ifndef PEBBLE_H
+#define PEBBLE_H
+
+// This is a host-side stand-in for the Pebble SDK's pebble.h.  It
+// declares just enough of the SDK for the watchface sources in src/
+// to compile unchanged on a normal Linux box, against the software
+// implementation in pebble_host.c.  See host/README.txt.
+//
+// Exactly one of PBL_PLATFORM_APLITE, PBL_PLATFORM_BASALT,
+// PBL_PLATFORM_CHALK, PBL_PLATFORM_DIORITE, or PBL_PLATFORM_EMERY
+// must be defined on the compiler command line; the remaining
+// platform symbols are inferred from it, as the SDK would.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(PBL_PLATFORM_APLITE)
+  #define PBL_BW 1
+  #define PBL_RECT 1
+  #define PBL_DISPLAY_WIDTH 144
+  #define PBL_DISPLAY_HEIGHT 168
+#elif defined(PBL_PLATFORM_BASALT)
+  #define PBL_COLOR 1
+  #define PBL_RECT 1
+  #define PBL_HEALTH 1
+  #define PBL_DISPLAY_WIDTH 144
+  #define PBL_DISPLAY_HEIGHT 168
+#elif defined(PBL_PLATFORM_CHALK)
+  #define PBL_COLOR 1
+  #define PBL_ROUND 1
+  #define PBL_HEALTH 1
+  #define PBL_DISPLAY_WIDTH 180
+  #define PBL_DISPLAY_HEIGHT 180
+#elif defined(PBL_PLATFORM_DIORITE)
+  #define PBL_BW 1
+  #define PBL_RECT 1
+  #define PBL_HEALTH 1
+  #define PBL_DISPLAY_WIDTH 144
+  #define PBL_DISPLAY_HEIGHT 168
+#elif defined(PBL_PLATFORM_EMERY)
+  #define PBL_COLOR 1
+  #define PBL_RECT 1
+  #define PBL_HEALTH 1
+  #define PBL_DISPLAY_WIDTH 200
+  #define PBL_DISPLAY_HEIGHT 228
+#else
+  #error Define one of PBL_PLATFORM_APLITE, _BASALT, _CHALK, _DIORITE, or _EMERY.
+#endif
+
+#define PBL_SDK_3 1
+
+// PBL_API_EXISTS(foo) is true for each API the stand-in provides
+// that is not universally available in the real SDK.
+#define PBL_API_EXISTS(api) PBL_HOST_API_##api
+#define PBL_HOST_API_layer_get_unobstructed_bounds 1
+
+#define ARRAY_LENGTH(array) (sizeof((array)) / sizeof((array)[0]))
+
+#define SECONDS_PER_MINUTE 60
+#define MINUTES_PER_HOUR 60
+#define SECONDS_PER_HOUR 3600
+#define SECONDS_PER_DAY 86400
+
+// All app allocations are routed through a simulated heap, so that
+// heap_bytes_free() and allocation failures behave the way they
+// would on the watch.  The host-side code (pebble_host.c and the
+// drivers) defines PEBBLE_HOST_IMPLEMENTATION to reach the real libc.
+#ifndef PEBBLE_HOST_IMPLEMENTATION
+#define malloc(size) host_heap_malloc(size)
+#define calloc(count, size) host_heap_calloc(count, size)
+#define realloc(ptr, size) host_heap_realloc(ptr, size)
+#define free(ptr) host_heap_free(ptr)
+
+// The simulated clock replaces the system clock.
+#define time(tloc) host_time(tloc)
+
+#endif  // PEBBLE_HOST_IMPLEMENTATION
+
+void *host_heap_malloc(size_t size);
+void *host_heap_calloc(size_t count, size_t size);
+void *host_heap_realloc(void *ptr, size_t size);
+void host_heap_free(void *ptr);
+time_t host_time(time_t *tloc);
+
+size_t heap_bytes_free(void);
+size_t heap_bytes_used(void);
+
+// Logging.
+typedef enum {
+  APP_LOG_LEVEL_ERROR = 1,
+  APP_LOG_LEVEL_WARNING = 50,
+  APP_LOG_LEVEL_INFO = 100,
+  APP_LOG_LEVEL_DEBUG = 200,
+  APP_LOG_LEVEL_DEBUG_VERBOSE = 255,
+} AppLogLevel;
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...);
+
+#define APP_LOG(level, fmt, args...) \
+  app_log(level, __FILE__, __LINE__, fmt, ## args)
+
+// Geometry.
+typedef struct GPoint {
+  int16_t x;
+  int16_t y;
+} GPoint;
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GPointZero GPoint(0, 0)
+
+typedef struct GSize {
+  int16_t w;
+  int16_t h;
+} GSize;
+#define GSize(w, h) ((GSize){(w), (h)})
+#define GSizeZero GSize(0, 0)
+
+typedef struct GRect {
+  GPoint origin;
+  GSize size;
+} GRect;
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GRectZero GRect(0, 0, 0, 0)
+
+bool grect_equal(const GRect *rect_a, const GRect *rect_b);
+bool grect_contains_point(const GRect *rect, const GPoint *point);
+void grect_clip(GRect *const rect_to_clip, const GRect *const rect_clipper);
+
+// Trigonometry, in the SDK's fixed-point conventions.
+#define TRIG_MAX_RATIO 0xffff
+#define TRIG_MAX_ANGLE 0x10000
+#define DEG_TO_TRIGANGLE(angle) (((angle) * TRIG_MAX_ANGLE) / 360)
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+
+// Colors.  As on SDK 3, every platform uses the 8-bit ARGB GColor;
+// on PBL_BW only black, white, and clear are meaningful.
+typedef union GColor8 {
+  uint8_t argb;
+  struct {
+    uint8_t b:2;
+    uint8_t g:2;
+    uint8_t r:2;
+    uint8_t a:2;
+  };
+} GColor8;
+typedef GColor8 GColor;
+
+#define GColorFromRGBA(red, green, blue, alpha) ((GColor8){ .a = (uint8_t)(alpha) >> 6, .r = (uint8_t)(red) >> 6, .g = (uint8_t)(green) >> 6, .b = (uint8_t)(blue) >> 6 })
+#define GColorFromRGB(red, green, blue) GColorFromRGBA(red, green, blue, 255)
+#define GColorFromHEX(v) GColorFromRGB(((v) >> 16) & 0xff, ((v) >> 8) & 0xff, ((v) & 0xff))
+bool gcolor_equal(GColor8 x, GColor8 y);
+
+#define GColorClearARGB8 ((uint8_t)0x00)
+#define GColorBlackARGB8 ((uint8_t)0xc0)
+#define GColorOxfordBlueARGB8 ((uint8_t)0xc1)
+#define GColorDukeBlueARGB8 ((uint8_t)0xc2)
+#define GColorBlueARGB8 ((uint8_t)0xc3)
+#define GColorDarkGreenARGB8 ((uint8_t)0xc4)
+#define GColorMidnightGreenARGB8 ((uint8_t)0xc5)
+#define GColorCobaltBlueARGB8 ((uint8_t)0xc6)
+#define GColorBlueMoonARGB8 ((uint8_t)0xc7)
+#define GColorIslamicGreenARGB8 ((uint8_t)0xc8)
+#define GColorJaegerGreenARGB8 ((uint8_t)0xc9)
+#define GColorTiffanyBlueARGB8 ((uint8_t)0xca)
+#define GColorVividCeruleanARGB8 ((uint8_t)0xcb)
+#define GColorGreenARGB8 ((uint8_t)0xcc)
+#define GColorMalachiteARGB8 ((uint8_t)0xcd)
+#define GColorMediumSpringGreenARGB8 ((uint8_t)0xce)
+#define GColorCyanARGB8 ((uint8_t)0xcf)
+#define GColorBulgarianRoseARGB8 ((uint8_t)0xd0)
+#define GColorImperialPurpleARGB8 ((uint8_t)0xd1)
+#define GColorIndigoARGB8 ((uint8_t)0xd2)
+#define GColorElectricUltramarineARGB8 ((uint8_t)0xd3)
+#define GColorArmyGreenARGB8 ((uint8_t)0xd4)
+#define GColorDarkGrayARGB8 ((uint8_t)0xd5)
+#define GColorLibertyARGB8 ((uint8_t)0xd6)
+#define GColorVeryLightBlueARGB8 ((uint8_t)0xd7)
+#define GColorKellyGreenARGB8 ((uint8_t)0xd8)
+#define GColorMayGreenARGB8 ((uint8_t)0xd9)
+#define GColorCadetBlueARGB8 ((uint8_t)0xda)
+#define GColorPictonBlueARGB8 ((uint8_t)0xdb)
+#define GColorBrightGreenARGB8 ((uint8_t)0xdc)
+#define GColorScreaminGreenARGB8 ((uint8_t)0xdd)
+#define GColorMediumAquamarineARGB8 ((uint8_t)0xde)
+#define GColorElectricBlueARGB8 ((uint8_t)0xdf)
+#define GColorDarkCandyAppleRedARGB8 ((uint8_t)0xe0)
+#define GColorJazzberryJamARGB8 ((uint8_t)0xe1)
+#define GColorPurpleARGB8 ((uint8_t)0xe2)
+#define GColorVividVioletARGB8 ((uint8_t)0xe3)
+#define GColorWindsorTanARGB8 ((uint8_t)0xe4)
+#define GColorRoseValeARGB8 ((uint8_t)0xe5)
+#define GColorPurpureusARGB8 ((uint8_t)0xe6)
+#define GColorLavenderIndigoARGB8 ((uint8_t)0xe7)
+#define GColorLimerickARGB8 ((uint8_t)0xe8)
+#define GColorBrassARGB8 ((uint8_t)0xe9)
+#define GColorLightGrayARGB8 ((uint8_t)0xea)
+#define GColorBabyBlueEyesARGB8 ((uint8_t)0xeb)
+#define GColorSpringBudARGB8 ((uint8_t)0xec)
+#define GColorInchwormARGB8 ((uint8_t)0xed)
+#define GColorMintGreenARGB8 ((uint8_t)0xee)
+#define GColorCelesteARGB8 ((uint8_t)0xef)
+#define GColorRedARGB8 ((uint8_t)0xf0)
+#define GColorFollyARGB8 ((uint8_t)0xf1)
+#define GColorFashionMagentaARGB8 ((uint8_t)0xf2)
+#define GColorMagentaARGB8 ((uint8_t)0xf3)
+#define GColorOrangeARGB8 ((uint8_t)0xf4)
+#define GColorSunsetOrangeARGB8 ((uint8_t)0xf5)
+#define GColorBrilliantRoseARGB8 ((uint8_t)0xf6)
+#define GColorShockingPinkARGB8 ((uint8_t)0xf7)
+#define GColorChromeYellowARGB8 ((uint8_t)0xf8)
+#define GColorRajahARGB8 ((uint8_t)0xf9)
+#define GColorMelonARGB8 ((uint8_t)0xfa)
+#define GColorRichBrilliantLavenderARGB8 ((uint8_t)0xfb)
+#define GColorYellowARGB8 ((uint8_t)0xfc)
+#define GColorIcterineARGB8 ((uint8_t)0xfd)
+#define GColorPastelYellowARGB8 ((uint8_t)0xfe)
+#define GColorWhiteARGB8 ((uint8_t)0xff)
+
+#define GColorClear ((GColor8){.argb = GColorClearARGB8})
+#define GColorBlack ((GColor8){.argb = GColorBlackARGB8})
+#define GColorWhite ((GColor8){.argb = GColorWhiteARGB8})
+#define GColorDarkGray ((GColor8){.argb = GColorDarkGrayARGB8})
+#define GColorLightGray ((GColor8){.argb = GColorLightGrayARGB8})
+#define GColorOxfordBlue ((GColor8){.argb = GColorOxfordBlueARGB8})
+#define GColorPastelYellow ((GColor8){.argb = GColorPastelYellowARGB8})
+#define GColorYellow ((GColor8){.argb = GColorYellowARGB8})
+#define GColorRed ((GColor8){.argb = GColorRedARGB8})
+#define GColorBlue ((GColor8){.argb = GColorBlueARGB8})
+#define GColorGreen ((GColor8){.argb = GColorGreenARGB8})
+
+// Bitmaps.
+typedef enum GBitmapFormat {
+  GBitmapFormat1Bit = 0,
+  GBitmapFormat8Bit,
+  GBitmapFormat1BitPalette,
+  GBitmapFormat2BitPalette,
+  GBitmapFormat4BitPalette,
+  GBitmapFormat8BitCircular,
+} GBitmapFormat;
+
+typedef struct GBitmap GBitmap;
+
+typedef struct GBitmapDataRowInfo {
+  uint8_t *data;
+  int16_t min_x;
+  int16_t max_x;
+} GBitmapDataRowInfo;
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format);
+GBitmap *gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format, GColor *palette, bool free_on_destroy);
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id);
+GBitmap *gbitmap_create_with_data(const uint8_t *data);
+void gbitmap_destroy(GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+void gbitmap_set_bounds(GBitmap *bitmap, GRect bounds);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap);
+uint8_t *gbitmap_get_data(const GBitmap *bitmap);
+void gbitmap_set_data(GBitmap *bitmap, uint8_t *data, GBitmapFormat format, uint16_t row_size_bytes, bool free_on_destroy);
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap);
+GColor *gbitmap_get_palette(const GBitmap *bitmap);
+void gbitmap_set_palette(GBitmap *bitmap, GColor *palette, bool free_on_destroy);
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y);
+
+// Graphics context.
+typedef enum {
+  GCompOpAssign,
+  GCompOpAssignInverted,
+  GCompOpOr,
+  GCompOpAnd,
+  GCompOpClear,
+  GCompOpSet,
+} GCompOp;
+
+typedef enum {
+  GCornerNone = 0,
+  GCornerTopLeft = 1 << 0,
+  GCornerTopRight = 1 << 1,
+  GCornerBottomLeft = 1 << 2,
+  GCornerBottomRight = 1 << 3,
+  GCornersAll = 0x0f,
+} GCornerMask;
+
+typedef enum {
+  GTextAlignmentLeft,
+  GTextAlignmentCenter,
+  GTextAlignmentRight,
+} GTextAlignment;
+
+typedef enum {
+  GTextOverflowModeWordWrap,
+  GTextOverflowModeTrailingEllipsis,
+  GTextOverflowModeFill,
+} GTextOverflowMode;
+
+typedef struct GContext GContext;
+typedef struct GTextAttributes GTextAttributes;
+typedef struct FontInfo *GFont;
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+void graphics_context_set_antialiased(GContext *ctx, bool enable);
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width);
+
+void graphics_draw_pixel(GContext *ctx, GPoint point);
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1);
+void graphics_draw_rect(GContext *ctx, GRect rect);
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius);
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+void graphics_draw_text(GContext *ctx, const char *text, GFont const font, const GRect box,
+                        const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
+                        GTextAttributes *text_attributes);
+GBitmap *graphics_capture_frame_buffer(GContext *ctx);
+GBitmap *graphics_capture_frame_buffer_format(GContext *ctx, GBitmapFormat format);
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer);
+
+// Paths.
+typedef struct GPathInfo {
+  uint32_t num_points;
+  GPoint *points;
+} GPathInfo;
+
+typedef struct GPath GPath;
+
+GPath *gpath_create(const GPathInfo *init);
+void gpath_destroy(GPath *path);
+void gpath_draw_filled(GContext *ctx, GPath *path);
+void gpath_draw_outline(GContext *ctx, GPath *path);
+void gpath_rotate_to(GPath *path, int32_t angle);
+void gpath_move_to(GPath *path, GPoint point);
+
+// Fonts.
+#define FONT_KEY_FONT_FALLBACK "RESOURCE_ID_FONT_FALLBACK"
+#define FONT_KEY_GOTHIC_14 "RESOURCE_ID_GOTHIC_14"
+#define FONT_KEY_GOTHIC_14_BOLD "RESOURCE_ID_GOTHIC_14_BOLD"
+#define FONT_KEY_GOTHIC_18 "RESOURCE_ID_GOTHIC_18"
+#define FONT_KEY_GOTHIC_18_BOLD "RESOURCE_ID_GOTHIC_18_BOLD"
+#define FONT_KEY_GOTHIC_24 "RESOURCE_ID_GOTHIC_24"
+#define FONT_KEY_GOTHIC_24_BOLD "RESOURCE_ID_GOTHIC_24_BOLD"
+#define FONT_KEY_GOTHIC_28 "RESOURCE_ID_GOTHIC_28"
+#define FONT_KEY_GOTHIC_28_BOLD "RESOURCE_ID_GOTHIC_28_BOLD"
+#define FONT_KEY_GOTHIC_09 "RESOURCE_ID_GOTHIC_09"
+#define FONT_KEY_LECO_20_BOLD_NUMBERS "RESOURCE_ID_LECO_20_BOLD_NUMBERS"
+
+typedef void *ResHandle;
+
+GFont fonts_get_system_font(const char *font_key);
+GFont fonts_load_custom_font(ResHandle handle);
+void fonts_unload_custom_font(GFont font);
+
+// Resources.
+ResHandle resource_get_handle(uint32_t resource_id);
+size_t resource_size(ResHandle h);
+size_t resource_load(ResHandle h, uint8_t *buffer, size_t max_length);
+size_t resource_load_byte_range(ResHandle h, uint32_t start_offset, uint8_t *buffer, size_t num_bytes);
+
+// Layers and windows.
+typedef struct Layer Layer;
+typedef void (*LayerUpdateProc)(struct Layer *layer, GContext *ctx);
+
+Layer *layer_create(GRect frame);
+Layer *layer_create_with_data(GRect frame, size_t data_size);
+void layer_destroy(Layer *layer);
+void layer_mark_dirty(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_set_frame(Layer *layer, GRect frame);
+GRect layer_get_frame(const Layer *layer);
+void layer_set_bounds(Layer *layer, GRect bounds);
+GRect layer_get_bounds(const Layer *layer);
+GRect layer_get_unobstructed_bounds(const Layer *layer);
+void layer_add_child(Layer *parent, Layer *child);
+void layer_remove_from_parent(Layer *child);
+void layer_set_hidden(Layer *layer, bool hidden);
+void *layer_get_data(const Layer *layer);
+
+typedef struct TextLayer TextLayer;
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment);
+void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode line_mode);
+
+#define STATUS_BAR_LAYER_HEIGHT 16
+typedef struct StatusBarLayer StatusBarLayer;
+StatusBarLayer *status_bar_layer_create(void);
+void status_bar_layer_destroy(StatusBarLayer *status_bar_layer);
+Layer *status_bar_layer_get_layer(StatusBarLayer *status_bar_layer);
+
+typedef enum {
+  BUTTON_ID_BACK = 0,
+  BUTTON_ID_UP,
+  BUTTON_ID_SELECT,
+  BUTTON_ID_DOWN,
+  NUM_BUTTONS,
+} ButtonId;
+
+typedef void *ClickRecognizerRef;
+typedef void (*ClickHandler)(ClickRecognizerRef recognizer, void *context);
+typedef void (*ClickConfigProvider)(void *context);
+
+typedef struct Window Window;
+typedef void (*WindowHandler)(struct Window *window);
+
+typedef struct WindowHandlers {
+  WindowHandler load;
+  WindowHandler appear;
+  WindowHandler disappear;
+  WindowHandler unload;
+} WindowHandlers;
+
+Window *window_create(void);
+void window_destroy(Window *window);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider);
+void window_set_click_config_provider_with_context(Window *window, ClickConfigProvider click_config_provider, void *context);
+void window_set_background_color(Window *window, GColor background_color);
+Layer *window_get_root_layer(const Window *window);
+void window_stack_push(Window *window, bool animated);
+Window *window_stack_pop(bool animated);
+void window_stack_pop_all(const bool animated);
+bool window_stack_remove(Window *window, bool animated);
+Window *window_stack_get_top_window(void);
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler);
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler, ClickHandler up_handler);
+
+// Unobstructed area (timeline quick view).
+typedef uint32_t AnimationProgress;
+#define ANIMATION_NORMALIZED_MAX 65535
+typedef void (*UnobstructedAreaWillChangeHandler)(GRect final_unobstructed_screen_area, void *context);
+typedef void (*UnobstructedAreaChangeHandler)(AnimationProgress progress, void *context);
+typedef void (*UnobstructedAreaDidChangeHandler)(void *context);
+
+typedef struct UnobstructedAreaHandlers {
+  UnobstructedAreaWillChangeHandler will_change;
+  UnobstructedAreaChangeHandler change;
+  UnobstructedAreaDidChangeHandler did_change;
+} UnobstructedAreaHandlers;
+
+void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void *context);
+void unobstructed_area_service_unsubscribe(void);
+
+// Timers and the tick service.
+typedef enum {
+  SECOND_UNIT = 1 << 0,
+  MINUTE_UNIT = 1 << 1,
+  HOUR_UNIT = 1 << 2,
+  DAY_UNIT = 1 << 3,
+  MONTH_UNIT = 1 << 4,
+  YEAR_UNIT = 1 << 5,
+} TimeUnits;
+
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer *timer_handle);
+
+uint16_t time_ms(time_t *t_utc, uint16_t *out_ms);
+bool clock_is_24h_style(void);
+
+void app_event_loop(void);
+
+// Focus.
+typedef void (*AppFocusHandler)(bool in_focus);
+typedef struct AppFocusHandlers {
+  AppFocusHandler will_focus;
+  AppFocusHandler did_focus;
+} AppFocusHandlers;
+
+void app_focus_service_subscribe_handlers(AppFocusHandlers handlers);
+void app_focus_service_unsubscribe(void);
+
+// Battery, connection, and quiet time.
+typedef struct {
+  uint8_t charge_percent;
+  bool is_charging;
+  bool is_plugged;
+} BatteryChargeState;
+
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+void battery_state_service_subscribe(BatteryStateHandler handler);
+void battery_state_service_unsubscribe(void);
+BatteryChargeState battery_state_service_peek(void);
+
+typedef void (*BluetoothConnectionHandler)(bool connected);
+void bluetooth_connection_service_subscribe(BluetoothConnectionHandler handler);
+void bluetooth_connection_service_unsubscribe(void);
+bool bluetooth_connection_service_peek(void);
+
+bool quiet_time_is_active(void);
+
+typedef enum {
+  ACCEL_AXIS_X = 0,
+  ACCEL_AXIS_Y = 1,
+  ACCEL_AXIS_Z = 2,
+} AccelAxisType;
+
+typedef void (*AccelTapHandler)(AccelAxisType axis, int32_t direction);
+void accel_tap_service_subscribe(AccelTapHandler handler);
+void accel_tap_service_unsubscribe(void);
+
+// Vibration.
+typedef struct {
+  const uint32_t *durations;
+  uint32_t num_segments;
+} VibePattern;
+
+void vibes_short_pulse(void);
+void vibes_long_pulse(void);
+void vibes_double_pulse(void);
+void vibes_enqueue_custom_pattern(VibePattern pattern);
+void vibes_cancel(void);
+
+// Persistent storage.
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size);
+int persist_write_data(const uint32_t key, const void *data, const size_t size);
+bool persist_exists(const uint32_t key);
+int persist_delete(const uint32_t key);
+
+// Health.
+typedef int32_t HealthValue;
+
+typedef enum {
+  HealthMetricStepCount,
+  HealthMetricActiveSeconds,
+  HealthMetricWalkedDistanceMeters,
+  HealthMetricSleepSeconds,
+  HealthMetricSleepRestfulSeconds,
+  HealthMetricRestingKCalories,
+  HealthMetricActiveKCalories,
+  HealthMetricHeartRateBPM,
+  HealthMetricHeartRateRawBPM,
+} HealthMetric;
+
+typedef enum {
+  HealthEventSignificantUpdate = 0,
+  HealthEventMovementUpdate,
+  HealthEventSleepUpdate,
+  HealthEventMetricAlert,
+  HealthEventHeartRateUpdate,
+} HealthEventType;
+
+typedef enum {
+  MeasurementSystemUnknown,
+  MeasurementSystemMetric,
+  MeasurementSystemImperial,
+} MeasurementSystem;
+
+typedef void (*HealthEventHandler)(HealthEventType event, void *context);
+bool health_service_events_subscribe(HealthEventHandler handler, void *context);
+bool health_service_events_unsubscribe(void);
+HealthValue health_service_sum_today(HealthMetric metric);
+HealthValue health_service_peek_current_value(HealthMetric metric);
+MeasurementSystem health_service_get_measurement_system_for_display(HealthMetric metric);
+
+// AppMessage and dictionaries.
+typedef enum {
+  APP_MSG_OK = 0,
+  APP_MSG_SEND_TIMEOUT = 1 << 1,
+  APP_MSG_SEND_REJECTED = 1 << 2,
+  APP_MSG_NOT_CONNECTED = 1 << 3,
+  APP_MSG_APP_NOT_RUNNING = 1 << 4,
+  APP_MSG_INVALID_ARGS = 1 << 5,
+  APP_MSG_BUSY = 1 << 6,
+  APP_MSG_BUFFER_OVERFLOW = 1 << 7,
+  APP_MSG_ALREADY_RELEASED = 1 << 9,
+  APP_MSG_CALLBACK_ALREADY_REGISTERED = 1 << 10,
+  APP_MSG_CALLBACK_NOT_REGISTERED = 1 << 11,
+  APP_MSG_OUT_OF_MEMORY = 1 << 12,
+  APP_MSG_CLOSED = 1 << 13,
+  APP_MSG_INTERNAL_ERROR = 1 << 14,
+} AppMessageResult;
+
+typedef enum {
+  TUPLE_BYTE_ARRAY = 0,
+  TUPLE_CSTRING = 1,
+  TUPLE_UINT = 2,
+  TUPLE_INT = 3,
+} TupleType;
+
+typedef struct Tuple {
+  uint32_t key;
+  TupleType type:8;
+  uint16_t length;
+  union {
+    uint8_t data[0];
+    char cstring[0];
+    uint8_t uint8;
+    uint16_t uint16;
+    uint32_t uint32;
+    int8_t int8;
+    int16_t int16;
+    int32_t int32;
+  } value[];
+} __attribute__((__packed__)) Tuple;
+
+// The stand-in's dictionary is a flat array of fixed-size tuples,
+// which is enough for the integer-valued config messages.
+typedef struct DictionaryIterator {
+  int num_tuples;
+  struct {
+    Tuple tuple;
+    int32_t int32;
+  } __attribute__((__packed__)) tuples[32];
+} DictionaryIterator;
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key);
+
+typedef void (*AppMessageInboxReceived)(DictionaryIterator *iterator, void *context);
+typedef void (*AppMessageInboxDropped)(AppMessageResult reason, void *context);
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound);
+uint32_t app_message_inbox_size_maximum(void);
+uint32_t app_message_outbox_size_maximum(void);
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback);
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback);
+
+// The RESOURCE_ID_* symbols, generated from package.json by
+// make_resource_ids.py for the current platform.
+#include "resource_ids.auto.h"
+
+#endif  // PEBBLE_H
@@ -0,0 +1,2068 @@
+// The software implementation of the pebble.h stand-in declared in
+// host/pebble.h and host/pebble_host.h.  This is not an emulator; it
+// implements the subset of the SDK that src/ uses, closely enough
+// that the rendering and resource-loading work done by the watchface
+// is the same work it does on the watch.
+
+#define PEBBLE_HOST_IMPLEMENTATION 1
+#include "pebble_host.h"
+#include "../src/config_options.h"
+
+#include <stdarg.h>
+#include <math.h>
+#include <ctype.h>
+#include <assert.h>
+
+// Platform description.
+
+#if defined(PBL_PLATFORM_APLITE)
+  #define HOST_PLATFORM_NAME "aplite"
+  #define HOST_HEAP_LIMIT (24 * 1024)
+#elif defined(PBL_PLATFORM_BASALT)
+  #define HOST_PLATFORM_NAME "basalt"
+  #define HOST_HEAP_LIMIT (64 * 1024)
+#elif defined(PBL_PLATFORM_CHALK)
+  #define HOST_PLATFORM_NAME "chalk"
+  #define HOST_HEAP_LIMIT (64 * 1024)
+#elif defined(PBL_PLATFORM_DIORITE)
+  #define HOST_PLATFORM_NAME "diorite"
+  #define HOST_HEAP_LIMIT (64 * 1024)
+#elif defined(PBL_PLATFORM_EMERY)
+  #define HOST_PLATFORM_NAME "emery"
+  #define HOST_HEAP_LIMIT (128 * 1024)
+#endif
+
+// The per-block bookkeeping cost of the watch's heap allocator, which
+// we charge against the simulated heap along with each allocation.
+#define HOST_HEAP_BLOCK_OVERHEAD 8
+
+static struct HostStats stats;
+static size_t heap_limit = HOST_HEAP_LIMIT;
+static FILE *heap_trace = NULL;
+static size_t heap_next_id = 0;
+static bool verbose = false;
+static const char *resource_dir = "resources";
+static HostLayerTimingCallback layer_timing_callback = NULL;
+
+const char *host_platform_name(void) {
+  return HOST_PLATFORM_NAME;
+}
+
+void host_set_verbose(bool new_verbose) {
+  verbose = new_verbose;
+}
+
+void host_set_layer_timing_callback(HostLayerTimingCallback callback) {
+  layer_timing_callback = callback;
+}
+
+void host_get_stats(struct HostStats *result) {
+  stats.heap_limit = heap_limit;
+  *result = stats;
+}
+
+void host_reset_stats(void) {
+  size_t heap_used = stats.heap_used;
+  memset(&stats, 0, sizeof(stats));
+  stats.heap_used = heap_used;
+  stats.heap_peak = heap_used;
+}
+
+uint64_t host_clock_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void host_fatal(const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  fprintf(stderr, "pebble_host: ");
+  vfprintf(stderr, fmt, ap);
+  fprintf(stderr, "\n");
+  va_end(ap);
+  exit(1);
+}
+
+// Simulated heap.  Each block carries a header recording its size, so
+// that free() can credit the heap, and a serial number that names it
+// in the heap trace.
+
+typedef struct {
+  size_t size;
+  size_t id;  // also keeps the payload 16-byte aligned
+} HeapHeader;
+
+// Named by src/ with HEAP_TRACE_BEGIN() (see bwd.h).
+const char *heap_trace_site = NULL;
+
+void host_set_heap_trace(FILE *trace) {
+  heap_trace = trace;
+  if (heap_trace != NULL) {
+    fprintf(heap_trace, "# heap trace: platform %s, heap %zu, overhead %d\n", HOST_PLATFORM_NAME, heap_limit, HOST_HEAP_BLOCK_OVERHEAD);
+  }
+}
+
+size_t host_default_heap_limit(void) {
+  return HOST_HEAP_LIMIT;
+}
+
+void host_set_heap_limit(size_t new_heap_limit) {
+  heap_limit = new_heap_limit;
+}
+
+void *host_heap_malloc(size_t size) {
+  size_t charge = size + HOST_HEAP_BLOCK_OVERHEAD;
+  if (stats.heap_used + charge > heap_limit) {
+    ++stats.heap_failures;
+    if (heap_trace != NULL) {
+      fprintf(heap_trace, "x %llu %zu %s\n", (unsigned long long)host_now_ms(), size, heap_trace_site != NULL ? heap_trace_site : "-");
+    }
+    return NULL;
+  }
+
+  HeapHeader *header = (HeapHeader *)malloc(sizeof(HeapHeader) + size);
+  if (header == NULL) {
+    host_fatal("out of host memory");
+  }
+  header->size = size;
+  header->id = ++heap_next_id;
+  if (heap_trace != NULL) {
+    fprintf(heap_trace, "a %llu %zu %zu %s\n", (unsigned long long)host_now_ms(), header->id, size, heap_trace_site != NULL ? heap_trace_site : "-");
+  }
+  stats.heap_used += charge;
+  if (stats.heap_used > stats.heap_peak) {
+    stats.heap_peak = stats.heap_used;
+  }
+  ++stats.heap_allocs;
+  return header + 1;
+}
+
+void *host_heap_calloc(size_t count, size_t size) {
+  void *ptr = host_heap_malloc(count * size);
+  if (ptr != NULL) {
+    memset(ptr, 0, count * size);
+  }
+  return ptr;
+}
+
+void host_heap_free(void *ptr) {
+  if (ptr == NULL) {
+    return;
+  }
+  HeapHeader *header = (HeapHeader *)ptr - 1;
+  if (heap_trace != NULL) {
+    fprintf(heap_trace, "f %llu %zu\n", (unsigned long long)host_now_ms(), header->id);
+  }
+  stats.heap_used -= header->size + HOST_HEAP_BLOCK_OVERHEAD;
+  ++stats.heap_frees;
+  free(header);
+}
+
+void *host_heap_realloc(void *ptr, size_t size) {
+  if (ptr == NULL) {
+    return host_heap_malloc(size);
+  }
+  HeapHeader *header = (HeapHeader *)ptr - 1;
+  void *new_ptr = host_heap_malloc(size);
+  if (new_ptr != NULL) {
+    memcpy(new_ptr, ptr, header->size < size ? header->size : size);
+    host_heap_free(ptr);
+  }
+  return new_ptr;
+}
+
+size_t heap_bytes_free(void) {
+  return heap_limit - stats.heap_used;
+}
+
+size_t heap_bytes_used(void) {
+  return stats.heap_used;
+}
+
+// Logging.
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...) {
+  if (!verbose && log_level > APP_LOG_LEVEL_WARNING) {
+    return;
+  }
+  va_list ap;
+  va_start(ap, fmt);
+  fprintf(stderr, "[%llu] %s:%d ", (unsigned long long)host_now_ms(), src_filename, src_line_number);
+  vfprintf(stderr, fmt, ap);
+  fprintf(stderr, "\n");
+  va_end(ap);
+}
+
+// Geometry and trigonometry.
+
+bool grect_equal(const GRect *a, const GRect *b) {
+  return a->origin.x == b->origin.x && a->origin.y == b->origin.y &&
+    a->size.w == b->size.w && a->size.h == b->size.h;
+}
+
+bool grect_contains_point(const GRect *rect, const GPoint *point) {
+  return point->x >= rect->origin.x && point->x < rect->origin.x + rect->size.w &&
+    point->y >= rect->origin.y && point->y < rect->origin.y + rect->size.h;
+}
+
+static GRect grect_intersect(GRect a, GRect b) {
+  int x0 = a.origin.x > b.origin.x ? a.origin.x : b.origin.x;
+  int y0 = a.origin.y > b.origin.y ? a.origin.y : b.origin.y;
+  int x1 = (a.origin.x + a.size.w < b.origin.x + b.size.w) ? a.origin.x + a.size.w : b.origin.x + b.size.w;
+  int y1 = (a.origin.y + a.size.h < b.origin.y + b.size.h) ? a.origin.y + a.size.h : b.origin.y + b.size.h;
+  if (x1 < x0) {
+    x1 = x0;
+  }
+  if (y1 < y0) {
+    y1 = y0;
+  }
+  return GRect(x0, y0, x1 - x0, y1 - y0);
+}
+
+void grect_clip(GRect *const rect_to_clip, const GRect *const rect_clipper) {
+  *rect_to_clip = grect_intersect(*rect_to_clip, *rect_clipper);
+}
+
+int32_t sin_lookup(int32_t angle) {
+  return (int32_t)lround(sin(angle * 2.0 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle) {
+  return (int32_t)lround(cos(angle * 2.0 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+bool gcolor_equal(GColor8 x, GColor8 y) {
+  return x.argb == y.argb || (x.a == 0 && y.a == 0);
+}
+
+// Bitmaps.
+
+struct GBitmap {
+  GBitmapFormat format;
+  GRect bounds;
+  uint16_t row_size_bytes;
+  uint8_t *data;
+  GColor *palette;
+  bool free_data;
+  bool free_palette;
+};
+
+static int bits_per_pixel(GBitmapFormat format) {
+  switch (format) {
+  case GBitmapFormat1Bit:
+  case GBitmapFormat1BitPalette:
+    return 1;
+  case GBitmapFormat2BitPalette:
+    return 2;
+  case GBitmapFormat4BitPalette:
+    return 4;
+  case GBitmapFormat8Bit:
+  case GBitmapFormat8BitCircular:
+    return 8;
+  }
+  return 8;
+}
+
+static int palette_size(GBitmapFormat format) {
+  switch (format) {
+  case GBitmapFormat1BitPalette:
+    return 2;
+  case GBitmapFormat2BitPalette:
+    return 4;
+  case GBitmapFormat4BitPalette:
+    return 16;
+  default:
+    return 0;
+  }
+}
+
+static uint16_t row_size_for(GSize size, GBitmapFormat format) {
+  if (format == GBitmapFormat1Bit) {
+    // 1-bit rows are word-aligned; the others are byte-aligned.
+    return ((size.w + 31) / 32) * 4;
+  }
+  return (size.w * bits_per_pixel(format) + 7) / 8;
+}
+
+static GBitmap *gbitmap_create_internal(GSize size, GBitmapFormat format, GColor *palette, bool free_palette) {
+  GBitmap *bitmap = (GBitmap *)host_heap_calloc(1, sizeof(GBitmap));
+  if (bitmap == NULL) {
+    return NULL;
+  }
+  bitmap->format = format;
+  bitmap->bounds = GRect(0, 0, size.w, size.h);
+  bitmap->row_size_bytes = row_size_for(size, format);
+  bitmap->data = (uint8_t *)host_heap_calloc(1, bitmap->row_size_bytes * size.h);
+  bitmap->free_data = true;
+  if (bitmap->data == NULL && size.h != 0) {
+    host_heap_free(bitmap);
+    return NULL;
+  }
+
+  int num_colors = palette_size(format);
+  if (palette == NULL && num_colors != 0) {
+    palette = (GColor *)host_heap_calloc(num_colors, sizeof(GColor));
+    free_palette = true;
+    if (palette == NULL) {
+      host_heap_free(bitmap->data);
+      host_heap_free(bitmap);
+      return NULL;
+    }
+  }
+  bitmap->palette = palette;
+  bitmap->free_palette = free_palette;
+  return bitmap;
+}
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+  return gbitmap_create_internal(size, format, NULL, false);
+}
+
+GBitmap *gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format, GColor *palette, bool free_on_destroy) {
+  return gbitmap_create_internal(size, format, palette, free_on_destroy);
+}
+
+GBitmap *gbitmap_create_with_data(const uint8_t *data) {
+  host_fatal("gbitmap_create_with_data() is not supported");
+  return NULL;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+  if (bitmap == NULL) {
+    return;
+  }
+  if (bitmap->free_data) {
+    host_heap_free(bitmap->data);
+  }
+  if (bitmap->free_palette) {
+    host_heap_free(bitmap->palette);
+  }
+  host_heap_free(bitmap);
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+  return bitmap->bounds;
+}
+
+void gbitmap_set_bounds(GBitmap *bitmap, GRect bounds) {
+  bitmap->bounds = bounds;
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) {
+  return bitmap->row_size_bytes;
+}
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) {
+  return bitmap->data;
+}
+
+void gbitmap_set_data(GBitmap *bitmap, uint8_t *data, GBitmapFormat format, uint16_t row_size_bytes, bool free_on_destroy) {
+  if (bitmap->free_data && bitmap->data != data) {
+    host_heap_free(bitmap->data);
+  }
+  bitmap->data = data;
+  bitmap->format = format;
+  bitmap->row_size_bytes = row_size_bytes;
+  bitmap->free_data = free_on_destroy;
+}
+
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap) {
+  return bitmap->format;
+}
+
+GColor *gbitmap_get_palette(const GBitmap *bitmap) {
+  return bitmap->palette;
+}
+
+void gbitmap_set_palette(GBitmap *bitmap, GColor *palette, bool free_on_destroy) {
+  if (bitmap->free_palette && bitmap->palette != palette) {
+    host_heap_free(bitmap->palette);
+  }
+  bitmap->palette = palette;
+  bitmap->free_palette = free_on_destroy;
+}
+
+// Returns the visible span of row y of a round display, the way the
+// 8BitCircular framebuffer reports it.
+static void circular_row_span(const GBitmap *bitmap, int y, int16_t *min_x, int16_t *max_x) {
+  int w = bitmap->bounds.size.w;
+  int h = bitmap->bounds.size.h;
+  double r = w / 2.0;
+  double dy = y + 0.5 - h / 2.0;
+  double half = r * r - dy * dy;
+  int span = half > 0.0 ? (int)(sqrt(half) + 0.5) : 0;
+  *min_x = (int16_t)(w / 2 - span);
+  *max_x = (int16_t)(w / 2 + span - 1);
+}
+
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y) {
+  GBitmapDataRowInfo info;
+  info.data = bitmap->data + y * bitmap->row_size_bytes;
+  info.min_x = 0;
+  info.max_x = bitmap->bounds.size.w - 1;
+  if (bitmap->format == GBitmapFormat8BitCircular) {
+    circular_row_span(bitmap, y, &info.min_x, &info.max_x);
+  }
+  return info;
+}
+
+// Reads pixel (x, y) of the bitmap as a GColor.  1-bit images are
+// black and white.
+static inline GColor bitmap_get_color(const GBitmap *bitmap, int x, int y) {
+  const uint8_t *row = bitmap->data + y * bitmap->row_size_bytes;
+  GColor color;
+  switch (bitmap->format) {
+  case GBitmapFormat1Bit:
+    color.argb = ((row[x >> 3] >> (x & 7)) & 1) ? GColorWhiteARGB8 : GColorBlackARGB8;
+    return color;
+  case GBitmapFormat1BitPalette:
+    return bitmap->palette[(row[x >> 3] >> (7 - (x & 7))) & 1];
+  case GBitmapFormat2BitPalette:
+    return bitmap->palette[(row[x >> 2] >> ((3 - (x & 3)) * 2)) & 3];
+  case GBitmapFormat4BitPalette:
+    return bitmap->palette[(row[x >> 1] >> ((1 - (x & 1)) * 4)) & 0xf];
+  case GBitmapFormat8Bit:
+  case GBitmapFormat8BitCircular:
+    color.argb = row[x];
+    return color;
+  }
+  color.argb = 0;
+  return color;
+}
+
+// Resources.
+
+void host_set_resource_dir(const char *new_resource_dir) {
+  resource_dir = new_resource_dir;
+}
+
+struct LoadedResource {
+  uint8_t *data;
+  size_t size;
+  bool loaded;
+};
+
+// Resources added at runtime by host_add_resource_file() are numbered
+// after the ones in the generated table.
+#define MAX_EXTRA_RESOURCES 1024
+static struct HostResource extra_resources[MAX_EXTRA_RESOURCES];
+static int num_extra_resources = 0;
+
+static struct LoadedResource *loaded_resources = NULL;
+
+static const struct HostResource *get_resource(uint32_t resource_id) {
+  if (resource_id < 1 || (int)resource_id > host_num_resources + num_extra_resources) {
+    host_fatal("invalid resource id %u", (unsigned int)resource_id);
+  }
+  if ((int)resource_id > host_num_resources) {
+    return &extra_resources[resource_id - host_num_resources - 1];
+  }
+  return &host_resource_table[resource_id - 1];
+}
+
+static int get_resource_index(const struct HostResource *resource) {
+  if (resource >= extra_resources && resource < extra_resources + MAX_EXTRA_RESOURCES) {
+    return host_num_resources + (resource - extra_resources);
+  }
+  return resource - host_resource_table;
+}
+
+uint32_t host_add_resource_file(const char *name, const char *filename, const char *type) {
+  if (num_extra_resources >= MAX_EXTRA_RESOURCES) {
+    host_fatal("too many resources");
+  }
+  struct HostResource *resource = &extra_resources[num_extra_resources++];
+  resource->name = strdup(name);
+  resource->file = strdup(filename);
+  resource->type = strdup(type);
+  return host_num_resources + num_extra_resources;
+}
+
+uint32_t host_get_num_resources(void) {
+  return host_num_resources + num_extra_resources;
+}
+
+const struct HostResource *host_get_resource(uint32_t resource_id) {
+  return get_resource(resource_id);
+}
+
+// Resources live in flash on the watch, so the file contents are
+// held outside the simulated heap.
+static struct LoadedResource *load_resource(const struct HostResource *resource) {
+  if (loaded_resources == NULL) {
+    loaded_resources = (struct LoadedResource *)calloc(host_num_resources + MAX_EXTRA_RESOURCES, sizeof(struct LoadedResource));
+  }
+  struct LoadedResource *lr = &loaded_resources[get_resource_index(resource)];
+  if (!lr->loaded) {
+    char pathname[1024];
+    if (resource->file[0] == '/') {
+      snprintf(pathname, sizeof(pathname), "%s", resource->file);
+    } else {
+      snprintf(pathname, sizeof(pathname), "%s/%s", resource_dir, resource->file);
+    }
+    FILE *file = fopen(pathname, "rb");
+    if (file == NULL) {
+      host_fatal("cannot open resource %s (%s)", resource->name, pathname);
+    }
+    fseek(file, 0, SEEK_END);
+    lr->size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    lr->data = (uint8_t *)malloc(lr->size + 1);
+    if (fread(lr->data, 1, lr->size, file) != lr->size) {
+      host_fatal("cannot read resource %s (%s)", resource->name, pathname);
+    }
+    fclose(file);
+    lr->loaded = true;
+  }
+  return lr;
+}
+
+ResHandle resource_get_handle(uint32_t resource_id) {
+  ++stats.resource_handles;
+  return (ResHandle)get_resource(resource_id);
+}
+
+size_t resource_size(ResHandle h) {
+  return load_resource((const struct HostResource *)h)->size;
+}
+
+size_t resource_load_byte_range(ResHandle h, uint32_t start_offset, uint8_t *buffer, size_t num_bytes) {
+  struct LoadedResource *lr = load_resource((const struct HostResource *)h);
+  if (start_offset >= lr->size) {
+    return 0;
+  }
+  if (num_bytes > lr->size - start_offset) {
+    num_bytes = lr->size - start_offset;
+  }
+  memcpy(buffer, lr->data + start_offset, num_bytes);
+  ++stats.resource_loads;
+  stats.resource_bytes += num_bytes;
+  return num_bytes;
+}
+
+size_t resource_load(ResHandle h, uint8_t *buffer, size_t max_length) {
+  return resource_load_byte_range(h, 0, buffer, max_length);
+}
+
+// Bitmap resources have been converted to .pbi files by
+// make_resource_ids.py: a 12-byte header (row size, info flags, and
+// bounds), the pixel rows, then the palette.  As on the watch, the
+// bitmap and its pixels are copied into the app heap.
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id) {
+  ResHandle h = resource_get_handle(resource_id);
+  size_t size = resource_size(h);
+  uint8_t header[12];
+  if (size < sizeof(header) || resource_load_byte_range(h, 0, header, sizeof(header)) != sizeof(header)) {
+    host_fatal("resource %s is not a pbi", ((const struct HostResource *)h)->name);
+  }
+  uint16_t row_size_bytes = header[0] | (header[1] << 8);
+  uint16_t info_flags = header[2] | (header[3] << 8);
+  GBitmapFormat format = (GBitmapFormat)((info_flags >> 1) & 0x1f);
+  GSize bitmap_size = GSize(header[8] | (header[9] << 8), header[10] | (header[11] << 8));
+
+  GBitmap *bitmap = gbitmap_create_blank(bitmap_size, format);
+  if (bitmap == NULL) {
+    return NULL;
+  }
+  assert(bitmap->row_size_bytes == row_size_bytes);
+  size_t data_size = row_size_bytes * bitmap_size.h;
+  resource_load_byte_range(h, sizeof(header), bitmap->data, data_size);
+  if (bitmap->palette != NULL) {
+    resource_load_byte_range(h, sizeof(header) + data_size, (uint8_t *)bitmap->palette, palette_size(format));
+  }
+  return bitmap;
+}
+
+// Fonts.  There is no glyph rasterizer; text is drawn as one block
+// per character, sized from the font's nominal height, which is
+// enough to keep the drawing cost in the right neighborhood.
+
+struct FontInfo {
+  int height;
+  bool custom;
+};
+
+static int font_height_from_name(const char *name) {
+  // The nominal height is the last number in the name, e.g. GOTHIC_28_BOLD
+  // or DAY_FONT_LATIN_16.
+  int height = 0;
+  for (const char *p = name; *p != '\0'; ++p) {
+    if (isdigit((unsigned char)*p) && (p == name || !isdigit((unsigned char)p[-1]))) {
+      height = atoi(p);
+    }
+  }
+  return height != 0 ? height : 14;
+}
+
+GFont fonts_get_system_font(const char *font_key) {
+  static struct FontInfo system_fonts[8];
+  static const char *system_font_keys[8];
+  for (int i = 0; i < 8; ++i) {
+    if (system_font_keys[i] == NULL) {
+      system_font_keys[i] = font_key;
+      system_fonts[i].height = font_height_from_name(font_key);
+      system_fonts[i].custom = false;
+    }
+    if (strcmp(system_font_keys[i], font_key) == 0) {
+      return &system_fonts[i];
+    }
+  }
+  return &system_fonts[0];
+}
+
+GFont fonts_load_custom_font(ResHandle handle) {
+  if (handle == NULL) {
+    return NULL;
+  }
+  GFont font = (GFont)host_heap_malloc(sizeof(struct FontInfo));
+  if (font == NULL) {
+    return NULL;
+  }
+  font->height = font_height_from_name(((const struct HostResource *)handle)->name);
+  font->custom = true;
+  return font;
+}
+
+void fonts_unload_custom_font(GFont font) {
+  if (font != NULL && font->custom) {
+    host_heap_free(font);
+  }
+}
+
+// Graphics context and rasterizer.
+
+struct GContext {
+  GBitmap *fb;
+  GPoint offset;   // screen position of the current layer's origin
+  GRect clip;      // in screen coordinates
+  GColor stroke_color;
+  GColor fill_color;
+  GColor text_color;
+  GCompOp comp_op;
+  bool fb_captured;
+};
+
+static GBitmap *frame_buffer = NULL;
+static GContext graphics_context;
+
+static GBitmap *get_frame_buffer(void) {
+  if (frame_buffer == NULL) {
+    // The framebuffer is system memory, not app heap.
+    frame_buffer = (GBitmap *)calloc(1, sizeof(GBitmap));
+#ifdef PBL_BW
+    frame_buffer->format = GBitmapFormat1Bit;
+#elif defined(PBL_ROUND)
+    frame_buffer->format = GBitmapFormat8BitCircular;
+#else
+    frame_buffer->format = GBitmapFormat8Bit;
+#endif
+    frame_buffer->bounds = GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+    frame_buffer->row_size_bytes = row_size_for(frame_buffer->bounds.size, frame_buffer->format);
+    frame_buffer->data = (uint8_t *)calloc(frame_buffer->row_size_bytes, PBL_DISPLAY_HEIGHT);
+  }
+  return frame_buffer;
+}
+
+GBitmap *host_get_frame_buffer(void) {
+  return get_frame_buffer();
+}
+
+#ifdef PBL_BW
+// On the 1-bit display, maps a color to a pixel value: 1 for white, 0
+// for black, -1 for clear.
+static inline int bw_value(GColor color) {
+  if (color.a == 0) {
+    return -1;
+  }
+  return (color.r + color.g + color.b >= 5) ? 1 : 0;
+}
+
+static inline void fb_put_bit(GBitmap *fb, int x, int y, int bit) {
+  uint8_t *p = &fb->data[y * fb->row_size_bytes + (x >> 3)];
+  if (bit) {
+    *p |= (1 << (x & 7));
+  } else {
+    *p &= ~(1 << (x & 7));
+  }
+}
+
+static inline int fb_get_bit(GBitmap *fb, int x, int y) {
+  return (fb->data[y * fb->row_size_bytes + (x >> 3)] >> (x & 7)) & 1;
+}
+#endif  // PBL_BW
+
+// Plots a solid color at screen position (x, y), already clipped.
+static inline void fb_plot(GBitmap *fb, int x, int y, GColor color) {
+#ifdef PBL_BW
+  int bit = bw_value(color);
+  if (bit >= 0) {
+    fb_put_bit(fb, x, y, bit);
+  }
+#else  // PBL_BW
+  if (color.a == 0) {
+    return;
+  }
+  fb->data[y * fb->row_size_bytes + x] = color.argb | 0xc0;
+#endif  // PBL_BW
+}
+
+static inline bool ctx_contains(GContext *ctx, int x, int y) {
+  return x >= ctx->clip.origin.x && x < ctx->clip.origin.x + ctx->clip.size.w &&
+    y >= ctx->clip.origin.y && y < ctx->clip.origin.y + ctx->clip.size.h;
+}
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {
+  ctx->stroke_color = color;
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {
+  ctx->fill_color = color;
+}
+
+void graphics_context_set_text_color(GContext *ctx, GColor color) {
+  ctx->text_color = color;
+}
+
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode) {
+  ctx->comp_op = mode;
+}
+
+void graphics_context_set_antialiased(GContext *ctx, bool enable) {
+}
+
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width) {
+}
+
+void graphics_draw_pixel(GContext *ctx, GPoint point) {
+  int x = point.x + ctx->offset.x;
+  int y = point.y + ctx->offset.y;
+  if (ctx_contains(ctx, x, y)) {
+    fb_plot(ctx->fb, x, y, ctx->stroke_color);
+  }
+}
+
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1) {
+  int x0 = p0.x + ctx->offset.x, y0 = p0.y + ctx->offset.y;
+  int x1 = p1.x + ctx->offset.x, y1 = p1.y + ctx->offset.y;
+  int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int err = dx + dy;
+  while (true) {
+    if (ctx_contains(ctx, x0, y0)) {
+      fb_plot(ctx->fb, x0, y0, ctx->stroke_color);
+    }
+    if (x0 == x1 && y0 == y1) {
+      break;
+    }
+    int e2 = 2 * err;
+    if (e2 >= dy) {
+      err += dy;
+      x0 += sx;
+    }
+    if (e2 <= dx) {
+      err += dx;
+      y0 += sy;
+    }
+  }
+}
+
+void graphics_draw_rect(GContext *ctx, GRect rect) {
+  int x1 = rect.origin.x + rect.size.w - 1;
+  int y1 = rect.origin.y + rect.size.h - 1;
+  graphics_draw_line(ctx, rect.origin, GPoint(x1, rect.origin.y));
+  graphics_draw_line(ctx, GPoint(x1, rect.origin.y), GPoint(x1, y1));
+  graphics_draw_line(ctx, GPoint(x1, y1), GPoint(rect.origin.x, y1));
+  graphics_draw_line(ctx, GPoint(rect.origin.x, y1), rect.origin);
+}
+
+static void fill_screen_rect(GContext *ctx, GRect rect, GColor color) {
+  rect.origin.x += ctx->offset.x;
+  rect.origin.y += ctx->offset.y;
+  rect = grect_intersect(rect, ctx->clip);
+  for (int y = rect.origin.y; y < rect.origin.y + rect.size.h; ++y) {
+    for (int x = rect.origin.x; x < rect.origin.x + rect.size.w; ++x) {
+      fb_plot(ctx->fb, x, y, color);
+    }
+  }
+}
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask) {
+  fill_screen_rect(ctx, rect, ctx->fill_color);
+}
+
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius) {
+  int r2 = radius * radius;
+  for (int dy = -radius; dy <= radius; ++dy) {
+    for (int dx = -radius; dx <= radius; ++dx) {
+      if (dx * dx + dy * dy <= r2) {
+        int x = p.x + dx + ctx->offset.x;
+        int y = p.y + dy + ctx->offset.y;
+        if (ctx_contains(ctx, x, y)) {
+          fb_plot(ctx->fb, x, y, ctx->fill_color);
+        }
+      }
+    }
+  }
+}
+
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius) {
+  int steps = 8 * radius + 8;
+  for (int i = 0; i < steps; ++i) {
+    int32_t angle = TRIG_MAX_ANGLE * i / steps;
+    GPoint q = GPoint(p.x + sin_lookup(angle) * radius / TRIG_MAX_RATIO,
+                      p.y - cos_lookup(angle) * radius / TRIG_MAX_RATIO);
+    graphics_draw_pixel(ctx, q);
+  }
+}
+
+#ifndef PBL_BW
+// Blends src over dst with the source's 2-bit alpha.
+static inline uint8_t blend_argb8(uint8_t dst, GColor src) {
+  if (src.a == 3) {
+    return src.argb;
+  }
+  GColor d;
+  d.argb = dst;
+  int a = src.a;
+  GColor result;
+  result.a = 3;
+  result.r = (src.r * a + d.r * (3 - a) + 1) / 3;
+  result.g = (src.g * a + d.g * (3 - a) + 1) / 3;
+  result.b = (src.b * a + d.b * (3 - a) + 1) / 3;
+  return result.argb;
+}
+#endif  // PBL_BW
+
+// Draws the bitmap into rect, tiling it if rect is larger than the
+// bitmap, and honoring the current compositing mode.  On the 1-bit
+// display all of the modes apply bitwise; on color displays, 1-bit
+// sources apply bitwise to black and white, and everything else is
+// either assigned (GCompOpAssign) or alpha-blended (GCompOpSet).
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+  if (bitmap == NULL) {
+    return;
+  }
+  GBitmap *fb = ctx->fb;
+  GRect screen = rect;
+  screen.origin.x += ctx->offset.x;
+  screen.origin.y += ctx->offset.y;
+  GRect area = grect_intersect(screen, ctx->clip);
+  int bw = bitmap->bounds.size.w;
+  int bh = bitmap->bounds.size.h;
+  if (bw == 0 || bh == 0) {
+    return;
+  }
+  if (area.size.w > 0 && area.size.h > 0) {
+    stats.pixels_blitted += area.size.w * area.size.h;
+  }
+
+  for (int y = area.origin.y; y < area.origin.y + area.size.h; ++y) {
+    int sy = bitmap->bounds.origin.y + (y - screen.origin.y) % bh;
+    for (int x = area.origin.x; x < area.origin.x + area.size.w; ++x) {
+      int sx = bitmap->bounds.origin.x + (x - screen.origin.x) % bw;
+      GColor src = bitmap_get_color(bitmap, sx, sy);
+
+#ifdef PBL_BW
+      int s = bw_value(src);
+      if (s < 0) {
+        continue;
+      }
+      int d = fb_get_bit(fb, x, y);
+      switch (ctx->comp_op) {
+      case GCompOpAssign: d = s; break;
+      case GCompOpAssignInverted: d = !s; break;
+      case GCompOpOr: d = d | s; break;
+      case GCompOpAnd: d = d & s; break;
+      case GCompOpClear: d = d & !s; break;
+      case GCompOpSet: d = d | !s; break;
+      }
+      fb_put_bit(fb, x, y, d);
+
+#else  // PBL_BW
+      uint8_t *p = &fb->data[y * fb->row_size_bytes + x];
+      if (bitmap->format == GBitmapFormat1Bit) {
+        int s = (src.argb == GColorWhiteARGB8);
+        int d = ((*p & 0x3f) == 0x3f);
+        switch (ctx->comp_op) {
+        case GCompOpAssign: d = s; break;
+        case GCompOpAssignInverted: d = !s; break;
+        case GCompOpOr: d = d | s; break;
+        case GCompOpAnd: d = d & s; break;
+        case GCompOpClear: d = d & !s; break;
+        case GCompOpSet: d = d | !s; break;
+        }
+        *p = d ? GColorWhiteARGB8 : GColorBlackARGB8;
+      } else if (ctx->comp_op == GCompOpSet) {
+        if (src.a != 0) {
+          *p = blend_argb8(*p, src);
+        }
+      } else {
+        *p = src.argb | 0xc0;
+      }
+#endif  // PBL_BW
+    }
+  }
+}
+
+void graphics_draw_text(GContext *ctx, const char *text, GFont const font, const GRect box,
+                        const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
+                        GTextAttributes *text_attributes) {
+  if (text == NULL || font == NULL) {
+    return;
+  }
+  ++stats.texts_drawn;
+  int height = font->height;
+  int char_w = height / 2;
+  int glyph_h = height * 2 / 3;
+  int len = 0;
+  for (const char *p = text; *p != '\0'; ++p) {
+    // Count UTF-8 characters, not bytes.
+    if ((*p & 0xc0) != 0x80) {
+      ++len;
+    }
+  }
+  int text_w = len * char_w;
+  int x = box.origin.x;
+  if (alignment == GTextAlignmentCenter) {
+    x += (box.size.w - text_w) / 2;
+  } else if (alignment == GTextAlignmentRight) {
+    x += box.size.w - text_w;
+  }
+  int y = box.origin.y + (height - glyph_h);
+
+  GRect saved_clip = ctx->clip;
+  GRect box_screen = box;
+  box_screen.origin.x += ctx->offset.x;
+  box_screen.origin.y += ctx->offset.y;
+  ctx->clip = grect_intersect(ctx->clip, box_screen);
+  for (const char *p = text; *p != '\0'; ++p) {
+    if ((*p & 0xc0) == 0x80) {
+      continue;
+    }
+    if (*p != ' ') {
+      fill_screen_rect(ctx, GRect(x + 1, y, char_w - 2, glyph_h), ctx->text_color);
+    }
+    x += char_w;
+  }
+  ctx->clip = saved_clip;
+}
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+  if (ctx->fb_captured) {
+    return NULL;
+  }
+  ctx->fb_captured = true;
+  return ctx->fb;
+}
+
+GBitmap *graphics_capture_frame_buffer_format(GContext *ctx, GBitmapFormat format) {
+  return graphics_capture_frame_buffer(ctx);
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer) {
+  if (!ctx->fb_captured || buffer != ctx->fb) {
+    return false;
+  }
+  ctx->fb_captured = false;
+  return true;
+}
+
+// Paths.
+
+struct GPath {
+  uint32_t num_points;
+  GPoint *points;
+  int32_t rotation;
+  GPoint offset;
+};
+
+GPath *gpath_create(const GPathInfo *init) {
+  GPath *path = (GPath *)host_heap_malloc(sizeof(GPath));
+  if (path == NULL) {
+    return NULL;
+  }
+  // As in the SDK, the path refers to the caller's points rather than
+  // copying them.
+  path->num_points = init->num_points;
+  path->points = init->points;
+  path->rotation = 0;
+  path->offset = GPointZero;
+  return path;
+}
+
+void gpath_destroy(GPath *path) {
+  host_heap_free(path);
+}
+
+void gpath_rotate_to(GPath *path, int32_t angle) {
+  path->rotation = angle;
+}
+
+void gpath_move_to(GPath *path, GPoint point) {
+  path->offset = point;
+}
+
+static GPoint gpath_point(GPath *path, int i) {
+  int32_t s = sin_lookup(path->rotation);
+  int32_t c = cos_lookup(path->rotation);
+  GPoint p = path->points[i];
+  GPoint result;
+  result.x = (p.x * c - p.y * s) / TRIG_MAX_RATIO + path->offset.x;
+  result.y = (p.x * s + p.y * c) / TRIG_MAX_RATIO + path->offset.y;
+  return result;
+}
+
+void gpath_draw_outline(GContext *ctx, GPath *path) {
+  if (path->num_points == 0) {
+    return;
+  }
+  GPoint first = gpath_point(path, 0);
+  GPoint prev = first;
+  for (uint32_t i = 1; i < path->num_points; ++i) {
+    GPoint next = gpath_point(path, i);
+    graphics_draw_line(ctx, prev, next);
+    prev = next;
+  }
+  graphics_draw_line(ctx, prev, first);
+}
+
+void gpath_draw_filled(GContext *ctx, GPath *path) {
+  if (path->num_points < 3) {
+    return;
+  }
+  GPoint points[path->num_points];
+  int min_y = 0x7fff, max_y = -0x8000;
+  for (uint32_t i = 0; i < path->num_points; ++i) {
+    points[i] = gpath_point(path, i);
+    if (points[i].y < min_y) min_y = points[i].y;
+    if (points[i].y > max_y) max_y = points[i].y;
+  }
+
+  // Even-odd scanline fill.
+  for (int y = min_y; y <= max_y; ++y) {
+    int xs[path->num_points];
+    int n = 0;
+    for (uint32_t i = 0; i < path->num_points; ++i) {
+      GPoint a = points[i];
+      GPoint b = points[(i + 1) % path->num_points];
+      if ((a.y <= y && b.y > y) || (b.y <= y && a.y > y)) {
+        xs[n++] = a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+      }
+    }
+    for (int i = 1; i < n; ++i) {
+      for (int j = i; j > 0 && xs[j - 1] > xs[j]; --j) {
+        int t = xs[j]; xs[j] = xs[j - 1]; xs[j - 1] = t;
+      }
+    }
+    for (int i = 0; i + 1 < n; i += 2) {
+      fill_screen_rect(ctx, GRect(xs[i], y, xs[i + 1] - xs[i] + 1, 1), ctx->fill_color);
+    }
+  }
+}
+
+// Layers and windows.
+
+struct Layer {
+  GRect frame;
+  GRect bounds;
+  LayerUpdateProc update_proc;
+  struct Layer *parent;
+  struct Layer *first_child;
+  struct Layer *next_sibling;
+  struct Window *window;
+  bool hidden;
+  void *data;
+};
+
+struct Window {
+  Layer *root_layer;
+  WindowHandlers handlers;
+  ClickConfigProvider click_config_provider;
+  void *click_config_context;
+  GColor background_color;
+  bool loaded;
+  bool on_stack;
+};
+
+#define MAX_WINDOW_STACK 8
+static Window *window_stack[MAX_WINDOW_STACK];
+static int window_stack_size = 0;
+static bool needs_redraw = false;
+
+Layer *layer_create(GRect frame) {
+  Layer *layer = (Layer *)host_heap_calloc(1, sizeof(Layer));
+  if (layer == NULL) {
+    return NULL;
+  }
+  layer->frame = frame;
+  layer->bounds = GRect(0, 0, frame.size.w, frame.size.h);
+  return layer;
+}
+
+Layer *layer_create_with_data(GRect frame, size_t data_size) {
+  Layer *layer = layer_create(frame);
+  if (layer != NULL) {
+    layer->data = host_heap_calloc(1, data_size);
+    if (layer->data == NULL) {
+      host_heap_free(layer);
+      return NULL;
+    }
+  }
+  return layer;
+}
+
+void layer_remove_from_parent(Layer *child) {
+  Layer *parent = child->parent;
+  if (parent == NULL) {
+    return;
+  }
+  Layer **p = &parent->first_child;
+  while (*p != NULL && *p != child) {
+    p = &(*p)->next_sibling;
+  }
+  if (*p == child) {
+    *p = child->next_sibling;
+  }
+  child->parent = NULL;
+  child->next_sibling = NULL;
+  needs_redraw = true;
+}
+
+void layer_destroy(Layer *layer) {
+  if (layer == NULL) {
+    return;
+  }
+  layer_remove_from_parent(layer);
+  while (layer->first_child != NULL) {
+    layer_remove_from_parent(layer->first_child);
+  }
+  host_heap_free(layer->data);
+  host_heap_free(layer);
+}
+
+void layer_mark_dirty(Layer *layer) {
+  needs_redraw = true;
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+  layer->update_proc = update_proc;
+}
+
+void layer_set_frame(Layer *layer, GRect frame) {
+  layer->frame = frame;
+  layer->bounds.size = frame.size;
+  needs_redraw = true;
+}
+
+GRect layer_get_frame(const Layer *layer) {
+  return layer->frame;
+}
+
+void layer_set_bounds(Layer *layer, GRect bounds) {
+  layer->bounds = bounds;
+  needs_redraw = true;
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+  return layer->bounds;
+}
+
+// The number of rows at the bottom of the screen covered by a
+// timeline peek; see host_set_obstructed_rows().
+static int obstructed_rows = 0;
+
+GRect layer_get_unobstructed_bounds(const Layer *layer) {
+  // Find where the layer's drawing coordinates fall on the screen,
+  // as render_layer() does, and clip its bounds to the uncovered part
+  // of the screen.
+  GPoint origin = layer->frame.origin;
+  for (const Layer *parent = layer->parent; parent != NULL; parent = parent->parent) {
+    origin.x += parent->frame.origin.x + parent->bounds.origin.x;
+    origin.y += parent->frame.origin.y + parent->bounds.origin.y;
+  }
+  GRect unobstructed = GRect(-origin.x, -origin.y, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT - obstructed_rows);
+  return grect_intersect(layer->bounds, unobstructed);
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+  layer_remove_from_parent(child);
+  child->parent = parent;
+  Layer **p = &parent->first_child;
+  while (*p != NULL) {
+    p = &(*p)->next_sibling;
+  }
+  *p = child;
+  needs_redraw = true;
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+  layer->hidden = hidden;
+  needs_redraw = true;
+}
+
+void *layer_get_data(const Layer *layer) {
+  return layer->data;
+}
+
+struct TextLayer {
+  Layer *layer;
+  const char *text;
+  GFont font;
+  GColor text_color;
+  GColor background_color;
+  GTextAlignment alignment;
+  GTextOverflowMode overflow_mode;
+};
+
+static void text_layer_update_proc(Layer *layer, GContext *ctx) {
+  TextLayer *text_layer = *(TextLayer **)layer->data;
+  if (text_layer->background_color.a != 0) {
+    graphics_context_set_fill_color(ctx, text_layer->background_color);
+    graphics_fill_rect(ctx, layer->bounds, 0, GCornerNone);
+  }
+  graphics_context_set_text_color(ctx, text_layer->text_color);
+  graphics_draw_text(ctx, text_layer->text, text_layer->font, layer->bounds,
+                     text_layer->overflow_mode, text_layer->alignment, NULL);
+}
+
+TextLayer *text_layer_create(GRect frame) {
+  TextLayer *text_layer = (TextLayer *)host_heap_calloc(1, sizeof(TextLayer));
+  if (text_layer == NULL) {
+    return NULL;
+  }
+  text_layer->layer = layer_create_with_data(frame, sizeof(TextLayer *));
+  if (text_layer->layer == NULL) {
+    host_heap_free(text_layer);
+    return NULL;
+  }
+  *(TextLayer **)text_layer->layer->data = text_layer;
+  layer_set_update_proc(text_layer->layer, text_layer_update_proc);
+  text_layer->font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+  text_layer->text_color = GColorBlack;
+  text_layer->background_color = GColorWhite;
+  return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer) {
+  if (text_layer == NULL) {
+    return;
+  }
+  layer_destroy(text_layer->layer);
+  host_heap_free(text_layer);
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer) {
+  return text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text) {
+  text_layer->text = text;
+  needs_redraw = true;
+}
+
+void text_layer_set_font(TextLayer *text_layer, GFont font) {
+  text_layer->font = font;
+}
+
+void text_layer_set_text_color(TextLayer *text_layer, GColor color) {
+  text_layer->text_color = color;
+}
+
+void text_layer_set_background_color(TextLayer *text_layer, GColor color) {
+  text_layer->background_color = color;
+}
+
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment) {
+  text_layer->alignment = text_alignment;
+}
+
+void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode line_mode) {
+  text_layer->overflow_mode = line_mode;
+}
+
+struct StatusBarLayer {
+  Layer *layer;
+};
+
+static void status_bar_layer_update_proc(Layer *layer, GContext *ctx) {
+  graphics_context_set_fill_color(ctx, GColorBlack);
+  graphics_fill_rect(ctx, layer->bounds, 0, GCornerNone);
+}
+
+StatusBarLayer *status_bar_layer_create(void) {
+  StatusBarLayer *status_bar_layer = (StatusBarLayer *)host_heap_calloc(1, sizeof(StatusBarLayer));
+  if (status_bar_layer == NULL) {
+    return NULL;
+  }
+  status_bar_layer->layer = layer_create(GRect(0, 0, PBL_DISPLAY_WIDTH, STATUS_BAR_LAYER_HEIGHT));
+  if (status_bar_layer->layer == NULL) {
+    host_heap_free(status_bar_layer);
+    return NULL;
+  }
+  layer_set_update_proc(status_bar_layer->layer, status_bar_layer_update_proc);
+  return status_bar_layer;
+}
+
+void status_bar_layer_destroy(StatusBarLayer *status_bar_layer) {
+  if (status_bar_layer == NULL) {
+    return;
+  }
+  layer_destroy(status_bar_layer->layer);
+  host_heap_free(status_bar_layer);
+}
+
+Layer *status_bar_layer_get_layer(StatusBarLayer *status_bar_layer) {
+  return status_bar_layer->layer;
+}
+
+Window *window_create(void) {
+  Window *window = (Window *)host_heap_calloc(1, sizeof(Window));
+  if (window == NULL) {
+    return NULL;
+  }
+  window->root_layer = layer_create(GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT));
+  if (window->root_layer == NULL) {
+    host_heap_free(window);
+    return NULL;
+  }
+  window->root_layer->window = window;
+  window->background_color = GColorWhite;
+  return window;
+}
+
+void window_destroy(Window *window) {
+  if (window == NULL) {
+    return;
+  }
+  window_stack_remove(window, false);
+  layer_destroy(window->root_layer);
+  host_heap_free(window);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+  window->handlers = handlers;
+}
+
+// Click handlers are recorded but never fired; the simulated watch
+// has no buttons.
+static Window *click_config_window = NULL;
+
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider) {
+  window_set_click_config_provider_with_context(window, click_config_provider, window);
+}
+
+void window_set_click_config_provider_with_context(Window *window, ClickConfigProvider click_config_provider, void *context) {
+  window->click_config_provider = click_config_provider;
+  window->click_config_context = context;
+}
+
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler) {
+}
+
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler, ClickHandler up_handler) {
+}
+
+void window_set_background_color(Window *window, GColor background_color) {
+  window->background_color = background_color;
+  needs_redraw = true;
+}
+
+Layer *window_get_root_layer(const Window *window) {
+  return window->root_layer;
+}
+
+Window *window_stack_get_top_window(void) {
+  return window_stack_size > 0 ? window_stack[window_stack_size - 1] : NULL;
+}
+
+void window_stack_push(Window *window, bool animated) {
+  if (window_stack_size >= MAX_WINDOW_STACK) {
+    host_fatal("window stack overflow");
+  }
+  Window *prev = window_stack_get_top_window();
+  if (prev != NULL && prev->handlers.disappear != NULL) {
+    prev->handlers.disappear(prev);
+  }
+
+  window_stack[window_stack_size++] = window;
+  window->on_stack = true;
+  if (!window->loaded) {
+    window->loaded = true;
+    if (window->handlers.load != NULL) {
+      window->handlers.load(window);
+    }
+  }
+  if (window->click_config_provider != NULL) {
+    click_config_window = window;
+    window->click_config_provider(window->click_config_context);
+  }
+  if (window->handlers.appear != NULL) {
+    window->handlers.appear(window);
+  }
+  needs_redraw = true;
+}
+
+bool window_stack_remove(Window *window, bool animated) {
+  for (int i = 0; i < window_stack_size; ++i) {
+    if (window_stack[i] == window) {
+      bool was_top = (i == window_stack_size - 1);
+      memmove(&window_stack[i], &window_stack[i + 1], (window_stack_size - i - 1) * sizeof(Window *));
+      --window_stack_size;
+      window->on_stack = false;
+      if (was_top && window->handlers.disappear != NULL) {
+        window->handlers.disappear(window);
+      }
+      if (window->loaded) {
+        window->loaded = false;
+        if (window->handlers.unload != NULL) {
+          window->handlers.unload(window);
+        }
+      }
+      Window *top = window_stack_get_top_window();
+      if (was_top && top != NULL && top->handlers.appear != NULL) {
+        top->handlers.appear(top);
+      }
+      needs_redraw = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+Window *window_stack_pop(bool animated) {
+  Window *top = window_stack_get_top_window();
+  if (top != NULL) {
+    window_stack_remove(top, animated);
+  }
+  return top;
+}
+
+void window_stack_pop_all(const bool animated) {
+  while (window_stack_size > 0) {
+    window_stack_pop(animated);
+  }
+}
+
+static UnobstructedAreaHandlers unobstructed_area_handlers;
+static void *unobstructed_area_context = NULL;
+
+void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void *context) {
+  unobstructed_area_handlers = handlers;
+  unobstructed_area_context = context;
+}
+
+void unobstructed_area_service_unsubscribe(void) {
+  memset(&unobstructed_area_handlers, 0, sizeof(unobstructed_area_handlers));
+  unobstructed_area_context = NULL;
+}
+
+void host_set_obstructed_rows(int rows) {
+  obstructed_rows = rows;
+
+  // The watch animates the change; here it happens in one step.
+  GRect area = GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT - rows);
+  if (unobstructed_area_handlers.will_change != NULL) {
+    unobstructed_area_handlers.will_change(area, unobstructed_area_context);
+  }
+  if (unobstructed_area_handlers.change != NULL) {
+    unobstructed_area_handlers.change(ANIMATION_NORMALIZED_MAX, unobstructed_area_context);
+  }
+  if (unobstructed_area_handlers.did_change != NULL) {
+    unobstructed_area_handlers.did_change(unobstructed_area_context);
+  }
+}
+
+// Rendering.
+
+static void render_layer(Layer *layer, GContext *ctx, GPoint parent_origin, GRect parent_clip) {
+  if (layer->hidden) {
+    return;
+  }
+  GPoint origin = GPoint(parent_origin.x + layer->frame.origin.x,
+                         parent_origin.y + layer->frame.origin.y);
+  GRect frame = GRect(origin.x, origin.y, layer->frame.size.w, layer->frame.size.h);
+  GRect clip = grect_intersect(parent_clip, frame);
+
+  // Drawing coordinates are relative to the layer's bounds.
+  GPoint bounds_origin = GPoint(origin.x + layer->bounds.origin.x,
+                                origin.y + layer->bounds.origin.y);
+  if (layer->update_proc != NULL) {
+    ctx->offset = bounds_origin;
+    ctx->clip = clip;
+    ctx->comp_op = GCompOpAssign;
+    ctx->fill_color = GColorBlack;
+    ctx->stroke_color = GColorBlack;
+    ctx->text_color = GColorBlack;
+
+    uint64_t start = host_clock_ns();
+    layer->update_proc(layer, ctx);
+    uint64_t elapsed = host_clock_ns() - start;
+    if (layer_timing_callback != NULL) {
+      layer_timing_callback(layer, layer->update_proc, elapsed);
+    }
+    if (ctx->fb_captured) {
+      host_fatal("framebuffer still captured after layer update");
+    }
+  }
+
+  for (Layer *child = layer->first_child; child != NULL; child = child->next_sibling) {
+    render_layer(child, ctx, bounds_origin, clip);
+  }
+}
+
+void host_redraw(void) {
+  Window *window = window_stack_get_top_window();
+  needs_redraw = false;
+  if (window == NULL) {
+    return;
+  }
+
+  GContext *ctx = &graphics_context;
+  ctx->fb = get_frame_buffer();
+  ctx->fb_captured = false;
+
+  // The system clears the window to its background color first.
+  ctx->offset = GPointZero;
+  ctx->clip = ctx->fb->bounds;
+  fill_screen_rect(ctx, ctx->fb->bounds, window->background_color);
+
+  render_layer(window->root_layer, ctx, GPointZero, ctx->fb->bounds);
+  ++stats.frames;
+}
+
+// Simulated time and the event loop.
+
+static uint64_t now_ms = 0;
+static bool start_time_set = false;
+
+void host_set_start_time(time_t start_time) {
+  now_ms = (uint64_t)start_time * 1000;
+  start_time_set = true;
+}
+
+uint64_t host_now_ms(void) {
+  if (!start_time_set) {
+    // By default, start the simulation at a fixed, repeatable moment:
+    // 2017-06-15 10:09:30 UTC.
+    host_set_start_time(1497521370);
+  }
+  return now_ms;
+}
+
+time_t host_time(time_t *tloc) {
+  time_t t = (time_t)(host_now_ms() / 1000);
+  if (tloc != NULL) {
+    *tloc = t;
+  }
+  return t;
+}
+
+uint16_t time_ms(time_t *t_utc, uint16_t *out_ms) {
+  uint64_t ms = host_now_ms();
+  if (t_utc != NULL) {
+    *t_utc = (time_t)(ms / 1000);
+  }
+  if (out_ms != NULL) {
+    *out_ms = (uint16_t)(ms % 1000);
+  }
+  return (uint16_t)(ms % 1000);
+}
+
+bool clock_is_24h_style(void) {
+  return false;
+}
+
+static TimeUnits tick_units = 0;
+static TickHandler tick_handler = NULL;
+static uint64_t last_tick_ms = 0;
+
+void tick_timer_service_subscribe(TimeUnits tick_units_in, TickHandler handler) {
+  tick_units = tick_units_in;
+  tick_handler = handler;
+  last_tick_ms = host_now_ms();
+}
+
+void tick_timer_service_unsubscribe(void) {
+  tick_units = 0;
+  tick_handler = NULL;
+}
+
+struct AppTimer {
+  uint64_t fire_ms;
+  AppTimerCallback callback;
+  void *data;
+  struct AppTimer *next;
+};
+
+static AppTimer *timers = NULL;
+
+static void timer_insert(AppTimer *timer) {
+  AppTimer **p = &timers;
+  while (*p != NULL && (*p)->fire_ms <= timer->fire_ms) {
+    p = &(*p)->next;
+  }
+  timer->next = *p;
+  *p = timer;
+}
+
+static bool timer_unlink(AppTimer *timer) {
+  for (AppTimer **p = &timers; *p != NULL; p = &(*p)->next) {
+    if (*p == timer) {
+      *p = timer->next;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Timers live in system memory on the watch, so they are allocated
+// outside the simulated heap.
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+  AppTimer *timer = (AppTimer *)calloc(1, sizeof(AppTimer));
+  timer->fire_ms = host_now_ms() + timeout_ms;
+  timer->callback = callback;
+  timer->data = callback_data;
+  timer_insert(timer);
+  return timer;
+}
+
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms) {
+  if (!timer_unlink(timer)) {
+    return false;
+  }
+  timer->fire_ms = host_now_ms() + new_timeout_ms;
+  timer_insert(timer);
+  return true;
+}
+
+void app_timer_cancel(AppTimer *timer) {
+  if (timer != NULL && timer_unlink(timer)) {
+    free(timer);
+  }
+}
+
+// Focus, battery, connection, and the other system services.
+
+static AppFocusHandlers focus_handlers;
+static bool focus_pending = false;
+
+void app_focus_service_subscribe_handlers(AppFocusHandlers handlers) {
+  focus_handlers = handlers;
+  focus_pending = true;
+}
+
+void app_focus_service_unsubscribe(void) {
+  memset(&focus_handlers, 0, sizeof(focus_handlers));
+  focus_pending = false;
+}
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {
+}
+
+void battery_state_service_unsubscribe(void) {
+}
+
+BatteryChargeState battery_state_service_peek(void) {
+  BatteryChargeState state;
+  state.charge_percent = 70;
+  state.is_charging = false;
+  state.is_plugged = false;
+  return state;
+}
+
+void bluetooth_connection_service_subscribe(BluetoothConnectionHandler handler) {
+}
+
+void bluetooth_connection_service_unsubscribe(void) {
+}
+
+bool bluetooth_connection_service_peek(void) {
+  return true;
+}
+
+bool quiet_time_is_active(void) {
+  return false;
+}
+
+void accel_tap_service_subscribe(AccelTapHandler handler) {
+}
+
+void accel_tap_service_unsubscribe(void) {
+}
+
+void vibes_short_pulse(void) {
+  ++stats.vibes;
+}
+
+void vibes_long_pulse(void) {
+  ++stats.vibes;
+}
+
+void vibes_double_pulse(void) {
+  ++stats.vibes;
+}
+
+void vibes_enqueue_custom_pattern(VibePattern pattern) {
+  ++stats.vibes;
+}
+
+void vibes_cancel(void) {
+}
+
+// Persistent storage, held in memory for the life of the process.
+
+#define MAX_PERSIST_KEYS 16
+static struct {
+  uint32_t key;
+  size_t size;
+  uint8_t data[256];
+} persist_table[MAX_PERSIST_KEYS];
+static int num_persist_keys = 0;
+
+static int persist_find(uint32_t key) {
+  for (int i = 0; i < num_persist_keys; ++i) {
+    if (persist_table[i].key == key) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size) {
+  int i = persist_find(key);
+  if (i < 0) {
+    return -1;
+  }
+  size_t size = persist_table[i].size < buffer_size ? persist_table[i].size : buffer_size;
+  memcpy(buffer, persist_table[i].data, size);
+  return (int)size;
+}
+
+int persist_write_data(const uint32_t key, const void *data, const size_t size) {
+  int i = persist_find(key);
+  if (i < 0) {
+    if (num_persist_keys >= MAX_PERSIST_KEYS) {
+      return -1;
+    }
+    i = num_persist_keys++;
+    persist_table[i].key = key;
+  }
+  size_t stored = size < sizeof(persist_table[i].data) ? size : sizeof(persist_table[i].data);
+  memcpy(persist_table[i].data, data, stored);
+  persist_table[i].size = stored;
+  return (int)stored;
+}
+
+bool persist_exists(const uint32_t key) {
+  return persist_find(key) >= 0;
+}
+
+int persist_delete(const uint32_t key) {
+  int i = persist_find(key);
+  if (i >= 0) {
+    persist_table[i] = persist_table[--num_persist_keys];
+  }
+  return 0;
+}
+
+// Health.  The metrics are synthesized from the simulated time of
+// day, so they change steadily over a run; a HealthEventMovementUpdate
+// is delivered once per simulated minute, as the watch does while the
+// wearer is walking.
+
+static HealthEventHandler health_handler = NULL;
+static void *health_context = NULL;
+static uint64_t last_health_ms = 0;
+
+bool health_service_events_subscribe(HealthEventHandler handler, void *context) {
+  health_handler = handler;
+  health_context = context;
+  last_health_ms = host_now_ms();
+  return true;
+}
+
+bool health_service_events_unsubscribe(void) {
+  health_handler = NULL;
+  health_context = NULL;
+  return true;
+}
+
+// Returns the time of the next movement update, strictly after
+// last_health_ms.
+static uint64_t next_health_ms(void) {
+  return (last_health_ms / 60000 + 1) * 60000;
+}
+
+static int seconds_today(void) {
+  return (int)((host_now_ms() / 1000) % SECONDS_PER_DAY);
+}
+
+HealthValue health_service_sum_today(HealthMetric metric) {
+  int s = seconds_today();
+  switch (metric) {
+  case HealthMetricStepCount:
+    return s / 8;
+  case HealthMetricActiveSeconds:
+    return s / 20;
+  case HealthMetricWalkedDistanceMeters:
+    return s / 12;
+  case HealthMetricSleepSeconds:
+    return 7 * SECONDS_PER_HOUR;
+  case HealthMetricSleepRestfulSeconds:
+    return 2 * SECONDS_PER_HOUR;
+  case HealthMetricRestingKCalories:
+    return s / 60;
+  case HealthMetricActiveKCalories:
+    return s / 300;
+  default:
+    return 0;
+  }
+}
+
+HealthValue health_service_peek_current_value(HealthMetric metric) {
+  if (metric == HealthMetricHeartRateBPM || metric == HealthMetricHeartRateRawBPM) {
+    return 60 + seconds_today() % 40;
+  }
+  return health_service_sum_today(metric);
+}
+
+MeasurementSystem health_service_get_measurement_system_for_display(HealthMetric metric) {
+  return MeasurementSystemMetric;
+}
+
+// AppMessage.
+
+static AppMessageInboxReceived inbox_received = NULL;
+static AppMessageInboxDropped inbox_dropped = NULL;
+
+struct QueuedMessage {
+  uint64_t deliver_ms;
+  DictionaryIterator iter;
+  struct QueuedMessage *next;
+};
+
+static struct QueuedMessage *message_queue = NULL;
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key) {
+  for (int i = 0; i < iter->num_tuples; ++i) {
+    if (iter->tuples[i].tuple.key == key) {
+      return (Tuple *)&iter->tuples[i].tuple;
+    }
+  }
+  return NULL;
+}
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound) {
+  return APP_MSG_OK;
+}
+
+uint32_t app_message_inbox_size_maximum(void) {
+  return 8200;
+}
+
+uint32_t app_message_outbox_size_maximum(void) {
+  return 8200;
+}
+
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback) {
+  AppMessageInboxReceived prev = inbox_received;
+  inbox_received = received_callback;
+  return prev;
+}
+
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback) {
+  AppMessageInboxDropped prev = inbox_dropped;
+  inbox_dropped = dropped_callback;
+  return prev;
+}
+
+void host_queue_app_message(uint32_t delay_ms, const uint32_t keys[], const int32_t values[], int num_tuples) {
+  struct QueuedMessage *message = (struct QueuedMessage *)calloc(1, sizeof(struct QueuedMessage));
+  message->deliver_ms = host_now_ms() + delay_ms;
+  if (num_tuples > (int)ARRAY_LENGTH(message->iter.tuples)) {
+    host_fatal("too many tuples in message");
+  }
+  message->iter.num_tuples = num_tuples;
+  for (int i = 0; i < num_tuples; ++i) {
+    message->iter.tuples[i].tuple.key = keys[i];
+    message->iter.tuples[i].tuple.type = TUPLE_INT;
+    message->iter.tuples[i].tuple.length = sizeof(int32_t);
+    message->iter.tuples[i].int32 = values[i];
+  }
+
+  struct QueuedMessage **p = &message_queue;
+  while (*p != NULL && (*p)->deliver_ms <= message->deliver_ms) {
+    p = &(*p)->next;
+  }
+  message->next = *p;
+  *p = message;
+}
+
+// The names accepted by host_config_add().
+#define CONFIG_KEY(name) { #name, CK_##name }
+static const struct {
+  const char *name;
+  uint32_t key;
+} config_keys[] = {
+  CONFIG_KEY(battery_gauge),
+  CONFIG_KEY(bluetooth_indicator),
+  CONFIG_KEY(second_hand),
+  CONFIG_KEY(hour_buzzer),
+  CONFIG_KEY(draw_mode),
+  CONFIG_KEY(chrono_dial),
+  CONFIG_KEY(sweep_seconds),
+  CONFIG_KEY(display_lang),
+  CONFIG_KEY(face_index),
+  CONFIG_KEY(date_window_a),
+  CONFIG_KEY(date_window_b),
+  CONFIG_KEY(date_window_c),
+  CONFIG_KEY(date_window_d),
+  CONFIG_KEY(bluetooth_buzzer),
+  CONFIG_KEY(lunar_background),
+  CONFIG_KEY(lunar_direction),
+  CONFIG_KEY(color_mode),
+  CONFIG_KEY(top_subdial),
+  CONFIG_KEY(show_debug),
+  CONFIG_KEY(week_numbering),
+};
+#undef CONFIG_KEY
+
+void host_config_set(struct HostConfig *config, uint32_t key, int32_t value) {
+  for (int i = 0; i < config->num_tuples; ++i) {
+    if (config->keys[i] == key) {
+      config->values[i] = value;
+      return;
+    }
+  }
+  if (config->num_tuples >= HOST_MAX_CONFIG_TUPLES) {
+    host_fatal("too many config settings");
+  }
+  config->keys[config->num_tuples] = key;
+  config->values[config->num_tuples] = value;
+  ++config->num_tuples;
+}
+
+void host_config_add(struct HostConfig *config, const char *arg) {
+  const char *eq = strchr(arg, '=');
+  if (eq == NULL) {
+    fprintf(stderr, "-k expects name=value, not %s\n", arg);
+    exit(1);
+  }
+  size_t len = eq - arg;
+  for (size_t i = 0; i < ARRAY_LENGTH(config_keys); ++i) {
+    if (strlen(config_keys[i].name) == len && strncmp(config_keys[i].name, arg, len) == 0) {
+      host_config_set(config, config_keys[i].key, atoi(eq + 1));
+      return;
+    }
+  }
+  fprintf(stderr, "unknown config key in %s\n", arg);
+  exit(1);
+}
+
+void host_queue_config(uint32_t delay_ms, const struct HostConfig *config) {
+  if (config->num_tuples != 0) {
+    host_queue_app_message(delay_ms, config->keys, config->values, config->num_tuples);
+  }
+}
+
+// Returns the time of the next tick the subscribed units call for,
+// strictly after last_tick_ms.
+static uint64_t next_tick_ms(void) {
+  uint64_t period = (tick_units & SECOND_UNIT) ? 1000 : 60000;
+  return (last_tick_ms / period + 1) * period;
+}
+
+static TimeUnits units_changed_between(time_t before, time_t after) {
+  struct tm b = *localtime(&before);
+  struct tm a = *localtime(&after);
+  TimeUnits units = 0;
+  if (a.tm_sec != b.tm_sec) units |= SECOND_UNIT;
+  if (a.tm_min != b.tm_min) units |= MINUTE_UNIT;
+  if (a.tm_hour != b.tm_hour) units |= HOUR_UNIT;
+  if (a.tm_mday != b.tm_mday) units |= DAY_UNIT;
+  if (a.tm_mon != b.tm_mon) units |= MONTH_UNIT;
+  if (a.tm_year != b.tm_year) units |= YEAR_UNIT;
+  return units;
+}
+
+void host_run_for(uint64_t duration_ms) {
+  uint64_t end_ms = host_now_ms() + duration_ms;
+
+  if (focus_pending) {
+    focus_pending = false;
+    if (focus_handlers.did_focus != NULL) {
+      focus_handlers.did_focus(true);
+    }
+  }
+  if (needs_redraw) {
+    host_redraw();
+  }
+
+  while (true) {
+    // Find the earliest pending event.
+    uint64_t next_ms = end_ms + 1;
+    if (tick_handler != NULL) {
+      next_ms = next_tick_ms();
+    }
+    if (timers != NULL && timers->fire_ms < next_ms) {
+      next_ms = timers->fire_ms;
+    }
+    if (message_queue != NULL && message_queue->deliver_ms < next_ms) {
+      next_ms = message_queue->deliver_ms;
+    }
+    if (health_handler != NULL && next_health_ms() < next_ms) {
+      next_ms = next_health_ms();
+    }
+    if (next_ms > end_ms) {
+      break;
+    }
+    if (next_ms > now_ms) {
+      now_ms = next_ms;
+    }
+
+    if (message_queue != NULL && message_queue->deliver_ms <= now_ms) {
+      struct QueuedMessage *message = message_queue;
+      message_queue = message->next;
+      ++stats.messages;
+      if (inbox_received != NULL) {
+        inbox_received(&message->iter, NULL);
+      }
+      free(message);
+
+    } else if (timers != NULL && timers->fire_ms <= now_ms) {
+      AppTimer *timer = timers;
+      timers = timer->next;
+      AppTimerCallback callback = timer->callback;
+      void *data = timer->data;
+      free(timer);
+      ++stats.timers;
+      callback(data);
+
+    } else if (tick_handler != NULL && next_tick_ms() <= now_ms) {
+      time_t before = (time_t)(last_tick_ms / 1000);
+      time_t after = (time_t)(now_ms / 1000);
+      last_tick_ms = now_ms;
+      TimeUnits units = units_changed_between(before, after);
+      struct tm tick_time = *localtime(&after);
+      ++stats.ticks;
+      tick_handler(&tick_time, units);
+
+    } else if (health_handler != NULL && next_health_ms() <= now_ms) {
+      last_health_ms = now_ms;
+      ++stats.health_events;
+      health_handler(HealthEventMovementUpdate, health_context);
+    }
+
+    if (needs_redraw) {
+      host_redraw();
+    }
+  }
+
+  now_ms = end_ms;
+}
+
+void app_event_loop(void) {
+  // Without a driver to say otherwise, run for one simulated minute.
+  host_run_for(60 * 1000);
+}
@@ -0,0 +1,134 @@
+#ifndef PEBBLE_HOST_H
+#define PEBBLE_HOST_H
+
+// Host-only controls for the pebble.h stand-in: these are the knobs a
+// benchmark driver uses to configure the simulated watch, run its
+// event loop, and read back what happened.  Nothing in src/ should
+// include this file.
+
+#include <pebble.h>
+
+// One entry of the resource table generated by make_resource_ids.py
+// from package.json.  The resource ID is the index into the table
+// plus one.
+struct HostResource {
+  const char *name;
+  const char *file;   // relative to the resources directory
+  const char *type;   // "raw", "bitmap", or "font"
+};
+
+extern const struct HostResource host_resource_table[];
+extern const int host_num_resources;
+
+// Adds a resource that isn't in the generated table, and returns its
+// resource ID.  A filename that isn't absolute is relative to the
+// resources directory.
+uint32_t host_add_resource_file(const char *name, const char *filename, const char *type);
+
+// Returns the number of resources, which are numbered from 1, and
+// the description of any of them.
+uint32_t host_get_num_resources(void);
+const struct HostResource *host_get_resource(uint32_t resource_id);
+
+// Counters accumulated by the stand-in since the last
+// host_reset_stats().
+struct HostStats {
+  // Simulated heap.
+  size_t heap_limit;
+  size_t heap_used;
+  size_t heap_peak;
+  unsigned int heap_allocs;
+  unsigned int heap_frees;
+  unsigned int heap_failures;
+
+  // Resource access.
+  unsigned int resource_handles;
+  unsigned int resource_loads;
+  size_t resource_bytes;
+
+  // Event loop.
+  unsigned int ticks;
+  unsigned int timers;
+  unsigned int messages;
+  unsigned int health_events;
+  unsigned int frames;
+
+  // Drawing and other work that costs battery.
+  uint64_t pixels_blitted;  // by graphics_draw_bitmap_in_rect()
+  unsigned int texts_drawn;  // by graphics_draw_text()
+  unsigned int vibes;
+};
+
+// Called once for each layer update proc invoked during a redraw,
+// with the wall time spent in the proc.
+typedef void (*HostLayerTimingCallback)(Layer *layer, LayerUpdateProc update_proc, uint64_t elapsed_ns);
+
+const char *host_platform_name(void);
+
+// The heap ceiling defaults to the app RAM available on the selected
+// platform; it may be changed any time before the first allocation.
+size_t host_default_heap_limit(void);
+void host_set_heap_limit(size_t heap_limit);
+
+// Starts writing a line to trace for every allocation, failed
+// allocation, and free from now on, for heap_sim to replay; or stops,
+// if trace is NULL.  See heap_sim.c for the format.
+void host_set_heap_trace(FILE *trace);
+
+// The directory that holds the generated resources (normally the
+// resources directory at the top of the tree).
+void host_set_resource_dir(const char *resource_dir);
+
+// Sets the simulated wall clock, in seconds since the epoch.
+void host_set_start_time(time_t start_time);
+uint64_t host_now_ms(void);
+
+void host_set_verbose(bool verbose);
+
+// Covers the bottom rows of the screen, as a timeline peek does (0
+// uncovers it), and calls the unobstructed area handlers, if any.
+void host_set_obstructed_rows(int rows);
+void host_set_layer_timing_callback(HostLayerTimingCallback callback);
+
+// Queues an integer-valued AppMessage for delivery delay_ms into the
+// next host_run_for().
+void host_queue_app_message(uint32_t delay_ms, const uint32_t keys[], const int32_t values[], int num_tuples);
+
+// A set of config settings (see config_options.h) to deliver in one
+// AppMessage, as the phone's configuration page would.
+#define HOST_MAX_CONFIG_TUPLES 32
+struct HostConfig {
+  uint32_t keys[HOST_MAX_CONFIG_TUPLES];
+  int32_t values[HOST_MAX_CONFIG_TUPLES];
+  int num_tuples;
+};
+
+// Sets the indicated key, replacing any value it already holds.
+void host_config_set(struct HostConfig *config, uint32_t key, int32_t value);
+
+// Parses a name=value option (the name of one of the CK_* keys,
+// without the prefix) into config, or exits with a message.
+void host_config_add(struct HostConfig *config, const char *arg);
+
+// Queues the settings for delivery delay_ms into the next
+// host_run_for(), if there are any.
+void host_queue_config(uint32_t delay_ms, const struct HostConfig *config);
+
+// Runs the event loop for the indicated number of simulated
+// milliseconds: ticks, timers, and queued messages are dispatched in
+// time order, and the window is redrawn after each event that marked
+// a layer dirty.
+void host_run_for(uint64_t duration_ms);
+
+// Immediately redraws the top window, whether or not it is dirty.
+void host_redraw(void);
+
+// Returns the framebuffer of the last redraw.
+GBitmap *host_get_frame_buffer(void);
+
+void host_get_stats(struct HostStats *stats);
+void host_reset_stats(void);
+
+uint64_t host_clock_ns(void);
+
+#endif  // PEBBLE_HOST_H
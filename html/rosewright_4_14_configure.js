@@ -169,6 +169,13 @@ if ($.url().param("show_debug")) {
     date_window_options.push([202, "(dev) memory panic count"]);
     date_window_options.push([203, "(dev) resource reads"]);
     date_window_options.push([204, "(dev) draw face count"]);
+    date_window_options.push([205, "(dev) resource load calls"]);
+    date_window_options.push([206, "(dev) resource load bytes"]);
+    date_window_options.push([207, "(dev) resource bytes reread"]);
+    date_window_options.push([208, "(dev) rle cache hit rate"]);
+    date_window_options.push([209, "(dev) last frame ms"]);
+    date_window_options.push([210, "(dev) max frame ms"]);
+    date_window_options.push([211, "(dev) decode ms per frame"]);
 }
 
 var top_subdial_options = [
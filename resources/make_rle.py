@@ -35,8 +35,42 @@ Options:
 #         (uint8_t)  format (see below)
 #         (uint16_t) offset to end of rle data (and start of values data if present)
 #         (uint16_t) offset to end of values data (and start of palette data if present)
+#
+# If RLEFormatRowIndex is set in format, the header is followed by a
+# row index, which allows decoding to begin partway down the image:
+#         (uint8_t)  r (number of rows between index entries)
+#         (uint8_t)  k (number of index entries)
+#         k entries, for rows r, 2r, ... k * r, of 7 bytes each:
+#           (uint16_t) offset to the byte of rle data holding the run that contains the row's first pixel
+#           (uint8_t)  bit of that byte (counting from the high bit) at which the run begins;
+#                      0x80 is set if it is a run of 1's (1-bit formats only)
+#           (uint16_t) number of pixels of that run before the row's first pixel
+#           (uint16_t) index of that run's value in the values data (0 for 1-bit formats)
+# The rle data begins immediately after the row index.
+#
+# Images too large for the above header, or that use a codec other
+# than RLECodecRuns, are written with a v2 header instead:
+#         (uint8_t)  0 (a v1 header begins with the width, which is never 0)
+#         (uint8_t)  version (2)
+#         (uint8_t)  codec (see below)
+#         (uint8_t)  n (as above)
+#         (uint8_t)  format (as above)
+#         (uint8_t)  reserved (0)
+#         (uint16_t) width
+#         (uint16_t) height
+#         (uint32_t) offset to end of rle data (and start of values data if present)
+#         (uint32_t) offset to end of values data (and start of palette data if present)
+# followed by the row index, if any, as above.
 
 RLEHeaderSize = 8
+RLEHeaderSizeV2 = 18
+RLERowIndexEntrySize = 7
+RLEMaxRowIndexSize = 2 + 0xff * RLERowIndexEntrySize
+
+# Codec ids.  A v1 file always uses RLECodecRuns.
+RLECodecRuns = 0     # the runs of pixels are packed with chop_rle() and pack_rle()
+RLECodecXorRows = 1  # the same, but each row is first XORed with the row above
+RLECodecs = [RLECodecRuns, RLECodecXorRows]
 
 # Format codes (almost matches pebble.h):
 GBitmapFormat1Bit        = 0
@@ -45,6 +79,9 @@ GBitmapFormat1BitPalette = 2
 GBitmapFormat2BitPalette = 3
 GBitmapFormat4BitPalette = 4
 
+# Set in the format byte when a row index follows the header.
+RLEFormatRowIndex = 0x80
+
 
 thresholdMask = [0] + [255] * 255
 threshold2Bit = [0] * 64 + [85] * 64 + [170] * 64 + [255] * 64
@@ -228,6 +265,180 @@ def pack_rle(source, n):
 
     return result
 
+def xor_rows(pixels, rowWidth):
+    """ Returns a copy of pixels, a list of rows of rowWidth pixels
+    each, with every row but the first XORed with the row above it.
+    Where the image changes little from one row to the next, as the
+    concentric rings and ticks of a clock face do, this leaves mostly
+    0's, which make for long runs. """
+
+    result = pixels[:rowWidth]
+    for i in range(rowWidth, len(pixels)):
+        result.append(pixels[i] ^ pixels[i - rowWidth])
+    return result
+
+def unxor_rows(pixels, rowWidth):
+    """ Reverses xor_rows(). """
+
+    result = pixels[:rowWidth]
+    for i in range(rowWidth, len(pixels)):
+        result.append(pixels[i] ^ result[i - rowWidth])
+    return result
+
+def encode_rows(pixels, rowWidth, codec):
+    """ Applies the indicated codec's transform to the pixels, before
+    they are run-length encoded. """
+
+    if codec == RLECodecXorRows:
+        return xor_rows(pixels, rowWidth)
+    return pixels
+
+def rle_header_size(width, height, codec, dataSize):
+    """ Returns the size of the header we'll write for an image: a v1
+    header if it can describe the image, since it's smaller, or a v2
+    header otherwise. """
+
+    if codec == RLECodecRuns and width <= 0xff and height <= 0xff and \
+       RLEHeaderSize + RLEMaxRowIndexSize + dataSize < 0x10000:
+        return RLEHeaderSize
+    return RLEHeaderSizeV2
+
+def pack_uint(value, size):
+    """ Returns value as a little-endian string of size bytes. """
+
+    assert value < (1 << (size * 8))
+    return ''.join(map(lambda i: chr((value >> (i * 8)) & 0xff), range(size)))
+
+def unpack_uint(data):
+    """ Reverses pack_uint(). """
+
+    value = 0
+    for i in range(len(data)):
+        value |= ord(data[i]) << (i * 8)
+    return value
+
+def write_rle_file(rleFilename, headerSize, width, height, n, format, codec, index, result, values_result, palette):
+    """ Writes the .rle file, with the header chosen by
+    rle_header_size(), and returns its size in bytes. """
+
+    vo = headerSize + len(index) + len(result)
+    po = vo + len(values_result)
+    if index:
+        format |= RLEFormatRowIndex
+
+    rle = open(rleFilename, 'wb')
+    if headerSize == RLEHeaderSize:
+        assert codec == RLECodecRuns
+        rle.write(chr(width) + chr(height) + chr(n) + chr(format))
+        rle.write(pack_uint(vo, 2) + pack_uint(po, 2))
+    else:
+        rle.write(chr(0) + chr(2) + chr(codec) + chr(n) + chr(format) + chr(0))
+        rle.write(pack_uint(width, 2) + pack_uint(height, 2))
+        rle.write(pack_uint(vo, 4) + pack_uint(po, 4))
+    assert rle.tell() == headerSize
+    rle.write(index)
+    rle.write(result)
+    assert rle.tell() == vo
+    rle.write(values_result)
+    assert rle.tell() == po
+    for pixel in palette:
+        rle.write(chr(pack_argb8(pixel)))
+
+    size = rle.tell()
+    rle.close()
+    return size
+
+def make_row_index(rle, n, rowWidth, height, oneBit, dataSize, headerSize):
+    """ Returns the row index string (see above) for the rle sequence,
+    which was packed with chop_rle() and pack_rle() into n-bit chunks,
+    and describes height rows of rowWidth pixels each.  If oneBit is
+    true, the sequence is of alternating 0's and 1's, beginning with
+    the implicit black pixel.  The index will follow a header of
+    headerSize bytes.
+
+    An index is only worth having if it is small compared to the
+    dataSize bytes that follow the header, so we try a couple of
+    spacings, and return the empty string if neither is cheap
+    enough. """
+
+    for rows in [8, 16]:
+        numEntries = (height - 1) / rows
+        if numEntries < 2 or numEntries > 0xff:
+            continue
+        indexSize = 2 + numEntries * RLERowIndexEntrySize
+        if indexSize * 16 > dataSize:
+            continue
+
+        # The rle data will begin after the index.
+        offset = headerSize + indexSize
+        if offset + dataSize >= 0x10000:
+            # The entries can't address that far.
+            break
+
+        entries = []
+        row = rows
+        target = row * rowWidth + oneBit
+        pos = 0
+        bitPos = 0
+        for ri in range(len(rle)):
+            v = rle[ri]
+            while row <= numEntries * rows and target < pos + v:
+                # This run contains the first pixel of row.
+                byte = offset + bitPos / 8
+                bit = bitPos % 8
+                valueIndex = ri
+                if oneBit:
+                    bit |= (ri & 1) << 7
+                    valueIndex = 0
+                assert byte < 0x10000 and valueIndex < 0x10000
+                entries.append((byte, bit, target - pos, valueIndex))
+                row += rows
+                target = row * rowWidth + oneBit
+
+            pos += v
+            numChunks = (count_bits(v) + n - 1) / n
+            bitPos += (numChunks * 2 - 1) * n
+
+        assert len(entries) == numEntries
+
+        index = chr(rows) + chr(numEntries)
+        for byte, bit, skip, valueIndex in entries:
+            index += chr(byte & 0xff) + chr(byte >> 8) + chr(bit)
+            index += chr(skip & 0xff) + chr(skip >> 8)
+            index += chr(valueIndex & 0xff) + chr(valueIndex >> 8)
+        assert len(index) == indexSize
+        return index
+
+    return ''
+
+def verify_row_index(index, result, rle, n, rowWidth, oneBit, headerSize):
+    """ Checks that each entry of the row index really does point to
+    the run that contains the first pixel of its row, by unpacking the
+    rle data from there. """
+
+    offset = headerSize + len(index)
+    rows = ord(index[0])
+    numEntries = ord(index[1])
+    for i in range(numEntries):
+        entry = map(ord, index[2 + i * RLERowIndexEntrySize : 2 + (i + 1) * RLERowIndexEntrySize])
+        byte = entry[0] | (entry[1] << 8)
+        bit = entry[2] & 0x7f
+        skip = entry[3] | (entry[4] << 8)
+        valueIndex = entry[5] | (entry[6] << 8)
+
+        unpacker = Rl2Unpacker(result, n, zero_expands = True)
+        unpacker.si = byte - offset
+        unpacker.bi = 8 - bit
+        tail = unpacker.getList()
+        ri = len(rle) - len(tail)
+        assert tail == rle[ri:]
+        assert sum(rle[:ri]) + skip == (i + 1) * rows * rowWidth + oneBit
+        assert skip < rle[ri]
+        if oneBit:
+            assert (entry[2] >> 7) == (ri & 1) and valueIndex == 0
+        else:
+            assert valueIndex == ri
+
 class Rl2Unpacker:
     """ This class reverses chop_rle() and pack_rle()--it reads a
     string and returns the original rle sequence of positive integers.
@@ -332,55 +543,49 @@ def make_rle_image_1bit(rleFilename, image):
         im2.paste(image, (0, 0))
         image = im2
 
-    assert w <= 0xff and h <= 0xff
     unscreened = unscreen(image)
 
-    # The number of bytes in a row.  Must be a multiple of 4, per
-    # Pebble conventions.
-    stride = ((w + 31) / 32) * 4
-    assert stride <= 0xff
-
-    rle_normal = list(generate_rle_1bit(generate_pixels_1bit(image, stride)))
-    rle_unscreened = list(generate_rle_1bit(generate_pixels_1bit(unscreened, stride)))
-
-    # Find the best n for this image.
-    result = None
-    n = None
-    for n0 in [1, 0x81, 2, 4, 8]:
-        rle = rle_normal
-        if n0 & 0x80:
-            rle = rle_unscreened
-        result0 = pack_rle(chop_rle(rle, n0 & 0x7f), n0 & 0x7f)
-        #print n0, len(result0)
-        if result is None or len(result0) < len(result):
-            result = result0
-            n = n0
-
-    vo = RLEHeaderSize + len(result)
-    assert(vo < 0x10000)
-    vo_lo = vo & 0xff
-    vo_hi = (vo >> 8) & 0xff
+    pixels_normal = list(generate_pixels_1bit(image, stride))
+    pixels_unscreened = list(generate_pixels_1bit(unscreened, stride))
+
+    # Find the best codec and n for this image.
+    best = None
+    for codec in RLECodecs:
+        rle_normal = list(generate_rle_1bit(iter(encode_rows(pixels_normal, w, codec))))
+        rle_unscreened = list(generate_rle_1bit(iter(encode_rows(pixels_unscreened, w, codec))))
+        for n0 in [1, 0x81, 2, 4, 8]:
+            rle0 = rle_normal
+            if n0 & 0x80:
+                rle0 = rle_unscreened
+            result0 = pack_rle(chop_rle(rle0, n0 & 0x7f), n0 & 0x7f)
+            size0 = rle_header_size(w_orig, h, codec, len(result0)) + len(result0)
+            #print codec, n0, size0
+            if best is None or size0 < best[0]:
+                best = (size0, codec, n0, rle0, result0)
+
+    size, codec, n, rle, result = best
 
     # Verify the result matches.
     unpacker = Rl2Unpacker(result, n & 0x7f, zero_expands = True)
     verify = unpacker.getList()
-    if n & 0x80:
-        assert verify == rle_unscreened
-        pixels = list(generate_pixels_1bit(unscreened, stride))
-    else:
-        assert verify == rle_normal
-        pixels = list(generate_pixels_1bit(image, stride))
+    assert verify == rle
 
     format = GBitmapFormat1Bit
+    headerSize = rle_header_size(w_orig, h, codec, len(result))
 
-    #print "n = %s, format = %s, vo = %s, po = %s" % (n, format, vo, vo)
+    # Add a row index, if it's worth it.  We can't begin partway
+    # through an image coded by rows, though.
+    index = ''
+    if codec == RLECodecRuns:
+        index = make_row_index(rle, n & 0x7f, w, h, 1, len(result), headerSize)
+        if index:
+            verify_row_index(index, result, rle, n & 0x7f, w, 1, headerSize)
 
-    rle = open(rleFilename, 'wb')
-    rle.write('%c%c%c%c%c%c%c%c' % (w_orig, h, n, format, vo_lo, vo_hi, vo_lo, vo_hi))
-    rle.write(result)
-    rle.close()
+    #print "n = %s, format = %s, codec = %s" % (n, format, codec)
+
+    size = write_rle_file(rleFilename, headerSize, w_orig, h, n, format, codec, index, result, '', [])
 
-    print '%s: %s, %s vs. %s' % (rleFilename, format, 8 + len(result), fullSize)
+    print '%s: %s, codec %s, %s vs. %s' % (rleFilename, format, codec, size, fullSize)
 
 def make_rle_image_basalt(rleFilename, image):
     image = image.convert('RGBA')
@@ -450,68 +655,61 @@ def make_rle_image_basalt(rleFilename, image):
 
     if palette is None:
         # Full-color image, no palette.
-        pixels = generate_pixels_8bit(image)
+        pixels = list(generate_pixels_8bit(image))
+        palette = []
     else:
         # Index into a palette.
-        pixels = generate_pixels_palette(image, palette)
+        pixels = list(generate_pixels_palette(image, palette))
+
+    # Find the best codec and n for this image.
+    best = None
+    for codec in RLECodecs:
+        coded = encode_rows(pixels, w, codec)
+        if vn == 1:
+            # With a 1-bit image, no need to record a values list.
+            values = []
+            rle = generate_rle_1bit(iter(coded))
+        else:
+            # With an n-bit image, the values list can't be inferred and
+            # must be explicitly stored.
+            values_rle = generate_rle_pairs(iter(coded))
+            values, rle = zip(*list(values_rle))
 
-    if vn == 1:
-        # With a 1-bit image, no need to record a values list.
-        values = []
-        rle = generate_rle_1bit(pixels)
-    else:
-        # With an n-bit image, the values list can't be inferred and
-        # must be explicitly stored.
-        values_rle = generate_rle_pairs(pixels)
-        values, rle = zip(*list(values_rle))
-
-    rle = list(rle)
-
-    # Find the best n for this image.
-    result = None
-    n = None
-    for n0 in [1, 2, 4, 8]:
-        im = image
-        result0 = pack_rle(chop_rle(rle, n0 & 0x7f), n0 & 0x7f)
-        #print n0, len(result0)
-        if result is None or len(result0) < len(result):
-            result = result0
-            n = n0
+        rle = list(rle)
+        values_result = pack_rle(values, vn)
+
+        for n0 in [1, 2, 4, 8]:
+            result0 = pack_rle(chop_rle(rle, n0 & 0x7f), n0 & 0x7f)
+            dataSize = len(result0) + len(values_result) + len(palette)
+            size0 = rle_header_size(w_orig, h, codec, dataSize) + dataSize
+            #print codec, n0, size0
+            if best is None or size0 < best[0]:
+                best = (size0, codec, n0, rle, result0, values_result)
+
+    size, codec, n, rle, result, values_result = best
 
     # Verify the result matches.
     unpacker = Rl2Unpacker(result, n & 0x7f, zero_expands = True)
     verify = unpacker.getList()
     assert verify == rle
 
-    # Get the offset into the file at which the values start.
-    vo = RLEHeaderSize + len(result)
-    assert(vo < 0x10000)
-    vo_lo = vo & 0xff
-    vo_hi = (vo >> 8) & 0xff
+    dataSize = len(result) + len(values_result) + len(palette)
+    headerSize = rle_header_size(w_orig, h, codec, dataSize)
 
-    values_result = pack_rle(values, vn)
+    # Add a row index, if it's worth it.  We can't begin partway
+    # through an image coded by rows, though.
+    index = ''
+    oneBit = int(vn == 1)
+    if codec == RLECodecRuns:
+        index = make_row_index(rle, n, w, h, oneBit, len(result) + len(values_result), headerSize)
+        if index:
+            verify_row_index(index, result, rle, n, w, oneBit, headerSize)
 
-    # Also get the offset into the file at which the palette starts.
-    po = vo + len(values_result)
-    assert(po < 0x10000)
-    po_lo = po & 0xff
-    po_hi = (po >> 8) & 0xff
+    #print "n = %s, format = %s, codec = %s" % (n, format, codec)
 
-    #print "n = %s, format = %s, vo = %s, po = %s" % (n, format, vo, po)
+    size = write_rle_file(rleFilename, headerSize, w_orig, h, n, format, codec, index, result, values_result, palette)
 
-    rle = open(rleFilename, 'wb')
-    rle.write('%c%c%c%c%c%c%c%c' % (w_orig, h, n, format, vo_lo, vo_hi, po_lo, po_hi))
-    rle.write(result)
-    assert rle.tell() == vo
-    rle.write(values_result)
-    if palette is not None:
-        assert rle.tell() == po
-        for pixel in palette:
-            rle.write(chr(pack_argb8(pixel)))
-
-    rle.close()
-
-    print '%s: %s, %s vs. %s' % (rleFilename, format, 8 + len(result) + len(values), fullSize)
+    print '%s: %s, codec %s, %s vs. %s' % (rleFilename, format, codec, size, fullSize)
 
 def make_rle_image(rleFilename, image, color = 'color'):
     if color == 'bw':
@@ -711,20 +909,40 @@ def make_rle_trans_file(filename, variant, name = None, prefix = 'resources/', u
 def unpack_rle_file(rleFilename):
     rb = open(rleFilename, 'rb')
     width = ord(rb.read(1))
-    height = ord(rb.read(1))
-    n = ord(rb.read(1))
-    format = ord(rb.read(1))
-    vo_lo = ord(rb.read(1))
-    vo_hi = ord(rb.read(1))
-    vo = (vo_hi << 8) | vo_lo
-    po_lo = ord(rb.read(1))
-    po_hi = ord(rb.read(1))
-    po = (po_hi << 8) | po_lo
+    codec = RLECodecRuns
+    if width != 0:
+        # A v1 header.
+        height = ord(rb.read(1))
+        n = ord(rb.read(1))
+        format = ord(rb.read(1))
+        vo = unpack_uint(rb.read(2))
+        po = unpack_uint(rb.read(2))
+        headerSize = RLEHeaderSize
+    else:
+        # A v2 header.
+        version = ord(rb.read(1))
+        assert version == 2
+        codec = ord(rb.read(1))
+        n = ord(rb.read(1))
+        format = ord(rb.read(1))
+        rb.read(1)
+        width = unpack_uint(rb.read(2))
+        height = unpack_uint(rb.read(2))
+        vo = unpack_uint(rb.read(4))
+        po = unpack_uint(rb.read(4))
+        headerSize = RLEHeaderSizeV2
 
     do_unscreen = ((n & 0x80) != 0)
     n = n & 0x7f
 
-    print "n = %s, format = %s, vo = %s, po = %s" % (n, format, vo, po)
+    # We don't need the row index to unpack the whole image; skip it.
+    index = ''
+    if format & RLEFormatRowIndex:
+        format &= ~RLEFormatRowIndex
+        index = rb.read(2)
+        index += rb.read(ord(index[1]) * RLERowIndexEntrySize)
+
+    print "n = %s, format = %s, codec = %s, vo = %s, po = %s" % (n, format, codec, vo, po)
 
     if (format == GBitmapFormat1Bit or format == GBitmapFormat1BitPalette):
         pixels_per_byte = 8
@@ -751,9 +969,9 @@ def unpack_rle_file(rleFilename):
     # Expand the width as needed to include the extra padding pixels.
     width2 = (stride * pixels_per_byte)
 
-    assert(RLEHeaderSize == rb.tell())
+    assert(headerSize + len(index) == rb.tell())
 
-    rle_data = rb.read(vo - RLEHeaderSize)
+    rle_data = rb.read(vo - rb.tell())
     assert(vo == rb.tell())
 
     values_data = rb.read(po - vo)
@@ -794,6 +1012,10 @@ def unpack_rle_file(rleFilename):
             pixels += [value] * count
 
     assert len(pixels) == width2 * height
+    if codec == RLECodecXorRows:
+        pixels = unxor_rows(pixels, width2)
+    else:
+        assert codec == RLECodecRuns
 
     if format == GBitmapFormat1Bit:
         image = PIL.Image.new('1', (width2, height), 0)
@@ -0,0 +1,185 @@
+#include "assets.h"
+#include "wright.h"
+#include "bwd.h"
+#include "qapp_log.h"
+
+// Enough for every asset of every style; see register_assets() in
+// wright.c and the indicator and chrono modules.
+#define ASSET_MAX_ENTRIES 32
+
+struct __attribute__((__packed__)) Asset {
+  void *asset;
+  uint8_t kind;             // an AssetKind
+  uint8_t cost;             // an AssetCost
+  bool pinned;              // in use for the rest of this frame
+  unsigned short last_used; // the value of asset_clock when last used
+};
+
+static struct Asset assets[ASSET_MAX_ENTRIES];
+static int num_assets = 0;
+
+// Counts frames, to measure how long it has been since each asset was
+// last used.
+static unsigned short asset_clock = 0;
+
+// True between asset_frame_begin() and asset_frame_end(), while pinned
+// assets may not be evicted.
+static bool asset_in_frame = false;
+
+static struct Asset *find_asset(const void *asset) {
+  for (int i = 0; i < num_assets; ++i) {
+    if (assets[i].asset == asset) {
+      return &assets[i];
+    }
+  }
+  return NULL;
+}
+
+// Adds an asset to the registry, if it isn't there already.  The
+// asset must live at this address for the rest of the run; it may be
+// loaded and released freely in the meantime.
+void asset_register(void *asset, AssetKind kind, AssetCost cost) {
+  if (find_asset(asset) != NULL) {
+    return;
+  }
+  assert(num_assets < ASSET_MAX_ENTRIES);
+  struct Asset *entry = &assets[num_assets++];
+  entry->asset = asset;
+  entry->kind = kind;
+  entry->cost = cost;
+  entry->pinned = false;
+  entry->last_used = asset_clock;
+}
+
+// Records that the asset has just been used.
+void asset_touch(const void *asset) {
+  struct Asset *entry = find_asset(asset);
+  if (entry != NULL) {
+    entry->last_used = asset_clock;
+  }
+}
+
+// As asset_touch(), and also keeps the asset from being evicted until
+// the end of the frame.  This is for assets that are loaded in one
+// step of drawing the frame and used again in a later one (like the
+// image and mask of a hand, which are drawn in separate passes), so
+// that a load in between doesn't take them away.  Assets that are
+// drawn as soon as they are loaded needn't be pinned.
+void asset_pin(const void *asset) {
+  struct Asset *entry = find_asset(asset);
+  if (entry != NULL) {
+    entry->last_used = asset_clock;
+    entry->pinned = true;
+  }
+}
+
+void asset_frame_begin() {
+  ++asset_clock;
+  asset_in_frame = true;
+}
+
+// Releases the pins of the frame.
+void asset_frame_end() {
+  asset_in_frame = false;
+  for (int i = 0; i < num_assets; ++i) {
+    assets[i].pinned = false;
+  }
+}
+
+// Returns the number of bytes of heap the asset holds now.
+static size_t asset_get_size(struct Asset *entry) {
+  switch (entry->kind) {
+  case AK_bitmap:
+  case AK_hands_face:
+    return bwd_get_size((BitmapWithData *)entry->asset);
+
+  case AK_hand_cache:
+    return hand_cache_get_size((struct HandCache *)entry->asset);
+
+  case AK_date_fonts:
+    return date_fonts_size;
+
+  case AK_resource_cache:
+#ifdef SUPPORT_RESOURCE_CACHE
+    return resource_cache_bytes;
+#else
+    return 0;
+#endif  // SUPPORT_RESOURCE_CACHE
+
+  case AK_rle_cache:
+#ifdef SUPPORT_RLE_CACHE
+    return rle_cache_bytes;
+#else
+    return 0;
+#endif  // SUPPORT_RLE_CACHE
+  }
+  return 0;
+}
+
+// Releases the asset, or as much of it as can go.  Returns false if
+// nothing was released.
+static bool asset_evict(struct Asset *entry) {
+  switch (entry->kind) {
+  case AK_bitmap:
+    bwd_destroy((BitmapWithData *)entry->asset);
+    return true;
+
+  case AK_hands_face:
+    release_hands_face();
+    return true;
+
+  case AK_hand_cache:
+    hand_cache_destroy((struct HandCache *)entry->asset);
+    return true;
+
+  case AK_date_fonts:
+    unload_date_fonts();
+    return true;
+
+  case AK_resource_cache:
+    return bwd_cache_shrink();
+
+  case AK_rle_cache:
+    return rle_cache_shrink();
+  }
+  return false;
+}
+
+// Evicts the registered asset with the lowest value per byte: the
+// cost of reloading it, discounted by the number of frames since it
+// was last used, over the bytes it holds.  Assets pinned for the
+// current frame are passed over.  Returns true if anything was
+// evicted, or false if there was nothing left to evict, in which case
+// the caller must make do some other way.
+bool asset_evict_one() {
+  uint32_t passed_over = 0;
+  while (true) {
+    struct Asset *lowest = NULL;
+    uint32_t lowest_value = 0;
+    for (int i = 0; i < num_assets; ++i) {
+      struct Asset *entry = &assets[i];
+      if ((passed_over & ((uint32_t)1 << i)) || (asset_in_frame && entry->pinned)) {
+        continue;
+      }
+      size_t size = asset_get_size(entry);
+      if (size == 0) {
+        continue;
+      }
+      unsigned int age = (unsigned short)(asset_clock - entry->last_used);
+      uint32_t value = ((uint32_t)entry->cost << 16) / ((uint32_t)(age + 1) * size);
+      if (lowest == NULL || value < lowest_value) {
+        lowest = entry;
+        lowest_value = value;
+      }
+    }
+    if (lowest == NULL) {
+      qapp_log(APP_LOG_LEVEL_WARNING, __FILE__, __LINE__, "no assets left to evict, heap_bytes_free = %d", heap_bytes_free());
+      return false;
+    }
+    if (asset_evict(lowest)) {
+      qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "evicted asset %d of kind %d, heap_bytes_free = %d", lowest - assets, lowest->kind, heap_bytes_free());
+      return true;
+    }
+    passed_over |= ((uint32_t)1 << (lowest - assets));
+  }
+}
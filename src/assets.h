@@ -0,0 +1,46 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+// The asset registry keeps track of everything the watchface holds in
+// memory from one frame to the next that it could load again if it
+// had to: the face bitmaps, the saved renders of the face, the date
+// window and indicator bitmaps, the hand caches, the date fonts, and
+// the resource and rle caches.  Each is registered once, along with
+// the rough cost of bringing it back, and its size is read from the
+// asset itself when needed.
+//
+// When an allocation fails, asset_evict_one() releases the asset that
+// is worth the least per byte it holds--cheap to reload, large, and
+// long unused--so the caller can try the same allocation again.  Only
+// when there is nothing left to evict does the failure become a
+// memory panic (see reset_memory_panic()).
+
+#include <pebble.h>
+#include "../resources/generated_config.h"
+
+// How to measure and release a registered asset.
+typedef enum {
+  AK_bitmap,          // a BitmapWithData
+  AK_hands_face,      // hands_face, which isn't kept again once evicted
+  AK_hand_cache,      // a struct HandCache
+  AK_date_fonts,      // the date window fonts (see load_date_fonts())
+  AK_resource_cache,  // the resource cache, given up a bitmap at a time
+  AK_rle_cache,       // the compressed rle cache, likewise
+} AssetKind;
+
+// The rough work of loading an asset again once it has been evicted.
+typedef enum {
+  AC_cache = 1,   // rebuilt in passing the next time it's wanted
+  AC_decode = 2,  // decoded again from its resource
+  AC_font = 4,    // a custom font, loaded again
+  AC_render = 8,  // the whole face, rendered again
+} AssetCost;
+
+void asset_register(void *asset, AssetKind kind, AssetCost cost);
+void asset_touch(const void *asset);
+void asset_pin(const void *asset);
+void asset_frame_begin();
+void asset_frame_end();
+bool asset_evict_one();
+
+#endif  // ASSETS_H
@@ -172,6 +172,11 @@ void handle_battery(BatteryChargeState new_charge_state) {
 }
 
 void init_battery_gauge() {
+  asset_register(&battery_gauge_empty, AK_bitmap, AC_decode);
+  asset_register(&battery_gauge_charged, AK_bitmap, AC_decode);
+  asset_register(&battery_gauge_mask, AK_bitmap, AC_decode);
+  asset_register(&charging, AK_bitmap, AC_decode);
+  asset_register(&charging_mask, AK_bitmap, AC_decode);
   battery_state_service_subscribe(&handle_battery);
 }
 
@@ -6,6 +6,7 @@
 
 void init_battery_gauge();
 void deinit_battery_gauge();
+void destroy_battery_gauge_bitmaps();
 void draw_battery_gauge(GContext *ctx, int x, int y, bool invert);
 
 #endif  // BATTERY_GAUGE_H
@@ -159,6 +159,13 @@ static void handle_bluetooth(bool new_bluetooth_state) {
 }
 
 void init_bluetooth_indicator() {
+  asset_register(&bluetooth_disconnected, AK_bitmap, AC_decode);
+  asset_register(&bluetooth_connected, AK_bitmap, AC_decode);
+  asset_register(&bluetooth_mask, AK_bitmap, AC_decode);
+#ifndef PBL_PLATFORM_APLITE
+  asset_register(&quiet_time, AK_bitmap, AC_decode);
+  asset_register(&quiet_time_mask, AK_bitmap, AC_decode);
+#endif  // PBL_PLATFORM_APLITE
   bluetooth_connection_service_subscribe(&handle_bluetooth);
 }
 
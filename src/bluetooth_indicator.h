@@ -3,6 +3,7 @@
 
 void init_bluetooth_indicator();
 void deinit_bluetooth_indicator();
+void destroy_bluetooth_bitmaps();
 void draw_bluetooth_indicator(GContext *ctx, int x, int y, bool invert);
 
 #ifdef PBL_PLATFORM_APLITE
@@ -2,17 +2,188 @@
 #include "qapp_log.h"
 #include "assert.h"
 #include "pebble_compat.h"
+#include "timing.h"
 #include "../resources/generated_config.h"
 //#define SUPPORT_RLE 1
 
 int bwd_resource_reads = 0;
+int bwd_load_calls = 0;
+int bwd_load_bytes = 0;
+int bwd_load_bytes_reread = 0;
+
+#ifdef BWD_STATS
+struct BwdStats bwd_stats;
+#endif  // BWD_STATS
 
 #ifdef SUPPORT_RESOURCE_CACHE
-void bwd_clear_cache(struct ResourceCache *resource_cache, size_t resource_cache_size) {
-  for (int i = 0; i < (int)resource_cache_size; ++i) {
-    struct ResourceCache *cache = &resource_cache[i];
-    bwd_destroy(&(cache->bwd));
+// The resource cache keeps the bitmaps of the resources we draw over
+// and over (the frames of the second and chrono-second hands), keyed
+// by resource id and variant, up to resource_cache_budget bytes in
+// all.  The bitmaps are stored ready to draw, already remapped and
+// flipped as the variant requires, and are lent out to the caller
+// rather than copied.  When it's full, the least recently used
+// bitmaps that are not currently lent out are evicted to make room.
+
+// The largest number of bitmaps we keep at once: enough for every
+// flipped variant of every frame of the cached hands.
+#define RESOURCE_CACHE_MAX_ENTRIES (SECOND_RESOURCE_CACHE_SIZE + SECOND_MASK_RESOURCE_CACHE_SIZE + CHRONO_SECOND_RESOURCE_CACHE_SIZE + CHRONO_SECOND_MASK_RESOURCE_CACHE_SIZE)
+
+static struct ResourceCache resource_cache[RESOURCE_CACHE_MAX_ENTRIES];
+static size_t resource_cache_budget = RESOURCE_CACHE_BUDGET;
+static unsigned short resource_cache_clock = 0;
+size_t resource_cache_bytes = 0;
+int resource_cache_hits = 0;
+int resource_cache_misses = 0;
+int resource_cache_evictions = 0;
+
+// Frees the indicated cache entry.
+static void resource_cache_evict(struct ResourceCache *entry) {
+  resource_cache_bytes -= entry->size;
+  bwd_destroy(&(entry->bwd));
+  entry->resource_id = 0;
+  entry->variant = 0;
+  entry->refs = 0;
+  entry->size = 0;
+}
+
+// Evicts the least recently used entries that aren't lent out until
+// there is an unused entry and room within the budget for size more
+// bytes, and returns that entry, or NULL if the budget is too small.
+static struct ResourceCache *resource_cache_make_room(size_t size) {
+  while (true) {
+    struct ResourceCache *unused = NULL;
+    struct ResourceCache *oldest = NULL;
+    for (int i = 0; i < RESOURCE_CACHE_MAX_ENTRIES; ++i) {
+      struct ResourceCache *entry = &resource_cache[i];
+      if (entry->resource_id == 0) {
+        if (unused == NULL) {
+          unused = entry;
+        }
+      } else if (entry->refs == 0 && (oldest == NULL || (unsigned short)(resource_cache_clock - entry->last_used) > (unsigned short)(resource_cache_clock - oldest->last_used))) {
+        oldest = entry;
+      }
+    }
+    if (unused != NULL && resource_cache_bytes + size <= resource_cache_budget) {
+      return unused;
+    }
+    if (oldest == NULL) {
+      return NULL;
+    }
+    resource_cache_evict(oldest);
+    ++resource_cache_evictions;
+  }
+}
+
+// Changes the number of bytes the cache may hold, evicting bitmaps as
+// needed to fit.  A budget of 0 turns the cache off.  Bitmaps that
+// are lent out stay until they are returned.
+void bwd_set_cache_budget(size_t budget) {
+  resource_cache_budget = budget;
+  while (resource_cache_bytes > resource_cache_budget) {
+    if (resource_cache_make_room(0) == NULL) {
+      break;
+    }
+  }
+}
+
+// Evicts the least recently used bitmap that isn't lent out, and
+// lowers the budget to what remains, so that the cache doesn't just
+// grow back into the room it made (see asset_evict_one()).  Returns
+// false if there was nothing to evict.
+bool bwd_cache_shrink() {
+  size_t bytes = resource_cache_bytes;
+  size_t budget = resource_cache_budget;
+  if (bytes == 0) {
+    return false;
+  }
+  bwd_set_cache_budget(bytes - 1);
+  if (resource_cache_bytes == bytes) {
+    // Everything is lent out.
+    resource_cache_budget = budget;
+    return false;
+  }
+  resource_cache_budget = resource_cache_bytes;
+  return true;
+}
+
+// Empties the cache.  No bitmaps may be lent out.
+void bwd_clear_cache() {
+  for (int i = 0; i < RESOURCE_CACHE_MAX_ENTRIES; ++i) {
+    if (resource_cache[i].resource_id != 0) {
+      assert(resource_cache[i].refs == 0);
+      resource_cache_evict(&resource_cache[i]);
+    }
+  }
+}
+
+// Looks for the indicated variant of the resource's bitmap in the
+// cache.  If it's there, returns it, lent out until the matching call
+// to bwd_cache_return(); the caller must not modify or destroy it.
+// Otherwise, returns NULL; the caller may then build the bitmap
+// itself and offer it with bwd_cache_add().
+const BitmapWithData *bwd_cache_lend(int resource_id, int variant) {
+  if (resource_cache_budget == 0) {
+    return NULL;
+  }
+
+  ++resource_cache_clock;
+  for (int i = 0; i < RESOURCE_CACHE_MAX_ENTRIES; ++i) {
+    struct ResourceCache *entry = &resource_cache[i];
+    if (entry->resource_id == resource_id && entry->variant == variant) {
+      ++resource_cache_hits;
+      ++(entry->refs);
+      entry->last_used = resource_cache_clock;
+      return &(entry->bwd);
+    }
+  }
+
+  ++resource_cache_misses;
+  return NULL;
+}
+
+// Offers a newly built bitmap to the cache.  If it fits within the
+// budget, the cache takes ownership of it and returns it lent out, as
+// by bwd_cache_lend().  Otherwise, returns NULL, and bwd still
+// belongs to the caller.
+const BitmapWithData *bwd_cache_add(int resource_id, int variant, BitmapWithData *bwd) {
+  size_t size = bwd_get_size(bwd);
+  struct ResourceCache *entry = (size <= resource_cache_budget) ? resource_cache_make_room(size) : NULL;
+  if (entry == NULL) {
+    return NULL;
+  }
+  entry->resource_id = resource_id;
+  entry->variant = variant;
+  entry->refs = 1;
+  entry->size = size;
+  entry->last_used = resource_cache_clock;
+  entry->bwd = *bwd;
+  resource_cache_bytes += size;
+  return &(entry->bwd);
+}
+
+// Changes the remapping of every bitmap in the cache, as by
+// bwd_recolor().  Those that can't be recolored are evicted, unless
+// they are lent out.
+void bwd_cache_recolor(const BwdRemap *remap) {
+  for (int i = 0; i < RESOURCE_CACHE_MAX_ENTRIES; ++i) {
+    struct ResourceCache *entry = &resource_cache[i];
+    if (entry->resource_id != 0 && !bwd_recolor(&(entry->bwd), remap) && entry->refs == 0) {
+      resource_cache_evict(entry);
+    }
+  }
+}
+
+// Returns a bitmap lent out by bwd_cache_lend() or bwd_cache_add().
+void bwd_cache_return(const BitmapWithData *bwd) {
+  for (int i = 0; i < RESOURCE_CACHE_MAX_ENTRIES; ++i) {
+    struct ResourceCache *entry = &resource_cache[i];
+    if (entry->resource_id != 0 && entry->bwd.bitmap == bwd->bitmap) {
+      assert(entry->refs > 0);
+      --(entry->refs);
+      return;
+    }
   }
+  assert(false);
 }
 #endif  // SUPPORT_RESOURCE_CACHE
 
@@ -34,6 +205,117 @@ void bwd_destroy(BitmapWithData *bwd) {
   }
 }
 
+// Returns the number of bytes of heap taken by the bitmap's pixels
+// and palette, or 0 if it is empty.
+size_t bwd_get_size(BitmapWithData *bwd) {
+  GBitmap *bitmap = bwd->bitmap;
+  if (bitmap == NULL) {
+    return 0;
+  }
+  size_t size = gbitmap_get_bytes_per_row(bitmap) * gbitmap_get_bounds(bitmap).size.h;
+#ifndef PBL_BW
+  size_t palette_size = 0;
+  switch (gbitmap_get_format(bitmap)) {
+  case GBitmapFormat1BitPalette:
+    palette_size = 2 * sizeof(GColor);
+    break;
+
+  case GBitmapFormat2BitPalette:
+    palette_size = 4 * sizeof(GColor);
+    break;
+
+  case GBitmapFormat4BitPalette:
+    palette_size = 16 * sizeof(GColor);
+    break;
+
+  default:
+    break;
+  }
+  if (bwd->data != NULL) {
+    // The original palette is kept as well.
+    palette_size *= 2;
+  }
+  size += palette_size;
+#endif  // PBL_BW
+  return size;
+}
+
+#ifdef SUPPORT_RLE
+// Returns the number of bytes in each row of a bitmap of the
+// indicated width and format, as gbitmap_create_blank() lays it out:
+// 1-bit rows are padded to a whole word, and the others to a whole
+// byte.
+static int bwd_row_size(int width, GBitmapFormat format) {
+  switch (format) {
+  case GBitmapFormat1Bit:
+    return ((width + 31) / 32) * 4;
+  case GBitmapFormat1BitPalette:
+    return (width + 7) / 8;
+  case GBitmapFormat2BitPalette:
+    return (width + 3) / 4;
+  case GBitmapFormat4BitPalette:
+    return (width + 1) / 2;
+  default:
+    return width;
+  }
+}
+
+// Makes buffer, which has room for *capacity bytes of pixels, ready
+// to receive an image of the indicated size and format in place of a
+// new bitmap, and returns its bitmap.  If the buffer is not yet
+// allocated, or is too small, or lacks the palette the image needs,
+// it is allocated anew with room for an image of max_size (or of
+// this image, if it is bigger) in this format, and *capacity is
+// updated.  The data is laid out, and cleared, just as
+// gbitmap_create_blank() would have (the unpackers only set bits).
+// Returns NULL on allocation failure.
+static GBitmap *bwd_prepare_buffer(BitmapWithData *buffer, uint16_t *capacity, GSize max_size, GSize size, GBitmapFormat format, bool with_palette) {
+  int row_size = bwd_row_size(size.w, format);
+  if (buffer->bitmap == NULL || row_size * size.h > *capacity ||
+      (with_palette && gbitmap_get_palette(buffer->bitmap) == NULL)) {
+    bwd_destroy(buffer);
+    *capacity = 0;
+    GSize alloc_size = max_size;
+    if (row_size * size.h > bwd_row_size(max_size.w, format) * max_size.h) {
+      alloc_size = size;
+    }
+    GBitmap *bitmap = NULL;
+    GColor *palette = NULL;
+#ifndef PBL_BW
+    if (with_palette) {
+      // Room for the largest palette, so that any later image fits,
+      // along with its original colors (see bwd_recolor()).
+      palette = (GColor *)malloc(2 * 16 * sizeof(GColor));
+      if (palette == NULL) {
+        return NULL;
+      }
+      bitmap = gbitmap_create_blank_with_palette(alloc_size, format, palette, false);
+      if (bitmap == NULL) {
+        free(palette);
+        palette = NULL;
+      }
+    } else
+#endif  // PBL_BW
+    {
+      bitmap = gbitmap_create_blank(alloc_size, format);
+    }
+    if (bitmap == NULL) {
+      qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "could not create buffer of size %dx%d and format %d", alloc_size.w, alloc_size.h, format);
+      return NULL;
+    }
+    *buffer = bwd_create(bitmap, (unsigned char *)palette);
+    *capacity = bwd_row_size(alloc_size.w, format) * alloc_size.h;
+  }
+
+  GBitmap *bitmap = buffer->bitmap;
+  uint8_t *data = gbitmap_get_data(bitmap);
+  memset(data, 0, row_size * size.h);
+  gbitmap_set_data(bitmap, data, format, row_size, true);
+  gbitmap_set_bounds(bitmap, GRect(0, 0, size.w, size.h));
+  return bitmap;
+}
+#endif  // SUPPORT_RLE
+
 #ifdef SUPPORT_BWD_COPY
 BitmapWithData bwd_copy(BitmapWithData *source) {
   return bwd_copy_bitmap(source->bitmap);
@@ -49,13 +331,16 @@ BitmapWithData bwd_copy_bitmap(GBitmap *source) {
   GSize size = gbitmap_get_bounds(source).size;
 
   GBitmapFormat format = gbitmap_get_format(source);
+  HEAP_TRACE_BEGIN("bwd_copy_bitmap");
   dest.bitmap = gbitmap_create_blank(size, format);
   if (dest.bitmap == NULL) {
+    HEAP_TRACE_END();
     qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "memory allocation failure on %dx%d %d image", size.w, size.h, format);
     return bwd_create(NULL, NULL);
   }
 
   bwd_copy_into_from_bitmap(&dest, source);
+  HEAP_TRACE_END();
   return dest;
 }
 #endif  // SUPPORT_BWD_COPY
@@ -138,28 +423,100 @@ void bwd_copy_into_from_bitmap(BitmapWithData *dest, GBitmap *source) {
 BitmapWithData png_bwd_create(int resource_id) {
   qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "png_bwd_create(%d)", resource_id);
   ++bwd_resource_reads;
+  HEAP_TRACE_BEGIN("png_bwd_create");
   GBitmap *image = gbitmap_create_with_resource(resource_id);
+  HEAP_TRACE_END();
   if (image == NULL) {
     qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "failed to read image %d", resource_id);
   }
   return bwd_create(image, NULL);
 }
 
-#ifdef SUPPORT_RESOURCE_CACHE
-BitmapWithData png_bwd_create_with_cache(int resource_id_offset, int resource_id, struct ResourceCache *resource_cache, size_t resource_cache_size) {
-  int index = resource_id - resource_id_offset;
-  if (index >= (int)resource_cache_size) {
-    // No cache in use.
-    return png_bwd_create(resource_id);
+#ifndef PBL_BW
+// Replace each of the R, G, B channels of the palette entries with a
+// different color, and blend the result together.  See
+// bwd_remap_colors().
+static void remap_palette(GColor *palette, int palette_size, const BwdRemap *remap) {
+  GColor cb = remap->cb;
+  GColor c1 = remap->c1;
+  GColor c2 = remap->c2;
+  GColor c3 = remap->c3;
+  for (int pi = 0; pi < palette_size; ++pi) {
+    GColor p = palette[pi];
+    if (remap->bank != NULL) {
+      // config_watch.py has already worked out the blend below.
+      palette[pi].argb = (p.argb & 0xc0) | remap->bank[p.argb & 0x3f];
+      if (remap->invert_colors) {
+        palette[pi].argb ^= 0x3f;
+      }
+      continue;
+    }
+
+    int r = cb.r;
+    int g = cb.g;
+    int b = cb.b;
+
+    r = (3 * r + p.r * (c1.r - r)) / 3;  // Blend from r to c1.r
+    r = (3 * r + p.g * (c2.r - r)) / 3;  // Blend from r to c2.r
+    r = (3 * r + p.b * (c3.r - r)) / 3;  // Blend from r to c3.r
+
+    g = (3 * g + p.r * (c1.g - g)) / 3;  // Blend from g to c1.g
+    g = (3 * g + p.g * (c2.g - g)) / 3;  // Blend from g to c2.g
+    g = (3 * g + p.b * (c3.g - g)) / 3;  // Blend from g to c3.g
+
+    b = (3 * b + p.r * (c1.b - b)) / 3;  // Blend from b to c1.b
+    b = (3 * b + p.g * (c2.b - b)) / 3;  // Blend from b to c2.b
+    b = (3 * b + p.b * (c3.b - b)) / 3;  // Blend from b to c3.b
+
+    palette[pi].r = (r < 0x3) ? r : 0x3;
+    palette[pi].g = (g < 0x3) ? g : 0x3;
+    palette[pi].b = (b < 0x3) ? b : 0x3;
+
+    //    GColor q = palette[pi]; qapp_log(APP_LOG_LEVEL_WARNING, __FILE__, __LINE__, "cb = %02x, c1 = %02x, c2 = %02x, c3 = %02x.  %d: %02x/%02x/%02x/%02x becomes %02x/%02x/%02x/%02x (%d, %d, %d)", cb.argb, c1.argb, c2.argb, c3.argb, pi, p.argb & 0xc0, p.argb & 0x30, p.argb & 0x0c, p.argb & 0x03, q.argb & 0xc0, q.argb & 0x30, q.argb & 0x0c, q.argb & 0x03, r, g, b);
+
+    if (remap->invert_colors) {
+      palette[pi].argb ^= 0x3f;
+    }
+  }
+}
+#endif  // PBL_BW
+
+// Draws the part of bwd that falls within clip into destination with
+// the indicated compositing mode, after applying remap (if not NULL),
+// and then releases it.  This is what rle_bwd_draw_rect() falls back
+// to when it can't draw directly.
+static bool bwd_draw_once(GContext *ctx, BitmapWithData *bwd, GRect destination, GRect clip, GCompOp op, const BwdRemap *remap) {
+  if (bwd->bitmap == NULL) {
+    return false;
+  }
+  if (remap != NULL) {
+    bwd_remap_colors(bwd, remap);
   }
 
-  struct ResourceCache *cache = &resource_cache[index];
-  if (cache->bwd.bitmap == NULL) {
-    cache->bwd = png_bwd_create(resource_id);
+  GRect visible = destination;
+  grect_clip(&visible, &clip);
+  if (!grect_equal(&visible, &destination)) {
+    // Narrow the bitmap's bounds down to the visible part.
+    GRect bounds = gbitmap_get_bounds(bwd->bitmap);
+    int left = visible.origin.x - destination.origin.x;
+    int top = visible.origin.y - destination.origin.y;
+    bounds.origin.x += left;
+    bounds.origin.y += top;
+    bounds.size.w = (bounds.size.w - left < visible.size.w) ? bounds.size.w - left : visible.size.w;
+    bounds.size.h = (bounds.size.h - top < visible.size.h) ? bounds.size.h - top : visible.size.h;
+    if (bounds.size.w <= 0 || bounds.size.h <= 0) {
+      bwd_destroy(bwd);
+      return true;
+    }
+    gbitmap_set_bounds(bwd->bitmap, bounds);
+    destination = visible;
   }
-  return bwd_copy(&(cache->bwd));
+
+  graphics_context_set_compositing_mode(ctx, op);
+  graphics_draw_bitmap_in_rect(ctx, bwd->bitmap, destination);
+  bwd_destroy(bwd);
+  return true;
 }
-#endif  // SUPPORT_RESOURCE_CACHE
 
 #ifndef SUPPORT_RLE
 
@@ -169,52 +526,231 @@ BitmapWithData rle_bwd_create(int resource_id) {
   return png_bwd_create(resource_id);
 }
 
-#ifdef SUPPORT_RESOURCE_CACHE
-BitmapWithData rle_bwd_create_with_cache(int resource_id_offset, int resource_id, struct ResourceCache *resource_cache, size_t resource_cache_size) {
-  return png_bwd_create_with_cache(resource_id_offset, resource_id, resource_cache, resource_cache_size);
+// Only the remap is supported here; hands that need flipping are
+// flipped by the caller when they are not rle-encoded.
+BitmapWithData rle_bwd_create_transformed(int resource_id, bool flip_x, bool flip_y, const BwdRemap *remap) {
+  assert(!flip_x && !flip_y);
+  BitmapWithData bwd = png_bwd_create(resource_id);
+  if (remap != NULL) {
+    bwd_remap_colors(&bwd, remap);
+  }
+  return bwd;
+}
+
+// Without rle, there's nothing to decode into a buffer, and so
+// nothing to read it through either.
+size_t rle_max_resource_size(int resource_id, int num_resources) {
+  return 0;
+}
+
+bool rle_window_reserve(RleWindow *window, size_t size) {
+  return true;
+}
+
+void rle_window_destroy(RleWindow *window) {
+}
+
+bool rle_bwd_create_into(BitmapWithData *buffer, uint16_t *capacity, GSize max_size, RleWindow *window, int resource_id, bool flip_x, bool flip_y, const BwdRemap *remap) {
+  return false;
+}
+
+bool rle_bwd_draw_rect(Layer *layer, GContext *ctx, int resource_id, GRect destination, GRect clip, GCompOp op, const BwdRemap *remap) {
+  BitmapWithData bwd = png_bwd_create(resource_id);
+  return bwd_draw_once(ctx, &bwd, destination, clip, op, remap);
 }
-#endif  // SUPPORT_RESOURCE_CACHE
 
 #else  // SUPPORT_RLE
 
 // Here's the proper implementation of rle_bwd_create() and its support functions.
 
+// The RBuffer's own read window, used when we can't allocate a larger
+// one.
 #define RBUFFER_SIZE 64
+
+// The largest read window we'll allocate for a resource that is too
+// large to read all at once.
+#define RBUFFER_MAX_WINDOW 1024
+
+// An RBuffer may take up to 1 / RBUFFER_HEAP_FRACTION of the free
+// heap for its read window.
+#define RBUFFER_HEAP_FRACTION 8
+
 typedef struct {
   ResHandle _rh;
   size_t _i;
   size_t _filled_size;
   size_t _bytes_read;
   size_t _total_size;
+  size_t _loaded_end;    // the furthest point ever loaded from the resource
   const uint8_t *_data;
+  uint8_t *_window;      // where bytes are loaded from the resource
+  size_t _window_size;
+  uint8_t *_alloc;       // the heap memory owned by this RBuffer, if any
+  bool _lent;            // true if reading through an RleWindow, and so never allocating
   uint8_t _buffer[RBUFFER_SIZE];
 } RBuffer;
 
-// Begins reading from a raw resource.  Should be matched by a later
-// call to rbuffer_deinit().
-static void rbuffer_init_resource(RBuffer *rb, int resource_id, size_t offset) {
-  //  rb->_buffer = (uint8_t *)malloc(RBUFFER_SIZE);
-  //  assert(rb->_buffer != NULL);
+// Returns the size of the largest of the num_resources resources
+// beginning at resource_id.
+size_t rle_max_resource_size(int resource_id, int num_resources) {
+  size_t max_size = 0;
+  for (int i = 0; i < num_resources; ++i) {
+    size_t size = resource_size(resource_get_handle(resource_id + i));
+    if (size > max_size) {
+      max_size = size;
+    }
+  }
+  return max_size;
+}
+
+// Makes window large enough to load a resource of size bytes all at
+// once (or RBUFFER_MAX_WINDOW bytes at a time, if it's larger than
+// that), unless it already is.  Returns false on allocation failure.
+bool rle_window_reserve(RleWindow *window, size_t size) {
+  if (size > RBUFFER_MAX_WINDOW) {
+    size = RBUFFER_MAX_WINDOW;
+  }
+  if (window->data != NULL && window->size >= size) {
+    return true;
+  }
+  rle_window_destroy(window);
+  window->data = (uint8_t *)malloc(size);
+  if (window->data == NULL) {
+    return false;
+  }
+  window->size = size;
+  return true;
+}
+
+void rle_window_destroy(RleWindow *window) {
+  free(window->data);
+  window->data = NULL;
+  window->size = 0;
+}
+
+// Chooses a read window for rb, which will read size bytes of its
+// resource.  If they fit comfortably within the free heap, the window
+// holds all of them, so they are loaded with a single call; otherwise
+// it's as large as we can reasonably make it.  If we can't allocate
+// anything larger, or if rb is one half of a lent RBuffer (see
+// rbuffer_split()), we use the RBuffer's own small buffer.
+static void rbuffer_alloc_window(RBuffer *rb, size_t size) {
+  rb->_window = rb->_buffer;
+  rb->_window_size = RBUFFER_SIZE;
+  rb->_alloc = NULL;
+  if (rb->_lent) {
+    return;
+  }
+
+  size_t budget = heap_bytes_free() / RBUFFER_HEAP_FRACTION;
+  size_t window_size = size;
+  if (window_size > budget) {
+    window_size = (budget < RBUFFER_MAX_WINDOW) ? budget : RBUFFER_MAX_WINDOW;
+  }
+  if (window_size > RBUFFER_SIZE) {
+    uint8_t *alloc = (uint8_t *)malloc(window_size);
+    if (alloc != NULL) {
+      rb->_window = rb->_alloc = alloc;
+      rb->_window_size = window_size;
+    }
+  }
+}
+
+// Loads num_bytes from rb's resource at offset into dest, which is
+// within rb's read window, and returns the number of bytes actually
+// loaded.  Updates the bwd_load_* counters.
+static size_t rbuffer_load(RBuffer *rb, size_t offset, uint8_t *dest, size_t num_bytes) {
+  assert(rb->_rh != 0 && dest >= rb->_window && dest + num_bytes <= rb->_window + rb->_window_size);
+  size_t bytes_read = resource_load_byte_range(rb->_rh, offset, dest, num_bytes);
+  //assert((ssize_t)bytes_read >= 0);
+  if ((ssize_t)bytes_read < 0) {
+    bytes_read = 0;
+  }
+
+  ++bwd_load_calls;
+  bwd_load_bytes += bytes_read;
+  size_t end = offset + bytes_read;
+  if (rb->_loaded_end > offset) {
+    // Some of these bytes were loaded before.
+    bwd_load_bytes_reread += ((rb->_loaded_end < end) ? rb->_loaded_end : end) - offset;
+  }
+  if (end > rb->_loaded_end) {
+    rb->_loaded_end = end;
+  }
+  return bytes_read;
+}
 
+// Begins reading from a raw resource, through the RBuffer's own small
+// buffer until rbuffer_widen_window() is called.  Should be matched by
+// a later call to rbuffer_deinit().
+static void rbuffer_init_resource(RBuffer *rb, int resource_id, size_t offset) {
   rb->_rh = resource_get_handle(resource_id);
   rb->_total_size = resource_size(rb->_rh);
   rb->_i = 0;
   rb->_filled_size = 0;
   rb->_bytes_read = offset;
-  rb->_data = rb->_buffer;
+  rb->_loaded_end = 0;
+  rb->_window = rb->_buffer;
+  rb->_window_size = RBUFFER_SIZE;
+  rb->_alloc = NULL;
+  rb->_lent = false;
+  rb->_data = rb->_window;
+}
+
+// Has rb, just initialized with rbuffer_init_resource(), read through
+// the caller's window instead of its own.
+static void rbuffer_lend_window(RBuffer *rb, RleWindow *window) {
+  rb->_window = window->data;
+  rb->_window_size = window->size;
+  rb->_lent = true;
+  rb->_data = rb->_window;
+}
+
+// Gives rb a larger read window (see rbuffer_alloc_window()) for the
+// bytes it hasn't read yet, and fills it.  This is put off until the
+// caller has allocated whatever it means to keep, such as the bitmap
+// being decoded, so that the window, which is freed again soon after,
+// doesn't leave a hole in the heap beneath it.
+static void rbuffer_widen_window(RBuffer *rb) {
+  if (rb->_window != rb->_buffer) {
+    // An in-memory RBuffer, one already widened, or one reading
+    // through a lent window.
+    return;
+  }
+
+  size_t unread = rb->_filled_size - rb->_i;
+  rbuffer_alloc_window(rb, rb->_total_size - rb->_bytes_read + unread);
+  if (rb->_alloc == NULL) {
+    // We'll go on with the small buffer.
+    return;
+  }
+  memcpy(rb->_window, rb->_data + rb->_i, unread);
+  rb->_data = rb->_window;
+  rb->_i = 0;
+  rb->_filled_size = unread;
+
+  size_t bytes_remaining = rb->_total_size - rb->_bytes_read;
+  size_t room = rb->_window_size - unread;
+  if (bytes_remaining != 0 && room != 0) {
+    size_t try_to_read = (bytes_remaining < room) ? bytes_remaining : room;
+    size_t bytes_read = rbuffer_load(rb, rb->_bytes_read, rb->_window + unread, try_to_read);
+    rb->_filled_size += bytes_read;
+    rb->_bytes_read += bytes_read;
+  }
 }
 
 // Begins reading from a data buffer.  The data buffer should not be
 // freed during the lifetime of the RBuffer.  Should be matched by a
 // later call to rbuffer_deinit().
 static void rbuffer_init_data(RBuffer *rb, unsigned char *data, size_t data_size) {
-  //  rb->_buffer = (uint8_t *)malloc(RBUFFER_SIZE);
-  //  assert(rb->_buffer != NULL);
-
   rb->_rh = 0;
   rb->_i = 0;
-  rb->_total_size = rb->_filled_size = rb->_bytes_read = data_size;
+  rb->_total_size = rb->_filled_size = rb->_bytes_read = rb->_loaded_end = data_size;
   rb->_data = data;
+  rb->_window = NULL;
+  rb->_window_size = 0;
+  rb->_alloc = NULL;
+  rb->_lent = false;
 }
 
 // Splits an RBuffer into two discrete parts.  rb_front is truncated
@@ -226,16 +762,40 @@ static void rbuffer_init_data(RBuffer *rb, unsigned char *data, size_t data_size
 static void rbuffer_split(RBuffer *rb_front, RBuffer *rb_back, size_t point) {
   rb_back->_rh = rb_front->_rh;
   rb_back->_total_size = rb_front->_total_size;
-  rb_back->_i = 0;
-  rb_back->_filled_size = 0;
-  rb_back->_bytes_read = point;
-  rb_back->_data = rb_back->_buffer;
-  if (rb_front->_rh == 0) {
-    // This is an in-memory RBuffer.
-    assert(rb_front->_data != rb_front->_buffer && rb_front->_filled_size == rb_front->_total_size);
-    rb_back->_data = rb_front->_data;
-    rb_back->_bytes_read = rb_back->_filled_size = rb_front->_total_size;
-    rb_back->_i = point;
+  rb_back->_loaded_end = rb_front->_loaded_end;
+  rb_back->_lent = rb_front->_lent;
+
+  size_t window_start = rb_front->_bytes_read - rb_front->_filled_size;
+  if (point >= window_start && rb_front->_bytes_read == rb_front->_total_size) {
+    // rb_front already holds all of rb_back's bytes in memory (either
+    // it's an in-memory RBuffer, or the rest of the resource was
+    // loaded at once), so rb_back can simply share them.
+    rb_back->_data = rb_front->_data + (point - window_start);
+    rb_back->_window = NULL;
+    rb_back->_window_size = 0;
+    rb_back->_alloc = NULL;
+    rb_back->_bytes_read = rb_front->_total_size;
+    rb_back->_filled_size = rb_front->_total_size - point;
+    rb_back->_i = 0;
+
+  } else {
+    rbuffer_alloc_window(rb_back, rb_back->_total_size - point);
+    rb_back->_data = rb_back->_window;
+    rb_back->_i = 0;
+    rb_back->_filled_size = 0;
+    rb_back->_bytes_read = point;
+
+    if (point >= window_start && point < rb_front->_bytes_read) {
+      // Some of rb_back's bytes are already in rb_front's window;
+      // copy them over rather than loading them again.
+      size_t overlap = rb_front->_bytes_read - point;
+      if (overlap > rb_back->_window_size) {
+        overlap = rb_back->_window_size;
+      }
+      memcpy(rb_back->_window, rb_front->_data + (point - window_start), overlap);
+      rb_back->_filled_size = overlap;
+      rb_back->_bytes_read = point + overlap;
+    }
   }
 
   if (rb_front->_total_size > point) {
@@ -245,6 +805,7 @@ static void rbuffer_split(RBuffer *rb_front, RBuffer *rb_back, size_t point) {
       size_t bytes_over = rb_front->_bytes_read - point;
       if (rb_front->_filled_size >= bytes_over) {
         rb_front->_filled_size -= bytes_over;
+        rb_front->_bytes_read = point;
       } else {
         // Whoops, we've already overrun the new point.
         rb_front->_filled_size = 0;
@@ -263,13 +824,9 @@ static int rbuffer_getc(RBuffer *rb) {
     if (rb->_total_size > rb->_bytes_read) {
       // More bytes available to read; read them now.
       size_t bytes_remaining = rb->_total_size - rb->_bytes_read;
-      size_t try_to_read = (bytes_remaining < RBUFFER_SIZE) ? bytes_remaining : (size_t)RBUFFER_SIZE;
-      assert(rb->_rh != 0);
-      size_t bytes_read = resource_load_byte_range(rb->_rh, rb->_bytes_read, rb->_buffer, try_to_read);
-      //assert((ssize_t)bytes_read >= 0);
-      if ((ssize_t)bytes_read < 0) {
-        bytes_read = 0;
-      }
+      size_t try_to_read = (bytes_remaining < rb->_window_size) ? bytes_remaining : rb->_window_size;
+      size_t bytes_read = rbuffer_load(rb, rb->_bytes_read, rb->_window, try_to_read);
+      rb->_data = rb->_window;
       rb->_filled_size = bytes_read;
       rb->_bytes_read += bytes_read;
     } else {
@@ -288,120 +845,459 @@ static int rbuffer_getc(RBuffer *rb) {
   return result;
 }
 
+// Repositions rb so that the next byte read will be the one at
+// offset pos from the beginning of the resource (or data buffer).
+static void rbuffer_seek(RBuffer *rb, size_t pos) {
+  size_t window_start = rb->_bytes_read - rb->_filled_size;
+  if (pos >= window_start && pos <= rb->_bytes_read) {
+    // It's already in memory.
+    rb->_i = pos - window_start;
+  } else {
+    // Start reading afresh from pos.
+    assert(rb->_window != NULL);
+    rb->_bytes_read = pos;
+    rb->_filled_size = 0;
+    rb->_i = 0;
+  }
+}
+
+// Reads a little-endian unsigned integer of num_bytes bytes.
+static size_t rbuffer_get_uint(RBuffer *rb, int num_bytes) {
+  size_t value = 0;
+  for (int i = 0; i < num_bytes; ++i) {
+    value |= (size_t)(rbuffer_getc(rb) & 0xff) << (i * 8);
+  }
+  return value;
+}
+
 // Frees the resources reserved in rbuffer_init().
 static void rbuffer_deinit(RBuffer *rb) {
-  //  assert(rb->_buffer != NULL);
-  //  free(rb->_buffer);
-  //rb->_buffer = NULL;
+  free(rb->_alloc);
+  rb->_alloc = NULL;
 }
 
-// Used to unpack the integers of an rl2-encoding back into their
-// original rle sequence.  See make_rle.py.
+#ifdef SUPPORT_RLE_CACHE
+
+// The compressed rle cache keeps the raw bytes of the most recently
+// used small rle resources in RAM, up to rle_cache_budget bytes in
+// all.  The resources we decode over and over (the second hand
+// frames, the date window, the moon wheel, the indicators) can then
+// be decoded from memory rather than read again from the resource
+// file, and this costs much less heap than keeping the decoded
+// bitmaps in the resource cache.
+
+// The largest number of resources we keep at once.
+#define RLE_CACHE_MAX_ENTRIES 32
+
+// A resource may take up to 1 / RLE_CACHE_ITEM_FRACTION of the budget;
+// anything bigger (like the clock face) isn't worth crowding out the
+// rest for.
+#define RLE_CACHE_ITEM_FRACTION 4
+
 typedef struct {
-  RBuffer *rb;
-  int n;
-  int b;
-  int bi;
-  bool zero_expands;
-} Rl2Unpacker;
+  int resource_id;         // 0 if the entry is unused
+  size_t size;
+  unsigned int last_used;  // the value of rle_cache_clock when last used
+  uint8_t *data;
+} RleCacheEntry;
+
+static RleCacheEntry rle_cache[RLE_CACHE_MAX_ENTRIES];
+static size_t rle_cache_budget = RLE_CACHE_BUDGET;
+static unsigned int rle_cache_clock = 0;
+size_t rle_cache_bytes = 0;
+int rle_cache_hits = 0;
+int rle_cache_misses = 0;
+
+// Frees the indicated cache entry.
+static void rle_cache_evict(RleCacheEntry *entry) {
+  rle_cache_bytes -= entry->size;
+  free(entry->data);
+  entry->resource_id = 0;
+  entry->size = 0;
+  entry->data = NULL;
+}
 
-static void rl2unpacker_init(Rl2Unpacker *rl2, RBuffer *rb, int n, bool zero_expands) {
-  // assumption: n is an integer divisor of 8.
-  assert(n * (8 / n) == 8);
+// Evicts the least recently used entries until there is an unused
+// entry and room within the budget for size more bytes, and returns
+// that entry, or NULL if the budget is too small.
+static RleCacheEntry *rle_cache_make_room(size_t size) {
+  while (true) {
+    RleCacheEntry *unused = NULL;
+    RleCacheEntry *oldest = NULL;
+    for (int i = 0; i < RLE_CACHE_MAX_ENTRIES; ++i) {
+      RleCacheEntry *entry = &rle_cache[i];
+      if (entry->resource_id == 0) {
+        if (unused == NULL) {
+          unused = entry;
+        }
+      } else if (oldest == NULL || rle_cache_clock - entry->last_used > rle_cache_clock - oldest->last_used) {
+        oldest = entry;
+      }
+    }
+    if (unused != NULL && rle_cache_bytes + size <= rle_cache_budget) {
+      return unused;
+    }
+    if (oldest == NULL) {
+      return NULL;
+    }
+    rle_cache_evict(oldest);
+  }
+}
 
-  rl2->rb = rb;
-  rl2->n = n;
-  rl2->b = rbuffer_getc(rb);
-  rl2->bi = 8;
-  rl2->zero_expands = zero_expands;
+// Changes the number of bytes the cache may hold, evicting entries as
+// needed to fit.  A budget of 0 turns the cache off.
+void rle_cache_set_budget(size_t budget) {
+  rle_cache_budget = budget;
+  while (rle_cache_bytes > rle_cache_budget) {
+    rle_cache_make_room(0);
+  }
 }
 
-// Gets the next integer from the rl2 encoding.  Returns EOF at end.
-static int rl2unpacker_getc(Rl2Unpacker *rl2) {
-  if (rl2->b == EOF) {
-    return EOF;
+// Evicts the least recently used entry, and lowers the budget to what
+// remains, as bwd_cache_shrink() does.  Returns false if the cache was
+// empty.
+bool rle_cache_shrink() {
+  if (rle_cache_bytes == 0) {
+    return false;
   }
+  rle_cache_set_budget(rle_cache_bytes - 1);
+  rle_cache_budget = rle_cache_bytes;
+  return true;
+}
 
-  // First, count the number of zero chunks until we come to a nonzero chunk.
-  int zero_count = 0;
-  int bmask = (1 << rl2->n) - 1;
-  int bv = (rl2->b & (bmask << (rl2->bi - rl2->n)));
-  if (rl2->zero_expands) {
-    while (bv == 0) {
-      ++zero_count;
-      rl2->bi -= rl2->n;
-      if (rl2->bi <= 0) {
-        rl2->b = rbuffer_getc(rl2->rb);
-        rl2->bi = 8;
-        if (rl2->b == EOF) {
-          return EOF;
-        }
+// Empties the cache.
+void rle_cache_clear() {
+  for (int i = 0; i < RLE_CACHE_MAX_ENTRIES; ++i) {
+    if (rle_cache[i].resource_id != 0) {
+      rle_cache_evict(&rle_cache[i]);
+    }
+  }
+}
+
+#endif  // SUPPORT_RLE_CACHE
+
+// Begins reading the indicated rle resource: from the rle cache if
+// it's there, or else from the resource file, in which case a small
+// enough resource is loaded whole and added to the cache on the way.
+// If window is not NULL, the resource is instead loaded through it,
+// and not added to the cache, so that nothing is allocated.  Should
+// be matched by a later call to rbuffer_deinit().
+static void rbuffer_init_rle(RBuffer *rb, int resource_id, RleWindow *window) {
+#ifdef SUPPORT_RLE_CACHE
+  ++rle_cache_clock;
+  for (int i = 0; i < RLE_CACHE_MAX_ENTRIES; ++i) {
+    RleCacheEntry *entry = &rle_cache[i];
+    if (entry->resource_id == resource_id) {
+      ++rle_cache_hits;
+      entry->last_used = rle_cache_clock;
+      rbuffer_init_data(rb, entry->data, entry->size);
+      return;
+    }
+  }
+
+  ++rle_cache_misses;
+  ResHandle rh = resource_get_handle(resource_id);
+  size_t size = resource_size(rh);
+  if (window == NULL && size <= rle_cache_budget / RLE_CACHE_ITEM_FRACTION) {
+    RleCacheEntry *entry = rle_cache_make_room(size);
+    uint8_t *data = (entry != NULL) ? (uint8_t *)malloc(size) : NULL;
+    if (data != NULL) {
+      size_t bytes_read = resource_load(rh, data, size);
+      ++bwd_load_calls;
+      bwd_load_bytes += bytes_read;
+      if (bytes_read == size) {
+        entry->resource_id = resource_id;
+        entry->size = size;
+        entry->last_used = rle_cache_clock;
+        entry->data = data;
+        rle_cache_bytes += size;
+        rbuffer_init_data(rb, data, size);
+        return;
       }
-      bv = (rl2->b & (bmask << (rl2->bi - rl2->n)));
+      free(data);
     }
   }
+#endif  // SUPPORT_RLE_CACHE
 
-  // Infer from that the number of chunks, and hence the number of
-  // bits, that make up the value we will extract.
-  int num_chunks = (zero_count + 1);
-  int bit_count = num_chunks * rl2->n;
+  rbuffer_init_resource(rb, resource_id, 0);
+  if (window != NULL) {
+    rbuffer_lend_window(rb, window);
+  }
+}
 
-  // OK, now we need to extract the next bitCount bits into a word.
-  int result = 0;
-  while (bit_count >= rl2->bi) {
-    int mask = (1 << rl2->bi) - 1;
-    int value = (rl2->b & mask);
-    result = (result << rl2->bi) | value;
-    bit_count -= rl2->bi;
-
-    rl2->b = rbuffer_getc(rl2->rb);
-    rl2->bi = 8;
-    if (rl2->b == EOF) {
-      break;
+// The rle header, and the optional row index that follows it.  See
+// make_rle.py.
+#define RLE_HEADER_SIZE 8
+#define RLE_HEADER_SIZE_V2 18
+#define RLE_FORMAT_ROW_INDEX 0x80
+#define RLE_ROW_INDEX_ENTRY_SIZE 7
+
+// The ways the pixels may be coded before they are run-length
+// encoded.  A v1 file always uses RLE_CODEC_RUNS.
+#define RLE_CODEC_RUNS 0      // as they are
+#define RLE_CODEC_XOR_ROWS 1  // each row XORed with the row above
+#define RLE_CODEC_UNKNOWN 0xff
+
+// The fields of either version of the rle header.
+typedef struct {
+  int width;
+  int height;
+  int n;             // without the unscreen flag
+  bool do_unscreen;
+  int format;        // without the row index flag
+  bool has_index;
+  int codec;
+  size_t vo;         // offset to the values
+  size_t po;         // offset to the palette
+  size_t size;       // the size of the header itself
+} RleHeader;
+
+// Reads the rle header from the beginning of rb, which may be a v1
+// header:
+//         (uint8_t)  width
+//         (uint8_t)  height
+//         (uint8_t)  n (number of chunks of pixels to take at a time; unscreen if 0x80 set)
+//         (uint8_t)  format (GBitmapFormat; row index follows if 0x80 set)
+//         (uint16_t) offset to start of values
+//         (uint16_t) offset to start of palette
+// or a v2 header:
+//         (uint8_t)  0
+//         (uint8_t)  version (2)
+//         (uint8_t)  codec
+//         (uint8_t)  n
+//         (uint8_t)  format
+//         (uint8_t)  reserved
+//         (uint16_t) width
+//         (uint16_t) height
+//         (uint32_t) offset to start of values
+//         (uint32_t) offset to start of palette
+// (NB: All fields are little-endian.)  On return, rb is positioned
+// just past the header.  If the header isn't one we understand, codec
+// is RLE_CODEC_UNKNOWN.
+static void rle_read_header(RBuffer *rb, RleHeader *header) {
+  int n, format_byte;
+  header->width = rbuffer_getc(rb);
+  if (header->width != 0) {
+    // A v1 header.
+    header->height = rbuffer_getc(rb);
+    n = rbuffer_getc(rb);
+    format_byte = rbuffer_getc(rb);
+    header->vo = rbuffer_get_uint(rb, 2);
+    header->po = rbuffer_get_uint(rb, 2);
+    header->codec = RLE_CODEC_RUNS;
+    header->size = RLE_HEADER_SIZE;
+  } else {
+    // A v2 header.
+    int version = rbuffer_getc(rb);
+    header->codec = rbuffer_getc(rb);
+    n = rbuffer_getc(rb);
+    format_byte = rbuffer_getc(rb);
+    /*int reserved = */rbuffer_getc(rb);
+    header->width = rbuffer_get_uint(rb, 2);
+    header->height = rbuffer_get_uint(rb, 2);
+    header->vo = rbuffer_get_uint(rb, 4);
+    header->po = rbuffer_get_uint(rb, 4);
+    header->size = RLE_HEADER_SIZE_V2;
+    if (version != 2 || header->codec > RLE_CODEC_XOR_ROWS) {
+      header->codec = RLE_CODEC_UNKNOWN;
     }
   }
 
-  if (bit_count > 0) {
-    // A partial word in the middle of the byte.
-    int bottom_count = rl2->bi - bit_count;
-    assert(bottom_count > 0);
-    int mask = ((1 << bit_count) - 1);
-    int value = ((rl2->b >> bottom_count) & mask);
-    result = (result << bit_count) | value;
-    rl2->bi -= bit_count;
+  header->do_unscreen = (n & 0x80) != 0;
+  header->n = n & 0x7f;
+  header->has_index = (format_byte & RLE_FORMAT_ROW_INDEX) != 0;
+  header->format = format_byte & ~RLE_FORMAT_ROW_INDEX;
+}
+
+// A place in the rle data at which decoding can begin: the first
+// pixel of row.
+typedef struct {
+  int row;
+  size_t offset;    // the byte holding the run that contains the pixel
+  int bit;          // the bit of that byte at which the run begins
+  int skip;         // the number of pixels of the run before the pixel
+  int value;        // the value of the run, for a 1-bit image
+  int value_index;  // the index of the run's value, for other images
+} RleRowStart;
+
+// Reads the row index, if the header said there is one (rb should be
+// just past the header), and fills in start with the last indexed row
+// at or before row y.  Without an index, that's row 0.  one_bit should
+// be true for a 1-bit image, which begins with an implicit black
+// pixel.  On return, rb is positioned at start->offset.
+static void rle_find_row_start(RBuffer *rb, const RleHeader *header, int y, bool one_bit, RleRowStart *start) {
+  start->row = 0;
+  start->offset = header->size;
+  start->bit = 0;
+  start->skip = one_bit ? 1 : 0;
+  start->value = 0;
+  start->value_index = 0;
+
+  if (header->has_index) {
+    int rows = rbuffer_getc(rb);
+    int num_entries = rbuffer_getc(rb);
+    assert(rows > 0 && num_entries != EOF);
+    start->offset += 2 + num_entries * RLE_ROW_INDEX_ENTRY_SIZE;
+
+    int ei = y / rows;
+    if (ei > num_entries) {
+      ei = num_entries;
+    }
+    if (ei > 0) {
+      uint8_t entry[RLE_ROW_INDEX_ENTRY_SIZE];
+      rbuffer_seek(rb, header->size + 2 + (ei - 1) * RLE_ROW_INDEX_ENTRY_SIZE);
+      for (int i = 0; i < RLE_ROW_INDEX_ENTRY_SIZE; ++i) {
+        entry[i] = rbuffer_getc(rb);
+      }
+      start->row = ei * rows;
+      start->offset = entry[0] | (entry[1] << 8);
+      start->bit = entry[2] & 0x7;
+      start->value = (entry[2] >> 7);
+      start->skip = entry[3] | (entry[4] << 8);
+      start->value_index = entry[5] | (entry[6] << 8);
+    }
   }
 
-  return result;
+  rbuffer_seek(rb, start->offset);
 }
 
-// Xors the image in-place a 1x1 checkerboard pattern.  The idea is to
-// eliminate this kind of noise from the source image if it happens to
-// be present.
-void unscreen_bitmap(GBitmap *image) {
-  int height = gbitmap_get_bounds(image).size.h;
-  int width = gbitmap_get_bounds(image).size.w;
-  int width_bytes = width / 8;
-  int stride = gbitmap_get_bytes_per_row(image); // multiple of 4, by Pebble convention.
-  uint8_t *data = gbitmap_get_data(image);
+// Used to unpack the integers of an rl2-encoding back into their
+// original rle sequence.  See make_rle.py.  Rather than walking the
+// source one byte at a time, we keep a 32-bit reservoir of unread
+// bits, left-justified, and top it up a byte at a time straight from
+// the RBuffer's memory.  A run of zero chunks can then be counted with
+// a single CLZ instruction.
+typedef struct {
+  RBuffer *rb;
+  int n;
+  uint32_t bits;   // unread bits, beginning at the high bit
+  int bits_left;   // number of valid bits in bits
+} Rl2Unpacker;
+
+static void rl2unpacker_init(Rl2Unpacker *rl2, RBuffer *rb, int n) {
+  // assumption: n is an integer divisor of 8.
+  assert(n * (8 / n) == 8);
 
-  uint8_t mask = 0xaa;
-  for (int y = 0; y < height; ++y) {
-    uint8_t *p = data + y * stride;
-    for (int x = 0; x < width_bytes; ++x) {
-      (*p) ^= mask;
-      ++p;
+  // We don't read anything yet; the caller might still split rb.
+  rl2->rb = rb;
+  rl2->n = n;
+  rl2->bits = 0;
+  rl2->bits_left = 0;
+}
+
+// Fills the reservoir with at least 25 bits, or with whatever remains
+// of the RBuffer.  bits_left always stays a multiple of n.
+static inline void rl2unpacker_refill(Rl2Unpacker *rl2) {
+  RBuffer *rb = rl2->rb;
+  while (rl2->bits_left <= 24) {
+    int c;
+    if (rb->_i < rb->_filled_size) {
+      c = rb->_data[rb->_i];
+      rb->_i++;
+    } else {
+      c = rbuffer_getc(rb);
+      if (c == EOF) {
+        return;
+      }
     }
-    mask ^= 0xff;
+    rl2->bits |= (uint32_t)c << (24 - rl2->bits_left);
+    rl2->bits_left += 8;
   }
 }
 
-typedef void Packer(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop);
+// Discards the first bit bits of the current byte, to begin reading
+// partway through it.  bit must be a multiple of n, and less than 8;
+// this must be called before anything else is read.
+static void rl2unpacker_skip_bits(Rl2Unpacker *rl2, int bit) {
+  assert(rl2->bits_left == 0 && bit % rl2->n == 0 && bit < 8);
+  if (bit != 0) {
+    rl2unpacker_refill(rl2);
+    rl2->bits <<= bit;
+    rl2->bits_left -= bit;
+  }
+}
 
-// Packs a series of identical 1-bit values into (*dp) beginning at bit (*b).
-void pack_1bit(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop) {
-  assert(*dp < dp_stop);
+// Gets the next integer from the rl2 encoding, in which a series of
+// zero chunks introduces a value of that many more chunks.  Returns
+// EOF at end.
+static inline int rl2unpacker_getc(Rl2Unpacker *rl2) {
+  BWD_STATS_INC(rl2_getc_calls);
+  if (rl2->bits_left <= 24) {
+    rl2unpacker_refill(rl2);
+  }
 
-  if (value) {
+  // First, count the number of zero bits until we come to a nonzero
+  // chunk.  Bits beyond bits_left are always 0.
+  int zero_bits = 0;
+  while (rl2->bits == 0) {
+    if (rl2->bits_left == 0) {
+      return EOF;
+    }
+    zero_bits += rl2->bits_left;
+    rl2->bits_left = 0;
+    rl2unpacker_refill(rl2);
+  }
+  int z = __builtin_clz(rl2->bits) & ~(rl2->n - 1);
+  rl2->bits <<= z;
+  rl2->bits_left -= z;
+  zero_bits += z;
+
+  // Infer from that the number of bits that make up the value we
+  // will extract.
+  int bit_count = zero_bits + rl2->n;
+  if (bit_count > rl2->bits_left) {
+    rl2unpacker_refill(rl2);
+  }
+
+  if (bit_count <= rl2->bits_left) {
+    // The usual case: the whole value is already in the reservoir.
+    int result = rl2->bits >> (32 - bit_count);
+    rl2->bits = (bit_count < 32) ? (rl2->bits << bit_count) : 0;
+    rl2->bits_left -= bit_count;
+    return result;
+  }
+
+  // A very long value, or one truncated by the end of the data.  Take
+  // it a piece at a time.
+  int result = 0;
+  while (bit_count > 0 && rl2->bits_left > 0) {
+    int take = (bit_count < rl2->bits_left) ? bit_count : rl2->bits_left;
+    if (take > 16) {
+      take = 16;
+    }
+    result = (result << take) | (rl2->bits >> (32 - take));
+    rl2->bits <<= take;
+    rl2->bits_left -= take;
+    bit_count -= take;
+    rl2unpacker_refill(rl2);
+  }
+  return result;
+}
+
+#ifndef PBL_BW
+// Gets the next n-bit chunk, as it is, without the zero-expansion of
+// rl2unpacker_getc().  This is used for the values list of a 2-, 4-,
+// or 8-bit file.  Returns EOF at end.
+static inline int rl2unpacker_get_chunk(Rl2Unpacker *rl2) {
+  BWD_STATS_INC(rl2_getc_calls);
+  if (rl2->bits_left < rl2->n) {
+    rl2unpacker_refill(rl2);
+    if (rl2->bits_left < rl2->n) {
+      return EOF;
+    }
+  }
+  int result = rl2->bits >> (32 - rl2->n);
+  rl2->bits <<= rl2->n;
+  rl2->bits_left -= rl2->n;
+  return result;
+}
+#endif  // PBL_BW
+
+// Packs a series of identical 1-bit values into (*dp) beginning at bit (*b).
+static inline void pack_1bit(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop) {
+  assert(*dp < dp_stop);
+
+  if (value) {
     // Generate count 1-bits.
     int b1 = (*b) + count;
     if (b1 < 8) {
@@ -436,12 +1332,40 @@ void pack_1bit(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop) {
   }
 }
 
+// Unpacks a 1-bit file: the rle counts alternate between runs of 0
+// and runs of 1, beginning with 0.
+static void rle_unpack_1bit(Rl2Unpacker *rl2, uint8_t *dp, uint8_t *dp_stop) {
+  int b = 0;
+
+  int count = rl2unpacker_getc(rl2);
+  if (count != EOF) {
+    assert(count > 0);
+    // We discard the first, implicit black pixel; it's not part of the image.
+    --count;
+  }
+  while (count != EOF) {
+    // Skip over a run of 0-bits.
+    b += count;
+    dp += b / 8;
+    b = b % 8;
+
+    count = rl2unpacker_getc(rl2);
+    if (count == EOF) {
+      break;
+    }
+    pack_1bit(1, count, &b, &dp, dp_stop);
+    count = rl2unpacker_getc(rl2);
+  }
+
+  assert(dp == dp_stop && b == 0);
+}
+
 #ifndef PBL_BW
 // The following functions are needed for unpacking advanced color
 // modes not needed on B&W watches.
 
 // Packs a series of identical 2-bit values into (*dp) beginning at bit (*b).
-void pack_2bit(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop) {
+static inline void pack_2bit(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop) {
   assert(*dp < dp_stop);
 
   if (value != 0) {
@@ -484,7 +1408,7 @@ void pack_2bit(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop) {
 
 
 // Packs a series of identical 4-bit values into (*dp) beginning at bit (*b).
-void pack_4bit(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop) {
+static inline void pack_4bit(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop) {
   assert(*dp < dp_stop);
 
   if (value != 0) {
@@ -520,7 +1444,7 @@ void pack_4bit(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop) {
 }
 
 // Packs a series of identical 8-bit values into (*dp).
-void pack_8bit(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop) {
+static inline void pack_8bit(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop) {
   assert(*dp < dp_stop);
 
   while (count > 0 && (*dp) < dp_stop) {
@@ -531,76 +1455,265 @@ void pack_8bit(int value, int count, int *b, uint8_t **dp, uint8_t *dp_stop) {
   }
 }
 
-// Initialize a bitmap from an rle-encoded resource.  The returned
-// bitmap must be released with bwd_destroy().  See make_rle.py for
-// the program that generates these rle sequences.
+// Unpacks a 2-bit file: each rle count is paired with a 2-bit value
+// from the values list.
+static void rle_unpack_2bit(Rl2Unpacker *rl2, Rl2Unpacker *rl2_vo, uint8_t *dp, uint8_t *dp_stop) {
+  int b = 0;
+  int count = rl2unpacker_getc(rl2);
+  while (count != EOF) {
+    int value = rl2unpacker_get_chunk(rl2_vo);
+    pack_2bit(value, count, &b, &dp, dp_stop);
+    count = rl2unpacker_getc(rl2);
+  }
+  assert(dp == dp_stop && b == 0);
+}
+
+// Unpacks a 4-bit file: each rle count is paired with a 4-bit value
+// from the values list.
+static void rle_unpack_4bit(Rl2Unpacker *rl2, Rl2Unpacker *rl2_vo, uint8_t *dp, uint8_t *dp_stop) {
+  int b = 0;
+  int count = rl2unpacker_getc(rl2);
+  while (count != EOF) {
+    int value = rl2unpacker_get_chunk(rl2_vo);
+    pack_4bit(value, count, &b, &dp, dp_stop);
+    count = rl2unpacker_getc(rl2);
+  }
+  assert(dp == dp_stop && b == 0);
+}
+
+// Unpacks an 8-bit file: each rle count is paired with an 8-bit value
+// from the values list.
+static void rle_unpack_8bit(Rl2Unpacker *rl2, Rl2Unpacker *rl2_vo, uint8_t *dp, uint8_t *dp_stop) {
+  int b = 0;
+  int count = rl2unpacker_getc(rl2);
+  while (count != EOF) {
+    int value = rl2unpacker_get_chunk(rl2_vo);
+    pack_8bit(value, count, &b, &dp, dp_stop);
+    count = rl2unpacker_getc(rl2);
+  }
+  assert(dp == dp_stop && b == 0);
+}
+
+#endif  // PBL_BW
+
+// Packs a run of count identical values into a row, beginning at
+// pixel x.  vn is the number of bits per pixel, or 0 for a 1-bit
+// image.
+static inline void pack_run_at(uint8_t *row, uint8_t *row_stop, int vn, int value, int x, int count) {
+  int bit = x * ((vn == 0) ? 1 : vn);
+  uint8_t *dp = row + bit / 8;
+  int b = bit % 8;
+  switch (vn) {
+  case 0:
+    pack_1bit(value, count, &b, &dp, row_stop);
+    break;
+
+#ifndef PBL_BW
+  case 2:
+    pack_2bit(value, count, &b, &dp, row_stop);
+    break;
+
+  case 4:
+    pack_4bit(value, count, &b, &dp, row_stop);
+    break;
+
+  case 8:
+    pack_8bit(value, count, &b, &dp, row_stop);
+    break;
+#endif  // PBL_BW
+  }
+}
+
+// As pack_run_at(), but the pixels of the row before mirror_width are
+// mirrored: pixel x goes to mirror_width - 1 - x.  Since a run is all
+// one value, its mirror image is simply the same run, ending where it
+// would have begun; no bits need to be reversed.
+static inline void pack_run_mirrored(uint8_t *row, uint8_t *row_stop, int vn, int value, int x, int count, int mirror_width) {
+  if (x < mirror_width) {
+    int mirrored = (x + count < mirror_width) ? count : mirror_width - x;
+    pack_run_at(row, row_stop, vn, value, mirror_width - x - mirrored, mirrored);
+    x += mirrored;
+    count -= mirrored;
+  }
+  if (count > 0) {
+    pack_run_at(row, row_stop, vn, value, x, count);
+  }
+}
+
+// Unpacks an image a row at a time, writing each row straight into
+// its final place in data (which must be zeroed): upside-down if
+// flip_y, and mirrored within the image width if flip_x.  An
+// RLE_CODEC_XOR_ROWS row is XORed with the row above, and an
+// unscreened row gets its checkerboard back, while the row is still at
+// hand, so each byte of the image is finished in one visit.  vn is
+// the number of bits per value, or 0 for a 1-bit image; rl2_vo is only
+// used if vn is nonzero.  skip is the number of pixels to discard from
+// the first run, as in RleRowStart.
+static void rle_unpack_rows(Rl2Unpacker *rl2, Rl2Unpacker *rl2_vo, int vn, int skip, const RleHeader *header, uint8_t *data, int stride, bool flip_x, bool flip_y) {
+  int height = header->height;
+  int stream_width = stride * 8 / ((vn == 0) ? 1 : vn);
+  int mirror_width = flip_x ? header->width : 0;
+  int unscreen_bytes = header->do_unscreen ? header->width / 8 : 0;
+  // Unscreening is only ever applied to 1-bit images (see unscreen()
+  // in make_rle.py).  Mirroring a byte-aligned row swaps the phase of
+  // the checkerboard.
+  assert(unscreen_bytes == 0 || (vn == 0 && (!flip_x || header->width % 8 == 0)));
+  uint8_t mask_phase = flip_x ? 0xff : 0x00;
+
+  // count is the number of pixels remaining in the current run, and
+  // value is its value.  Runs continue from one row to the next.
+  int value = 0;
+  int count = rl2unpacker_getc(rl2);
+  if (count != EOF) {
+    count -= skip;
+  }
+#ifndef PBL_BW
+  if (vn != 0) {
+    value = rl2unpacker_get_chunk(rl2_vo);
+  }
+#endif  // PBL_BW
+
+  const uint8_t *prev_row = NULL;
+  uint8_t prev_mask = 0;
+  for (int y = 0; y < height; ++y) {
+    uint8_t *row = data + (flip_y ? height - 1 - y : y) * stride;
+    uint8_t *row_stop = row + stride;
+    int x = 0;
+    while (x < stream_width && count != EOF) {
+      if (count == 0) {
+        // On to the next run.
+        count = rl2unpacker_getc(rl2);
+#ifndef PBL_BW
+        if (vn != 0) {
+          value = rl2unpacker_get_chunk(rl2_vo);
+          continue;
+        }
+#endif  // PBL_BW
+        value = 1 - value;
+        continue;
+      }
+
+      int span = stream_width - x;
+      if (span > count) {
+        span = count;
+      }
+      if (value != 0) {
+        pack_run_mirrored(row, row_stop, vn, value, x, span, mirror_width);
+      }
+      x += span;
+      count -= span;
+    }
+
+    // An unscreened image gets the checkerboard pattern of unscreen()
+    // in make_rle.py XORed back over the first width / 8 bytes of
+    // each row.
+    uint8_t mask = (((y & 1) ? 0x55 : 0xaa) ^ mask_phase);
+    if (header->codec == RLE_CODEC_XOR_ROWS && prev_row != NULL) {
+      // The row above has already been unscreened, but this row was
+      // encoded against it before that.
+      for (int i = 0; i < stride; ++i) {
+        row[i] ^= prev_row[i];
+      }
+      for (int i = 0; i < unscreen_bytes; ++i) {
+        row[i] ^= prev_mask;
+      }
+    }
+    for (int i = 0; i < unscreen_bytes; ++i) {
+      row[i] ^= mask;
+    }
+    prev_row = row;
+    prev_mask = mask;
+  }
+}
+
+#ifndef PBL_BW
+
+// Initialize a bitmap from an rle-encoded resource, flipped and
+// remapped as requested (see rle_bwd_create_transformed()).  If
+// buffer is not NULL, the image is decoded into it (see
+// rle_bwd_create_into()) and the returned bitmap is the buffer's;
+// otherwise the returned bitmap must be released with bwd_destroy().
+// See make_rle.py for the program that generates these rle sequences.
 BitmapWithData
-rle_bwd_create_rb(RBuffer *rb) {
-  // RLE header (NB: All fields are little-endian)
-  //         (uint8_t)  width
-  //         (uint8_t)  height
-  //         (uint8_t)  n (number of chunks of pixels to take at a time; unscreen if 0x80 set)
-  //         (uint8_t)  format (see below)
-  //         (uint16_t) offset to start of values, or 0 if format == 0
-  //         (uint16_t) offset to start of palette, or 0 if format <= 1
-
-  int width = rbuffer_getc(rb);
-  int height = rbuffer_getc(rb);
-  int n = rbuffer_getc(rb);
-  GBitmapFormat format = (GBitmapFormat)rbuffer_getc(rb);
-
-  uint8_t vo_lo = rbuffer_getc(rb);
-  uint8_t vo_hi = rbuffer_getc(rb);
-  unsigned int vo = (vo_hi << 8) | vo_lo;
-
-  uint8_t po_lo = rbuffer_getc(rb);
-  uint8_t po_hi = rbuffer_getc(rb);
-  unsigned int po = (po_hi << 8) | po_lo;
+rle_bwd_create_rb(RBuffer *rb, bool flip_x, bool flip_y, const BwdRemap *remap, BitmapWithData *buffer, uint16_t *capacity, GSize max_size) {
+  // See rle_read_header() for the layout of the header, which is
+  // followed by the row index, if RLE_FORMAT_ROW_INDEX is set in
+  // format.
+  RleHeader header;
+  rle_read_header(rb, &header);
+  if (header.codec == RLE_CODEC_UNKNOWN) {
+    qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "cannot support rle codec");
+    return bwd_create(NULL, NULL);
+  }
 
+  int width = header.width;
+  int height = header.height;
+  int n = header.n;
+  GBitmapFormat format = (GBitmapFormat)header.format;
+  size_t vo = header.vo;
+  size_t po = header.po;
   assert(vo != 0 && po >= vo && po <= rb->_total_size);
 
-  int do_unscreen = (n & 0x80);
-  n = n & 0x7f;
-
-  Packer *packer_func = NULL;
   size_t palette_count = 0;
   int vn = 0;
-#ifdef PBL_BW
-    packer_func = pack_1bit;
-#else  // PBL_BW
   switch (format) {
   case GBitmapFormat1BitPalette:
     palette_count = 2;
-    // fall through.
+    break;
+
   case GBitmapFormat1Bit:
-    packer_func = pack_1bit;
     break;
 
   case GBitmapFormat2BitPalette:
     vn = 2;
     palette_count = 4;
-    packer_func = pack_2bit;
     break;
 
   case GBitmapFormat4BitPalette:
     vn = 4;
     palette_count = 16;
-    packer_func = pack_4bit;
     break;
 
   case GBitmapFormat8Bit:
   case GBitmapFormat8BitCircular:
     vn = 8;
-    packer_func = pack_8bit;
     break;
   }
-#endif  // PBL_BW
-  assert(packer_func != NULL);
 
+  // We're decoding the whole image, so we just skip over the row
+  // index, if any.
+  RleRowStart start;
+  rle_find_row_start(rb, &header, 0, (vn == 0), &start);
+
+  // If the palette is remapped, the original colors are kept just
+  // after it, in the same block, so that it can be remapped again
+  // later (see bwd_recolor()).
   GColor *palette = NULL;
+  GColor *original_palette = NULL;
   GBitmap *image = NULL;
-  if (palette_count != 0) {
+  unsigned char *palette_block = NULL;
+  if (buffer != NULL) {
+    image = bwd_prepare_buffer(buffer, capacity, max_size, GSize(width, height), format, palette_count != 0);
+    if (image == NULL) {
+      return bwd_create(NULL, NULL);
+    }
+    palette = gbitmap_get_palette(image);
+    if (buffer->data != NULL) {
+      original_palette = palette + palette_count;
+    }
+  } else if (palette_count != 0 && remap != NULL) {
+    palette = (GColor *)malloc(2 * palette_count * sizeof(GColor));
+    if (palette == NULL) {
+      return bwd_create(NULL, NULL);
+    }
+    image = gbitmap_create_blank_with_palette(GSize(width, height), format, palette, false);
+    original_palette = palette + palette_count;
+    palette_block = (unsigned char *)palette;
+  } else if (palette_count != 0) {
     palette = (GColor *)malloc(palette_count * sizeof(GColor));
+    if (palette == NULL) {
+      return bwd_create(NULL, NULL);
+    }
     image = gbitmap_create_blank_with_palette(GSize(width, height), format, palette, true);
   } else {
     image = gbitmap_create_blank(GSize(width, height), format);
@@ -611,122 +1724,134 @@ rle_bwd_create_rb(RBuffer *rb) {
     qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "could not create image of size %dx%d and format %d with palette %p", width, height, format, palette);
     return bwd_create(NULL, NULL);
   }
+  rbuffer_widen_window(rb);
   int stride = gbitmap_get_bytes_per_row(image);
   uint8_t *bitmap_data = gbitmap_get_data(image);
   assert(bitmap_data != NULL);
   size_t data_size = height * stride;
 
-  Rl2Unpacker rl2;
-  rl2unpacker_init(&rl2, rb, n, true);
-
   // The values start at vo; this means the original rb buffer gets
   // shortened to that point.  We also create a new rb_vo buffer to
-  // read the values data which begins at vo.
+  // read the values data which begins at vo, and likewise an rb_po
+  // buffer for the palette at po.  These are split before any
+  // unpacking begins, since the Rl2Unpackers read a few bytes ahead.
   RBuffer rb_vo;
   rbuffer_split(rb, &rb_vo, vo);
-
-  Rl2Unpacker rl2_vo;
-  if (vn != 0) {
-    rl2unpacker_init(&rl2_vo, &rb_vo, vn, false);
+  RBuffer rb_po;
+  if (palette_count != 0) {
+    rbuffer_split(&rb_vo, &rb_po, po);
   }
 
-  uint8_t *dp = bitmap_data;
-  uint8_t *dp_stop = dp + data_size;
-  int b = 0;
+  Rl2Unpacker rl2;
+  rl2unpacker_init(&rl2, rb, n);
 
-  if (packer_func == pack_1bit) {
-    // Unpack a 1-bit file.
+  Rl2Unpacker rl2_vo = { NULL, 0, 0, 0 };
+  if (vn != 0) {
+    rl2unpacker_init(&rl2_vo, &rb_vo, vn);
+  }
 
-    // The initial value is 0.
-    int value = 0;
-    int count = rl2unpacker_getc(&rl2);
-    if (count != EOF) {
-      assert(count > 0);
-      // We discard the first, implicit black pixel; it's not part of the image.
-      --count;
-    }
-    while (count != EOF) {
-      pack_1bit(value, count, &b, &dp, dp_stop);
-      value = 1 - value;
-      count = rl2unpacker_getc(&rl2);
-    }
+  if (flip_x || flip_y || header.codec != RLE_CODEC_RUNS || header.do_unscreen) {
+    // Anything more than a plain decode is done a row at a time.
+    rle_unpack_rows(&rl2, &rl2_vo, vn, start.skip, &header, bitmap_data, stride, flip_x, flip_y);
 
   } else {
-    // Unpack a 2-, 4-, or 8-bit file.
+    // Choose the unpacking loop once for the whole image.
+    uint8_t *dp = bitmap_data;
+    uint8_t *dp_stop = dp + data_size;
+    switch (vn) {
+    case 0:
+      rle_unpack_1bit(&rl2, dp, dp_stop);
+      break;
 
-    // Begin reading.
-    int count = rl2unpacker_getc(&rl2);
-    while (count != EOF) {
-      int value = rl2unpacker_getc(&rl2_vo);
-      (*packer_func)(value, count, &b, &dp, dp_stop);
-      count = rl2unpacker_getc(&rl2);
-    }
-  }
+    case 2:
+      rle_unpack_2bit(&rl2, &rl2_vo, dp, dp_stop);
+      break;
 
-  //  qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "wrote %d bytes", dp - bitmap_data);
-  assert(dp == dp_stop && b == 0);
+    case 4:
+      rle_unpack_4bit(&rl2, &rl2_vo, dp, dp_stop);
+      break;
 
-  if (do_unscreen) {
-    unscreen_bitmap(image);
+    case 8:
+      rle_unpack_8bit(&rl2, &rl2_vo, dp, dp_stop);
+      break;
+    }
   }
 
   if (palette_count != 0) {
-    // Now we need to apply the palette.
-    RBuffer rb_po;
-    rbuffer_split(&rb_vo, &rb_po, po);
+    // Now we need to apply the palette, remapping it as we go.
     for (int i = 0; i < (int)palette_count; ++i) {
       palette[i].argb = rbuffer_getc(&rb_po);
     }
     rbuffer_deinit(&rb_po);
+    if (remap != NULL) {
+      if (original_palette != NULL) {
+        memcpy(original_palette, palette, palette_count * sizeof(GColor));
+      }
+      remap_palette(palette, palette_count, remap);
+    }
+  } else if (remap != NULL) {
+    // As in bwd_remap_colors().
+    qapp_log(APP_LOG_LEVEL_WARNING, __FILE__, __LINE__, "rle_bwd_create_rb cannot adjust non-palette format %d", format);
   }
 
   rbuffer_deinit(&rb_vo);
 
-  return bwd_create(image, NULL);
+  return bwd_create(image, palette_block);
 }
 
 #else  // PBL_BW
 
 // Here's the simpler mono implementation, which only supports GColorFormat1Bit.
 
-// Initialize a bitmap from an rle-encoded resource.  The returned
-// bitmap must be released with bwd_destroy().  See make_rle.py for
-// the program that generates these rle sequences.
+// Initialize a bitmap from an rle-encoded resource, flipped and
+// remapped as requested (see rle_bwd_create_transformed()).  If
+// buffer is not NULL, the image is decoded into it (see
+// rle_bwd_create_into()) and the returned bitmap is the buffer's;
+// otherwise the returned bitmap must be released with bwd_destroy().
+// See make_rle.py for the program that generates these rle sequences.
 BitmapWithData
-rle_bwd_create_rb(RBuffer *rb) {
-  // RLE header (NB: All fields are little-endian)
-  //         (uint8_t)  width
-  //         (uint8_t)  height
-  //         (uint8_t)  n (number of chunks of pixels to take at a time; unscreen if 0x80 set)
-  //         (uint8_t)  format (see below)
-  //         (uint16_t) offset to start of values, or 0 if format == 0
-  //         (uint16_t) offset to start of palette, or 0 if format <= 1
-
-  int width = rbuffer_getc(rb);
-  int height = rbuffer_getc(rb);
+rle_bwd_create_rb(RBuffer *rb, bool flip_x, bool flip_y, const BwdRemap *remap, BitmapWithData *buffer, uint16_t *capacity, GSize max_size) {
+  // See rle_read_header() for the layout of the header, which is
+  // followed by the row index, if RLE_FORMAT_ROW_INDEX is set in
+  // format.
+  RleHeader header;
+  rle_read_header(rb, &header);
+
+  int width = header.width;
+  int height = header.height;
   assert(width > 0 && width <= SCREEN_WIDTH && height > 0 && height <= SCREEN_HEIGHT);
-  int n = rbuffer_getc(rb);
-  int format = rbuffer_getc(rb);
+  int n = header.n;
+  int format = header.format;
   if (format != 0) {
     qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "cannot support format %d", format);
     return bwd_create(NULL, NULL);
   }
+  if (header.codec == RLE_CODEC_UNKNOWN) {
+    qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "cannot support rle codec");
+    return bwd_create(NULL, NULL);
+  }
 
-  /*uint8_t vo_lo = */rbuffer_getc(rb);
-  /*uint8_t vo_hi = */rbuffer_getc(rb);
-  /*uint8_t po_lo = */rbuffer_getc(rb);
-  /*uint8_t po_hi = */rbuffer_getc(rb);
-
-  int do_unscreen = (n & 0x80);
-  n = n & 0x7f;
+  // We're decoding the whole image, so we just skip over the row
+  // index, if any.
+  RleRowStart start;
+  rle_find_row_start(rb, &header, 0, true, &start);
 
   qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "reading bitmap %d x %d, n = %d, format = %d", width, height, n, format);
 
-  GBitmap *image = gbitmap_create_blank(GSize(width, height), GBitmapFormat1Bit);
-  if (image == NULL) {
-    qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "memory allocation failure on %dx%d 1-bit image", width, height);
-    return bwd_create(NULL, NULL);
+  GBitmap *image = NULL;
+  if (buffer != NULL) {
+    image = bwd_prepare_buffer(buffer, capacity, max_size, GSize(width, height), GBitmapFormat1Bit, false);
+    if (image == NULL) {
+      return bwd_create(NULL, NULL);
+    }
+  } else {
+    image = gbitmap_create_blank(GSize(width, height), GBitmapFormat1Bit);
+    if (image == NULL) {
+      qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "memory allocation failure on %dx%d 1-bit image", width, height);
+      return bwd_create(NULL, NULL);
+    }
   }
+  rbuffer_widen_window(rb);
   int stride = gbitmap_get_bytes_per_row(image);
   uint8_t *bitmap_data = gbitmap_get_data(image);
   assert(bitmap_data != NULL);
@@ -734,88 +1859,642 @@ rle_bwd_create_rb(RBuffer *rb) {
   //qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "stride = %d, data_size = %d", stride, data_size);
 
   Rl2Unpacker rl2;
-  rl2unpacker_init(&rl2, rb, n, true);
+  rl2unpacker_init(&rl2, rb, n);
+  if (flip_x || flip_y || header.codec != RLE_CODEC_RUNS || header.do_unscreen) {
+    // Anything more than a plain decode is done a row at a time.
+    rle_unpack_rows(&rl2, NULL, 0, start.skip, &header, bitmap_data, stride, flip_x, flip_y);
+  } else {
+    rle_unpack_1bit(&rl2, bitmap_data, bitmap_data + data_size);
+  }
 
-  uint8_t *dp = bitmap_data;
-  uint8_t *dp_stop = dp + data_size;
-  int b = 0;
+  // There's no palette to remap on a B&W watch.
+  return bwd_create(image, NULL);
+}
+
+#endif // PBL_BW
+
+BitmapWithData
+rle_bwd_create(int resource_id) {
+  return rle_bwd_create_transformed(resource_id, false, false, NULL);
+}
+
+// The body of rle_bwd_create_transformed() and rle_bwd_create_into().
+static BitmapWithData
+rle_bwd_decode(int resource_id, bool flip_x, bool flip_y, const BwdRemap *remap, BitmapWithData *buffer, uint16_t *capacity, GSize max_size, RleWindow *window) {
+  qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "rle_bwd_create(%d)", resource_id);
+  ++bwd_resource_reads;
+  BWD_STATS_INC(rle_decodes);
+  TIMER_START(start_ms);
+  HEAP_TRACE_BEGIN((buffer != NULL) ? "rle_bwd_create_into" : "rle_bwd_create");
+
+  RBuffer rb;
+  rbuffer_init_rle(&rb, resource_id, window);
+  BitmapWithData result = rle_bwd_create_rb(&rb, flip_x, flip_y, remap, buffer, capacity, max_size);
+  rbuffer_deinit(&rb);
+  HEAP_TRACE_END();
+  TIMER_STOP(TP_rle_decode, start_ms);
+#ifdef BWD_STATS
+  if (result.bitmap != NULL) {
+    BWD_STATS_ADD(decoded_bytes, gbitmap_get_bytes_per_row(result.bitmap) * gbitmap_get_bounds(result.bitmap).size.h);
+  }
+#endif  // BWD_STATS
+  return result;
+}
+
+// As rle_bwd_create(), but the image is also flipped horizontally
+// and/or vertically, as by flip_bitmap_x() and flip_bitmap_y(), and
+// remapped (if remap is not NULL) as by bwd_remap_colors(), all while
+// it is decoded, rather than in separate passes afterwards.
+BitmapWithData
+rle_bwd_create_transformed(int resource_id, bool flip_x, bool flip_y, const BwdRemap *remap) {
+  return rle_bwd_decode(resource_id, flip_x, flip_y, remap, NULL, NULL, GSize(0, 0), NULL);
+}
+
+// As rle_bwd_create_transformed(), but the image is decoded into
+// buffer, which has room for *capacity bytes of pixels, instead of
+// into a newly-allocated bitmap; a series of images can then be
+// decoded one after another without going back to the heap each
+// time.  The buffer is allocated the first time (start with a NULL
+// bitmap and a capacity of 0), and again only if an image needs more
+// room than before, with room for an image of max_size, which should
+// be the size of the largest of them.  The resource is read through
+// window, which should already be reserved (see rle_window_reserve()),
+// and it isn't added to the rle cache; once the buffer is allocated,
+// the decode allocates nothing.  Afterwards buffer's bitmap is the
+// image.  Returns false on failure.  Release the buffer with
+// bwd_destroy().
+bool
+rle_bwd_create_into(BitmapWithData *buffer, uint16_t *capacity, GSize max_size, RleWindow *window, int resource_id, bool flip_x, bool flip_y, const BwdRemap *remap) {
+  assert(window->data != NULL);
+  BitmapWithData result = rle_bwd_decode(resource_id, flip_x, flip_y, remap, buffer, capacity, max_size, window);
+  return (result.bitmap != NULL);
+}
+
+#ifdef PBL_BW
+// Composites the source bits s onto pixels x0 .. x1 - 1 of a row of
+// the 1-bit frame buffer, according to op.  s holds the source bits
+// already lined up with the frame buffer's bits.
+static inline void draw_1bit_span(uint8_t *row, int x0, int x1, uint8_t s, GCompOp op) {
+  int bx0 = x0 >> 3;
+  int bx1 = (x1 - 1) >> 3;
+  for (int bx = bx0; bx <= bx1; ++bx) {
+    uint8_t m = 0xff;
+    if (bx == bx0) {
+      m &= (uint8_t)(0xff << (x0 & 7));
+    }
+    if (bx == bx1) {
+      m &= (uint8_t)(0xff >> (7 - ((x1 - 1) & 7)));
+    }
+    uint8_t d = row[bx];
+    switch (op) {
+    case GCompOpAssign: d = (d & ~m) | (s & m); break;
+    case GCompOpAssignInverted: d = (d & ~m) | (~s & m); break;
+    case GCompOpOr: d |= (s & m); break;
+    case GCompOpAnd: d &= (s | ~m); break;
+    case GCompOpClear: d &= ~(s & m); break;
+    case GCompOpSet: d |= (~s & m); break;
+    }
+    row[bx] = d;
+  }
+}
+
+#else  // PBL_BW
+
+// Blends src over dst according to src's 2-bit alpha, as GCompOpSet
+// does.
+static inline uint8_t blend_argb8(uint8_t dst, GColor src) {
+  GColor d;
+  d.argb = dst;
+  int a = src.a;
+  GColor result;
+  result.a = 3;
+  result.r = (src.r * a + d.r * (3 - a) + 1) / 3;
+  result.g = (src.g * a + d.g * (3 - a) + 1) / 3;
+  result.b = (src.b * a + d.b * (3 - a) + 1) / 3;
+  return result.argb;
+}
+
+// Composites a run of the solid color c onto pixels x0 .. x1 - 1 of a
+// row of the 8-bit frame buffer.  Only GCompOpAssign and GCompOpSet
+// are supported.
+static inline void draw_8bit_span(uint8_t *row, int x0, int x1, GColor c, GCompOp op) {
+  if (op == GCompOpAssign || c.a == 3) {
+    memset(row + x0, c.argb | 0xc0, x1 - x0);
+  } else if (c.a != 0) {
+    for (int x = x0; x < x1; ++x) {
+      row[x] = blend_argb8(row[x], c);
+    }
+  }
+}
+
+#endif  // PBL_BW
+
+// Draws the part of an RLE_CODEC_XOR_ROWS image that falls within clip
+// into destination, for rle_bwd_draw_rect().  rb should be just past
+// the header.  The image is decoded a row at a time into a one-row
+// bitmap, which accumulates the XOR of the rows decoded so far, and
+// each visible row is drawn from that.  Returns false on allocation
+// failure.
+static bool rle_draw_xor_rows(GContext *ctx, RBuffer *rb, const RleHeader *header, GRect destination, GRect clip, GCompOp op, const BwdRemap *remap) {
+  GBitmapFormat format = (GBitmapFormat)header->format;
+  int vn = 0;
+#ifndef PBL_BW
+  size_t palette_count = 0;
+  switch (format) {
+  case GBitmapFormat1BitPalette:
+    palette_count = 2;
+    break;
+
+  case GBitmapFormat2BitPalette:
+    vn = 2;
+    palette_count = 4;
+    break;
+
+  case GBitmapFormat4BitPalette:
+    vn = 4;
+    palette_count = 16;
+    break;
+
+  case GBitmapFormat8Bit:
+    vn = 8;
+    break;
+
+  default:
+    break;
+  }
+#else  // PBL_BW
+  if (format != GBitmapFormat1Bit) {
+    qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "cannot support format %d", format);
+    return false;
+  }
+#endif  // PBL_BW
+
+  // Clip the image to destination and to clip.
+  grect_clip(&clip, &destination);
+  int x_begin = clip.origin.x - destination.origin.x;
+  int x_end = clip.origin.x + clip.size.w - destination.origin.x;
+  if (x_end > header->width) {
+    x_end = header->width;
+  }
+  int y_begin = clip.origin.y - destination.origin.y;
+  int y_end = clip.origin.y + clip.size.h - destination.origin.y;
+  if (y_end > header->height) {
+    y_end = header->height;
+  }
+  if (x_begin >= x_end || y_begin >= y_end) {
+    // None of it is visible.
+    return true;
+  }
+  BWD_STATS_ADD(drawn_pixels, (x_end - x_begin) * (y_end - y_begin));
+
+  GBitmap *row_bitmap = NULL;
+#ifndef PBL_BW
+  GColor palette[16];
+  if (palette_count != 0) {
+    row_bitmap = gbitmap_create_blank_with_palette(GSize(header->width, 1), format, palette, false);
+  } else {
+    row_bitmap = gbitmap_create_blank(GSize(header->width, 1), format);
+  }
+#else  // PBL_BW
+  row_bitmap = gbitmap_create_blank(GSize(header->width, 1), format);
+#endif  // PBL_BW
+  if (row_bitmap == NULL) {
+    return false;
+  }
+  int stride = gbitmap_get_bytes_per_row(row_bitmap);
+  uint8_t *row = gbitmap_get_data(row_bitmap);
+  uint8_t *delta = (uint8_t *)malloc(stride);
+  if (delta == NULL) {
+    gbitmap_destroy(row_bitmap);
+    return false;
+  }
 
-  // Unpack a 1-bit file.
+  RBuffer rb_vo;
+  rbuffer_split(rb, &rb_vo, header->vo);
 
-  // The initial value is 0.
+#ifndef PBL_BW
+  if (palette_count != 0) {
+    RBuffer rb_po;
+    rbuffer_split(&rb_vo, &rb_po, header->po);
+    for (int i = 0; i < (int)palette_count; ++i) {
+      palette[i].argb = rbuffer_getc(&rb_po);
+    }
+    rbuffer_deinit(&rb_po);
+    if (remap != NULL) {
+      remap_palette(palette, palette_count, remap);
+    }
+  }
+#endif  // PBL_BW
+
+  // There's no row index for this codec; we always start at the top.
+  RleRowStart start;
+  rle_find_row_start(rb, header, 0, (vn == 0), &start);
+
+  Rl2Unpacker rl2;
+  rl2unpacker_init(&rl2, rb, header->n);
+#ifndef PBL_BW
+  Rl2Unpacker rl2_vo = { NULL, 0, 0, 0 };
+  if (vn != 0) {
+    rl2unpacker_init(&rl2_vo, &rb_vo, vn);
+  }
+#endif  // PBL_BW
+
+  // count is the number of pixels remaining in the current run, and
+  // value is its value.  Runs continue from one row to the next.
   int value = 0;
   int count = rl2unpacker_getc(&rl2);
   if (count != EOF) {
-    assert(count > 0);
-    // We discard the first, implicit black pixel; it's not part of the image.
-    --count;
+    // At the top of a 1-bit image, this discards the implicit black
+    // pixel.
+    count -= start.skip;
   }
-  while (count != EOF) {
-    pack_1bit(value, count, &b, &dp, dp_stop);
-    value = 1 - value;
-    count = rl2unpacker_getc(&rl2);
+#ifndef PBL_BW
+  if (vn != 0) {
+    value = rl2unpacker_get_chunk(&rl2_vo);
   }
+#endif  // PBL_BW
 
-  //qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "wrote %d bytes", dp - bitmap_data);
-  assert(dp == dp_stop && b == 0);
+  // The number of pixels in each row of the rle data, which is padded
+  // out to the row stride.
+  int stream_width = stride * 8 / ((vn == 0) ? 1 : vn);
+  int width_bytes = header->do_unscreen ? header->width / 8 : 0;
+
+  gbitmap_set_bounds(row_bitmap, GRect(x_begin, 0, x_end - x_begin, 1));
+  graphics_context_set_compositing_mode(ctx, op);
+
+  for (int y = 0; y < y_end; ++y) {
+    // Decode this row's difference from the row above.
+    memset(delta, 0, stride);
+    uint8_t *dp = delta;
+    uint8_t *dp_stop = delta + stride;
+    int b = 0;
+    int x = 0;
+    while (x < stream_width && count != EOF) {
+      if (count == 0) {
+        // On to the next run.
+        count = rl2unpacker_getc(&rl2);
+#ifndef PBL_BW
+        if (vn != 0) {
+          value = rl2unpacker_get_chunk(&rl2_vo);
+          continue;
+        }
+#endif  // PBL_BW
+        value = 1 - value;
+        continue;
+      }
+
+      int span = stream_width - x;
+      if (span > count) {
+        span = count;
+      }
+      switch (vn) {
+      case 0:
+        pack_1bit(value, span, &b, &dp, dp_stop);
+        break;
+
+#ifndef PBL_BW
+      case 2:
+        pack_2bit(value, span, &b, &dp, dp_stop);
+        break;
+
+      case 4:
+        pack_4bit(value, span, &b, &dp, dp_stop);
+        break;
 
-  if (do_unscreen) {
-    unscreen_bitmap(image);
+      case 8:
+        pack_8bit(value, span, &b, &dp, dp_stop);
+        break;
+#endif  // PBL_BW
+      }
+      x += span;
+      count -= span;
+    }
+
+    for (int i = 0; i < stride; ++i) {
+      row[i] ^= delta[i];
+    }
+
+    if (y >= y_begin) {
+      // As in rle_unpack_rows(), the checkerboard pattern goes back
+      // over the first width / 8 bytes of each row; we take it off
+      // again after drawing, since the next row builds on this one.
+      uint8_t mask = (y & 1) ? 0x55 : 0xaa;
+      for (int i = 0; i < width_bytes; ++i) {
+        row[i] ^= mask;
+      }
+      graphics_draw_bitmap_in_rect(ctx, row_bitmap, GRect(destination.origin.x + x_begin, destination.origin.y + y, x_end - x_begin, 1));
+      for (int i = 0; i < width_bytes; ++i) {
+        row[i] ^= mask;
+      }
+    }
   }
 
-  return bwd_create(image, NULL);
+  free(delta);
+  gbitmap_destroy(row_bitmap);
+  rbuffer_deinit(&rb_vo);
+  return true;
 }
 
-#endif // PBL_BW
+// Draws the part of an rle-encoded resource that falls within clip
+// into destination (both in the coordinates of layer), without
+// creating a GBitmap for it: the runs are decoded straight into the
+// frame buffer.  This saves a bitmap-sized allocation and a second
+// pass over the pixels for an image we only need to draw once.
+// layer's parent must lie at the origin of the screen.  The image is
+// clipped to destination, rather than tiled.  If the image has a row
+// index, decoding begins at the nearest indexed row above the clipped
+// area, and it stops at the bottom of the clipped area in any case.
+//
+// On B&W watches all of the compositing modes are supported; on color
+// watches, GCompOpAssign and GCompOpSet are supported for 2-, 4-, and
+// 8-bit images.  If remap is not NULL, it is applied to the palette
+// as by bwd_remap_colors().  Anything else is decoded into a
+// temporary bitmap and drawn the usual way.  Returns false on
+// allocation failure.
+bool rle_bwd_draw_rect(Layer *layer, GContext *ctx, int resource_id, GRect destination, GRect clip, GCompOp op, const BwdRemap *remap) {
+  TIMER_START(start_ms);
+  RBuffer rb;
+  rbuffer_init_rle(&rb, resource_id, NULL);
+  rbuffer_widen_window(&rb);
+
+  RleHeader header;
+  rle_read_header(&rb, &header);
+  if (header.codec != RLE_CODEC_RUNS) {
+    // Each row depends on the one before, so we can't decode the runs
+    // straight into the frame buffer.
+    bool result = false;
+    if (header.codec == RLE_CODEC_XOR_ROWS) {
+      qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "rle_bwd_draw(%d), by rows", resource_id);
+      ++bwd_resource_reads;
+      BWD_STATS_INC(rle_draws);
+      result = rle_draw_xor_rows(ctx, &rb, &header, destination, clip, op, remap);
+    } else {
+      qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "cannot support rle codec");
+    }
+    rbuffer_deinit(&rb);
+    TIMER_STOP(TP_rle_decode, start_ms);
+    return result;
+  }
 
-BitmapWithData
-rle_bwd_create(int resource_id) {
-  qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "rle_bwd_create(%d)", resource_id);
+  int width = header.width;
+  int height = header.height;
+  int n = header.n;
+  GBitmapFormat format = (GBitmapFormat)header.format;
+  size_t vo = header.vo;
+#ifndef PBL_BW
+  size_t po = header.po;
+#else  // PBL_BW
+  bool do_unscreen = header.do_unscreen;
+#endif  // PBL_BW
+
+  // The number of pixels in each row of the rle data, which is padded
+  // out to the row stride.
+  int stream_width = 0;
+#ifdef PBL_BW
+  if (format == GBitmapFormat1Bit) {
+    stream_width = ((width + 31) / 32) * 32;
+  }
+#else  // PBL_BW
+  int vn = 0;
+  size_t palette_count = 0;
+  if (op == GCompOpAssign || op == GCompOpSet) {
+    switch (format) {
+    case GBitmapFormat2BitPalette:
+      stream_width = (width + 3) & ~3;
+      vn = 2;
+      palette_count = 4;
+      break;
+
+    case GBitmapFormat4BitPalette:
+      stream_width = (width + 1) & ~1;
+      vn = 4;
+      palette_count = 16;
+      break;
+
+    case GBitmapFormat8Bit:
+      stream_width = width;
+      vn = 8;
+      break;
+
+    default:
+      break;
+    }
+  }
+#endif  // PBL_BW
+
+  GBitmap *fb = NULL;
+  if (stream_width != 0) {
+    fb = graphics_capture_frame_buffer(ctx);
+  }
+  if (fb == NULL) {
+    // We can't draw this one directly.  (rle_bwd_create() times
+    // itself.)
+    rbuffer_deinit(&rb);
+    TIMER_STOP(TP_rle_decode, start_ms);
+    BitmapWithData bwd = rle_bwd_create(resource_id);
+    return bwd_draw_once(ctx, &bwd, destination, clip, op, remap);
+  }
+
+  // Clip the image to destination, to clip, and to the frame buffer.
+  GPoint origin = layer_get_frame(layer).origin;
+  int dx = destination.origin.x + origin.x;
+  int dy = destination.origin.y + origin.y;
+  GSize fb_size = gbitmap_get_bounds(fb).size;
+  grect_clip(&clip, &destination);
+  int x_begin = clip.origin.x - destination.origin.x;
+  if (x_begin < -dx) {
+    x_begin = -dx;
+  }
+  int x_end = clip.origin.x + clip.size.w - destination.origin.x;
+  if (x_end > width) {
+    x_end = width;
+  }
+  if (x_end > fb_size.w - dx) {
+    x_end = fb_size.w - dx;
+  }
+  int y_begin = clip.origin.y - destination.origin.y;
+  if (y_begin < -dy) {
+    y_begin = -dy;
+  }
+  int y_end = clip.origin.y + clip.size.h - destination.origin.y;
+  if (y_end > height) {
+    y_end = height;
+  }
+  if (y_end > fb_size.h - dy) {
+    y_end = fb_size.h - dy;
+  }
+  if (x_begin >= x_end || y_begin >= y_end) {
+    // None of it is visible.
+    rbuffer_deinit(&rb);
+    graphics_release_frame_buffer(ctx, fb);
+    TIMER_STOP(TP_rle_decode, start_ms);
+    return true;
+  }
+  BWD_STATS_ADD(drawn_pixels, (x_end - x_begin) * (y_end - y_begin));
+
+  qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "rle_bwd_draw(%d), rows %d .. %d", resource_id, y_begin, y_end);
   ++bwd_resource_reads;
+  BWD_STATS_INC(rle_draws);
 
-  RBuffer rb;
-  rbuffer_init_resource(&rb, resource_id, 0);
-  BitmapWithData result = rle_bwd_create_rb(&rb);
-  rbuffer_deinit(&rb);
-  return result;
-}
+  RBuffer rb_vo;
+  rbuffer_split(&rb, &rb_vo, vo);
 
-#ifdef SUPPORT_RESOURCE_CACHE
-BitmapWithData rle_bwd_create_with_cache(int resource_id_offset, int resource_id, struct ResourceCache *resource_cache, size_t resource_cache_size) {
-  int index = resource_id - resource_id_offset;
-  if (index >= (int)resource_cache_size) {
-    // No cache in use.
-    return rle_bwd_create(resource_id);
+#ifndef PBL_BW
+  // Read the palette first, so we can remap it and draw the right
+  // colors as we go.
+  GColor palette[16];
+  if (palette_count != 0) {
+    RBuffer rb_po;
+    rbuffer_split(&rb_vo, &rb_po, po);
+    for (int i = 0; i < (int)palette_count; ++i) {
+      palette[i].argb = rbuffer_getc(&rb_po);
+    }
+    rbuffer_deinit(&rb_po);
+    if (remap != NULL) {
+      remap_palette(palette, palette_count, remap);
+    }
   }
 
-  struct ResourceCache *cache = &resource_cache[index];
-  if (cache->bwd.bitmap == NULL) {
-    cache->bwd = rle_bwd_create(resource_id);
+#endif  // PBL_BW
+
+  // Find the place to begin decoding: the first row, unless there's a
+  // row index to let us skip ahead.
+  RleRowStart start;
+#ifdef PBL_BW
+  rle_find_row_start(&rb, &header, y_begin, true, &start);
+#else  // PBL_BW
+  rle_find_row_start(&rb, &header, y_begin, false, &start);
+#endif  // PBL_BW
+
+  Rl2Unpacker rl2;
+  rl2unpacker_init(&rl2, &rb, n);
+  rl2unpacker_skip_bits(&rl2, start.bit);
+
+#ifndef PBL_BW
+  // The values are packed vn bits apiece, beginning at vo.
+  int value_bit = start.value_index * vn;
+  rbuffer_seek(&rb_vo, vo + value_bit / 8);
+  Rl2Unpacker rl2_vo;
+  rl2unpacker_init(&rl2_vo, &rb_vo, vn);
+  rl2unpacker_skip_bits(&rl2_vo, value_bit % 8);
+#endif  // PBL_BW
+
+  // (x, y) walks through the image in rle order; row is the frame
+  // buffer row that image row y lands on, or NULL if it's clipped
+  // away, and row_begin .. row_end - 1 are the image columns that are
+  // visible in that row.
+  int x = 0;
+  int y = start.row;
+  uint8_t *row = NULL;
+  int row_begin = 0, row_end = 0;
+
+  // The first run may begin before our starting point.  (At the top of
+  // a 1-bit image, this discards the implicit black pixel.)
+  int count = rl2unpacker_getc(&rl2);
+  if (count != EOF) {
+    count -= start.skip;
   }
-  return bwd_copy(&(cache->bwd));
+#ifdef PBL_BW
+  int value = start.value;
+
+  // On an unscreened image, the checkerboard pattern is reapplied to
+  // the first width / 8 bytes of each row, as in rle_unpack_rows().
+  int unscreen_end = do_unscreen ? (width / 8) * 8 : 0;
+#endif  // PBL_BW
+
+  while (count != EOF && y < y_end) {
+#ifndef PBL_BW
+    GColor c;
+    c.argb = rl2unpacker_get_chunk(&rl2_vo);
+    if (palette_count != 0) {
+      c = palette[c.argb & (palette_count - 1)];
+    }
+#endif  // PBL_BW
+
+    while (count > 0) {
+      if (x == 0) {
+        // Starting a new row.
+        row = NULL;
+        if (y >= y_begin) {
+          GBitmapDataRowInfo info = gbitmap_get_data_row_info(fb, dy + y);
+          row = info.data;
+          row_begin = (info.min_x - dx > x_begin) ? info.min_x - dx : x_begin;
+          row_end = (info.max_x + 1 - dx < x_end) ? info.max_x + 1 - dx : x_end;
+        }
+      }
+
+      int span = stream_width - x;
+      if (span > count) {
+        span = count;
+      }
+      int x0 = (x > row_begin) ? x : row_begin;
+      int x1 = (x + span < row_end) ? x + span : row_end;
+      if (row != NULL && x0 < x1) {
+#ifdef PBL_BW
+        uint8_t s = value ? 0xff : 0x00;
+        if (x0 < unscreen_end) {
+          // The part of the run that was unscreened gets the
+          // checkerboard back, lined up with the frame buffer's bits.
+          int x2 = (x1 < unscreen_end) ? x1 : unscreen_end;
+          uint8_t checker = ((dx + y) & 1) ? 0x55 : 0xaa;
+          draw_1bit_span(row, dx + x0, dx + x2, s ^ checker, op);
+          x0 = x2;
+        }
+        if (x0 < x1) {
+          draw_1bit_span(row, dx + x0, dx + x1, s, op);
+        }
+#else  // PBL_BW
+        draw_8bit_span(row, dx + x0, dx + x1, c, op);
+#endif  // PBL_BW
+      }
+
+      x += span;
+      count -= span;
+      if (x == stream_width) {
+        x = 0;
+        ++y;
+        if (y >= y_end) {
+          // Nothing more of this image is visible.
+          break;
+        }
+      }
+    }
+
+#ifdef PBL_BW
+    value = 1 - value;
+#endif  // PBL_BW
+    count = rl2unpacker_getc(&rl2);
+  }
+
+  rbuffer_deinit(&rb_vo);
+  rbuffer_deinit(&rb);
+  graphics_release_frame_buffer(ctx, fb);
+  TIMER_STOP(TP_rle_decode, start_ms);
+  return true;
 }
-#endif  // SUPPORT_RESOURCE_CACHE
 
 #endif  // SUPPORT_RLE
 
-// Replace each of the R, G, B channels with a different color, and
-// blend the result together.  Only supported for palette bitmaps.
-void bwd_remap_colors(BitmapWithData *bwd, GColor cb, GColor c1, GColor c2, GColor c3, bool invert_colors) {
+// Draws an rle-encoded resource into destination (in the coordinates
+// of layer).  See rle_bwd_draw_rect().
+bool rle_bwd_draw(Layer *layer, GContext *ctx, int resource_id, GRect destination, GCompOp op, const BwdRemap *remap) {
+  return rle_bwd_draw_rect(layer, ctx, resource_id, destination, destination, op, remap);
+}
+
 #ifndef PBL_BW
-  if (bwd->bitmap == NULL) {
-    return;
-  }
+// Returns the palette of bwd, and sets *palette_size to its number of
+// entries, or returns NULL if bwd is not a palette bitmap.
+static GColor *bwd_get_palette(BitmapWithData *bwd, int *palette_size) {
   GBitmapFormat format = gbitmap_get_format(bwd->bitmap);
-  int palette_size = 0;
   switch (format) {
   case GBitmapFormat1BitPalette:
-    palette_size = 2;
+    *palette_size = 2;
     break;
   case GBitmapFormat2BitPalette:
-    palette_size = 4;
+    *palette_size = 4;
     break;
   case GBitmapFormat4BitPalette:
-    palette_size = 16;
+    *palette_size = 16;
     break;
 
   case GBitmapFormat1Bit:
@@ -827,42 +2506,51 @@ void bwd_remap_colors(BitmapWithData *bwd, GColor cb, GColor c1, GColor c2, GCol
     // it as an error, to help catch accidental mistakes in image
     // preparation.
     qapp_log(APP_LOG_LEVEL_WARNING, __FILE__, __LINE__, "bwd_remap_colors cannot adjust non-palette format %d", format);
-    return;
+    return NULL;
   }
 
-  assert(palette_size != 0);
   GColor *palette = gbitmap_get_palette(bwd->bitmap);
   assert(palette != NULL);
+  return palette;
+}
+#endif // PBL_BW
 
-  for (int pi = 0; pi < palette_size; ++pi) {
-    int r = cb.r;
-    int g = cb.g;
-    int b = cb.b;
-
-    GColor p = palette[pi];
-
-    r = (3 * r + p.r * (c1.r - r)) / 3;  // Blend from r to c1.r
-    r = (3 * r + p.g * (c2.r - r)) / 3;  // Blend from r to c2.r
-    r = (3 * r + p.b * (c3.r - r)) / 3;  // Blend from r to c3.r
-
-    g = (3 * g + p.r * (c1.g - g)) / 3;  // Blend from g to c1.g
-    g = (3 * g + p.g * (c2.g - g)) / 3;  // Blend from g to c2.g
-    g = (3 * g + p.b * (c3.g - g)) / 3;  // Blend from g to c3.g
-
-    b = (3 * b + p.r * (c1.b - b)) / 3;  // Blend from b to c1.b
-    b = (3 * b + p.g * (c2.b - b)) / 3;  // Blend from b to c2.b
-    b = (3 * b + p.b * (c3.b - b)) / 3;  // Blend from b to c3.b
-
-    palette[pi].r = (r < 0x3) ? r : 0x3;
-    palette[pi].g = (g < 0x3) ? g : 0x3;
-    palette[pi].b = (b < 0x3) ? b : 0x3;
-
-    //    GColor q = palette[pi]; qapp_log(APP_LOG_LEVEL_WARNING, __FILE__, __LINE__, "cb = %02x, c1 = %02x, c2 = %02x, c3 = %02x.  %d: %02x/%02x/%02x/%02x becomes %02x/%02x/%02x/%02x (%d, %d, %d)", cb.argb, c1.argb, c2.argb, c3.argb, pi, p.argb & 0xc0, p.argb & 0x30, p.argb & 0x0c, p.argb & 0x03, q.argb & 0xc0, q.argb & 0x30, q.argb & 0x0c, q.argb & 0x03, r, g, b);
-
-    if (invert_colors) {
-      palette[pi].argb ^= 0x3f;
-    }
+// Replace each of the R, G, B channels with a different color, and
+// blend the result together.  Only supported for palette bitmaps.
+void bwd_remap_colors(BitmapWithData *bwd, const BwdRemap *remap) {
+#ifndef PBL_BW
+  if (bwd->bitmap == NULL) {
+    return;
   }
+  int palette_size = 0;
+  GColor *palette = bwd_get_palette(bwd, &palette_size);
+  if (palette != NULL) {
+    remap_palette(palette, palette_size, remap);
+  }
+#endif // PBL_BW
+}
 
+// Changes the remapping of a bitmap that was remapped as it was
+// decoded, by remapping its original palette anew, without going back
+// to the resource.  Returns false if the bitmap didn't keep its
+// original palette (for instance, because it was loaded from a png),
+// in which case it must be loaded again instead.
+bool bwd_recolor(BitmapWithData *bwd, const BwdRemap *remap) {
+#ifndef PBL_BW
+  if (bwd->bitmap == NULL) {
+    return true;
+  }
+  if (bwd->data == NULL) {
+    return false;
+  }
+  int palette_size = 0;
+  GColor *palette = bwd_get_palette(bwd, &palette_size);
+  if (palette == NULL) {
+    return false;
+  }
+  assert(palette == (GColor *)bwd->data);
+  memcpy(palette, palette + palette_size, palette_size * sizeof(GColor));
+  remap_palette(palette, palette_size, remap);
 #endif // PBL_BW
+  return true;
 }
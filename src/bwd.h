@@ -10,22 +10,73 @@
 
 typedef struct __attribute__((__packed__)) {
   GBitmap *bitmap;
+
+  // If not NULL, the block holding the bitmap's palette, followed by
+  // the palette as it was before it was remapped (see bwd_recolor()).
   unsigned char *data;
 } BitmapWithData;
 
-// An array of these elements maintains an in-memory cache of resource
-// data so we don't have to go to the resource file all the time.
+// An entry of the resource cache, an in-memory cache of decoded
+// bitmaps so we don't have to go to the resource file all the time.
+// See bwd.c.
 struct __attribute__((__packed__)) ResourceCache {
-  // We once kept the raw resource data here, but now we've got so
-  // much elbow room to play with, we'll keep the decoded bitmaps
-  // instead.
+  unsigned short resource_id;  // 0 if the entry is unused
+  unsigned char variant;       // how the bitmap was altered after decoding
+  unsigned char refs;          // number of times it is currently lent out
+  unsigned short size;         // bytes of heap taken by the bitmap
+  unsigned short last_used;    // the value of resource_cache_clock when last used
   BitmapWithData bwd;
 };
 
 extern int bwd_resource_reads;
 
+// These count the resource_load_byte_range() calls made to read rle
+// resources, the bytes they loaded, and how many of those bytes had
+// already been loaded once before during the same decode.
+extern int bwd_load_calls;
+extern int bwd_load_bytes;
+extern int bwd_load_bytes_reread;
+
+#ifdef BWD_STATS
+// Finer-grained counters on the RLE decoder, for the host benchmarks
+// (see host/bench_rle.c and host/bench_day.c).  These are not
+// compiled into the watch build.
+struct BwdStats {
+  unsigned int rle_decodes;     // calls to rle_bwd_create()
+  unsigned int rle_draws;       // direct decodes by rle_bwd_draw()
+  unsigned int rl2_getc_calls;  // integers read by the Rl2Unpacker
+  uint64_t decoded_bytes;       // bitmap bytes made by rle_bwd_create()
+  uint64_t drawn_pixels;        // pixels drawn directly by rle_bwd_draw()
+};
+extern struct BwdStats bwd_stats;
+#define BWD_STATS_INC(field) (++bwd_stats.field)
+#define BWD_STATS_ADD(field, n) (bwd_stats.field += (n))
+
+#else  // BWD_STATS
+#define BWD_STATS_INC(field)
+#define BWD_STATS_ADD(field, n)
+
+#endif  // BWD_STATS
+
+#ifdef HEAP_TRACE
+// In the host build, the simulated heap can write a trace of every
+// allocation and free, for host/heap_sim.c to replay.  Each
+// allocation is attributed to the site named by the innermost
+// HEAP_TRACE_BEGIN() whose HEAP_TRACE_END() hasn't been reached yet,
+// or to no site at all.  These are not compiled into the watch build.
+extern const char *heap_trace_site;
+#define HEAP_TRACE_BEGIN(site) const char *heap_trace_outer_site = heap_trace_site; heap_trace_site = (site)
+#define HEAP_TRACE_END() (heap_trace_site = heap_trace_outer_site)
+
+#else  // HEAP_TRACE
+#define HEAP_TRACE_BEGIN(site)
+#define HEAP_TRACE_END()
+
+#endif  // HEAP_TRACE
+
 BitmapWithData bwd_create(GBitmap *bitmap, unsigned char *data);
 void bwd_destroy(BitmapWithData *bwd);
+size_t bwd_get_size(BitmapWithData *bwd);
 
 BitmapWithData bwd_copy(BitmapWithData *source);
 BitmapWithData bwd_copy_bitmap(GBitmap *bitmap);
@@ -34,19 +85,85 @@ void bwd_copy_into_from_bitmap(BitmapWithData *dest, GBitmap *source);
 BitmapWithData png_bwd_create(int resource_id);
 BitmapWithData rle_bwd_create(int resource_id);
 
+// The parameters to bwd_remap_colors(), collected together so that
+// rle_bwd_draw() can apply them as it draws.  If bank is not NULL,
+// it is the precomputed result of remapping each color with cb, c1,
+// c2, c3 (see REMAP_BANK_SIZE in hand_table.h), which is used instead
+// of blending them anew.
+typedef struct {
+  GColor cb, c1, c2, c3;
+  const uint8_t *bank;
+  bool invert_colors;
+} BwdRemap;
+
+// The read window that rle_bwd_create_into() loads each resource
+// through, kept by the caller along with the buffer it decodes into,
+// so that a decode takes nothing from the heap.  Start with a NULL
+// data and a size of 0, and release it with rle_window_destroy().
+typedef struct {
+  uint8_t *data;
+  uint16_t size;
+} RleWindow;
+
+size_t rle_max_resource_size(int resource_id, int num_resources);
+bool rle_window_reserve(RleWindow *window, size_t size);
+void rle_window_destroy(RleWindow *window);
+
+BitmapWithData rle_bwd_create_transformed(int resource_id, bool flip_x, bool flip_y, const BwdRemap *remap);
+bool rle_bwd_create_into(BitmapWithData *buffer, uint16_t *capacity, GSize max_size, RleWindow *window, int resource_id, bool flip_x, bool flip_y, const BwdRemap *remap);
+
+bool rle_bwd_draw(Layer *layer, GContext *ctx, int resource_id, GRect destination, GCompOp op, const BwdRemap *remap);
+bool rle_bwd_draw_rect(Layer *layer, GContext *ctx, int resource_id, GRect destination, GRect clip, GCompOp op, const BwdRemap *remap);
+
+#ifdef SUPPORT_RLE_CACHE
+// The compressed rle cache (see bwd.c): the number of bytes it holds,
+// and the number of rle reads it has satisfied or not.
+extern size_t rle_cache_bytes;
+extern int rle_cache_hits;
+extern int rle_cache_misses;
+
+void rle_cache_set_budget(size_t budget);
+bool rle_cache_shrink();
+void rle_cache_clear();
+
+#else  // SUPPORT_RLE_CACHE
+
+#define rle_cache_set_budget(budget) { }
+#define rle_cache_shrink() false
+#define rle_cache_clear() { }
+
+#endif  // SUPPORT_RLE_CACHE
+
 #ifdef SUPPORT_RESOURCE_CACHE
-void bwd_clear_cache(struct ResourceCache *resource_cache, size_t resource_cache_size);
-BitmapWithData png_bwd_create_with_cache(int resource_id_offset, int resource_id, struct ResourceCache *resource_cache, size_t resource_cache_size);
-BitmapWithData rle_bwd_create_with_cache(int resource_id_offset, int resource_id, struct ResourceCache *resource_cache, size_t resource_cache_size);
+// The resource cache (see bwd.c): the number of bytes it holds, the
+// number of bitmap requests it has satisfied or not, and the number
+// of bitmaps it has evicted to make room for others.
+extern size_t resource_cache_bytes;
+extern int resource_cache_hits;
+extern int resource_cache_misses;
+extern int resource_cache_evictions;
+
+void bwd_set_cache_budget(size_t budget);
+bool bwd_cache_shrink();
+void bwd_clear_cache();
+const BitmapWithData *bwd_cache_lend(int resource_id, int variant);
+const BitmapWithData *bwd_cache_add(int resource_id, int variant, BitmapWithData *bwd);
+void bwd_cache_return(const BitmapWithData *bwd);
+void bwd_cache_recolor(const BwdRemap *remap);
 
 #else  // SUPPORT_RESOURCE_CACHE
 
-#define bwd_clear_cache(resource_cache, resource_cache_size) { }
-#define png_bwd_create_with_cache(resource_id_offset, resource_id) png_bwd_create(resource_id)
-#define rle_bwd_create_with_cache(resource_id_offset, resource_id) rle_bwd_create(resource_id)
+#define bwd_set_cache_budget(budget) { }
+#define bwd_cache_shrink() false
+#define bwd_clear_cache() { }
+#define bwd_cache_lend(resource_id, variant) NULL
+#define bwd_cache_add(resource_id, variant, bwd) NULL
+#define bwd_cache_return(bwd) { }
+#define bwd_cache_recolor(remap) { }
 
 #endif  // SUPPORT_RESOURCE_CACHE
 
-void bwd_remap_colors(BitmapWithData *bwd, GColor cb, GColor c1, GColor c2, GColor c3, bool invert_colors);
+void bwd_remap_colors(BitmapWithData *bwd, const BwdRemap *remap);
+bool bwd_recolor(BitmapWithData *bwd, const BwdRemap *remap);
 
 #endif
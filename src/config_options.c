@@ -159,7 +159,7 @@ void receive_config_handler(DictionaryIterator *received, void *context) {
     qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "Config is unchanged.");
   } else {
     save_config();
-    apply_config();
+    apply_config_changes(&orig_config);
   }
 }
 
@@ -381,25 +381,28 @@ static void int_to_config() {
 
 #ifdef SCREENSHOT_BUILD
 static void config_button_tap_handler(AccelAxisType axis, int32_t direction) {
+  ConfigOptions orig_config = config;
   ++current_config_index;
   int_to_config();
-  apply_config();
+  apply_config_changes(&orig_config);
 }
 #endif  // SCREENSHOT_BUILD
 
 #ifdef SCREENSHOT_BUILD
 static void config_button_up_handler(ClickRecognizerRef recognizer, void *context) {
+  ConfigOptions orig_config = config;
   ++current_config_index;
   int_to_config();
-  apply_config();
+  apply_config_changes(&orig_config);
 }
 #endif  // SCREENSHOT_BUILD
 
 #ifdef SCREENSHOT_BUILD
 static void config_button_down_handler(ClickRecognizerRef recognizer, void *context) {
+  ConfigOptions orig_config = config;
   --current_config_index;
   int_to_config();
-  apply_config();
+  apply_config_changes(&orig_config);
 }
 #endif  // SCREENSHOT_BUILD
 
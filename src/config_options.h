@@ -76,6 +76,13 @@ typedef enum {
   DWM_debug_memory_panic_count = 202,
   DWM_debug_resource_reads = 203,
   DWM_debug_draw_face_count = 204,
+  DWM_debug_resource_load_calls = 205,
+  DWM_debug_resource_load_bytes = 206,
+  DWM_debug_resource_load_bytes_reread = 207,
+  DWM_debug_rle_cache_hit_rate = 208,
+  DWM_debug_last_frame_ms = 209,
+  DWM_debug_max_frame_ms = 210,
+  DWM_debug_decode_ms = 211,
 } DateWindowMode;
 
 typedef enum {
@@ -124,7 +131,7 @@ void load_config();
 void dropped_config_handler(AppMessageResult reason, void *context);
 void receive_config_handler(DictionaryIterator *received, void *context);
 
-void apply_config();  // implemented in the main program
+void apply_config_changes(const ConfigOptions *orig_config);  // implemented in the main program
 
 #ifdef SCREENSHOT_BUILD
 void config_set_click_config(struct Window *window);
@@ -18,14 +18,28 @@ struct __attribute__((__packed__)) FaceColorDef {
   uint8_t db_argb8, d1_argb8;
 };
 
+// Each FaceColorDef also has a pair of palette banks, precomputed by
+// config_watch.py into clock_face_remap_bank: for each of the 64
+// opaque colors, indexed by its rgb bits, the rgb bits it is remapped
+// to (see remap_palette() in bwd.c), before any inversion for
+// draw_mode.  One bank remaps with cb, c1, c2, c3 for the face and
+// hands, and the other with db and d1 for the date window.
+#define REMAP_BANK_CLOCK 0
+#define REMAP_BANK_DATE 1
+#define NUM_REMAP_BANKS 2
+#define REMAP_BANK_SIZE 64
+
 // A table of center positions, one for each different bitmap for a
 // hand.  This point in the bitmap is the "center" or "pivot" point of
 // the bitmap, and indicates the point that corresponds to the hinge
 // of the hand.  This point is placed at the place_x, place_y point of
-// the hand when it is drawn.
+// the hand when it is drawn.  The size of the bitmap is stored too,
+// so that the area a hand covers is known without loading it.
 struct __attribute__((__packed__)) BitmapHandCenterRow {
   int8_t cx;
   int8_t cy;
+  uint8_t w;
+  uint8_t h;
 };
 
 // A table of hand positions, one for each different "step" defined
@@ -90,6 +104,20 @@ struct __attribute__((__packed__)) HandDef {
   // unneeded cost of constantly decompressing these things.)
   bool use_rle;
 
+  // This is true if the hand is drawn by rotating a single bitmap at
+  // runtime (see rotate_hand_bitmaps() in wright.c), rather than by
+  // choosing one of a set of pre-rotated bitmaps.  In this case
+  // bitmap_centers and bitmap_table each have just one entry, for the
+  // hand pointing straight up.
+  bool rotate;
+
+  // The width and height of the largest (by area) of the bitmaps
+  // and masks for this hand, or 0 if bitmaps are not in use.  wright.c
+  // allocates a buffer of this size once and decodes each new bitmap
+  // into it, rather than allocating a new bitmap each time the hand
+  // moves.
+  uint8_t max_w, max_h;
+
   // The table of center values, one for each of bitmap_index.
   struct BitmapHandCenterRow *bitmap_centers;
 
@@ -0,0 +1,115 @@
+#include "timing.h"
+#include "qapp_log.h"
+
+#ifndef NDEBUG
+
+// Each timing recorded by timing_record().  The ring buffer holds the
+// last TIMING_RING_SIZE of them, oldest first from timing_ring_next.
+struct __attribute__((__packed__)) TimingRecord {
+  unsigned int start_ms;
+  uint16_t ms;
+  uint8_t phase;
+  uint8_t detail;
+};
+
+static struct TimingRecord timing_ring[TIMING_RING_SIZE];
+static int timing_ring_next = 0;
+static int timing_ring_count = 0;
+
+static const char *timing_phase_names[TP_num_phases] = {
+  "frame", "draw_clock_face", "phase_1_hands", "phase_2_hands", "rle_decode", "update_hands", "launch",
+};
+
+// The longest time recorded for each phase since startup.
+static unsigned int timing_max_ms[TP_num_phases];
+
+// The time spent decoding since the last frame was recorded.
+static unsigned int timing_decode_ms = 0;
+
+// The time handle_init() began, until the first complete frame has
+// recorded TP_launch.
+static unsigned int timing_launch_start_ms = 0;
+static bool timing_launch_pending = false;
+
+unsigned int timing_last_frame_ms = 0;
+unsigned int timing_max_frame_ms = 0;
+unsigned int timing_frame_decode_ms = 0;
+
+// Returns a timestamp in milliseconds, for measuring short intervals.
+// It wraps around now and then, which the unsigned subtraction in
+// timing_record() doesn't mind.
+unsigned int timing_now_ms() {
+  time_t t;
+  uint16_t t_ms;
+  time_ms(&t, &t_ms);
+  return (unsigned int)t * 1000 + t_ms;
+}
+
+// Records the time elapsed since start_ms, from timing_now_ms(), as
+// the duration of the indicated phase.
+void timing_record(TimingPhase phase, int detail, unsigned int start_ms) {
+  unsigned int ms = timing_now_ms() - start_ms;
+
+  struct TimingRecord *record = &timing_ring[timing_ring_next];
+  record->start_ms = start_ms;
+  record->ms = (ms < 0xffff) ? ms : 0xffff;
+  record->phase = phase;
+  record->detail = detail;
+  timing_ring_next = (timing_ring_next + 1) % TIMING_RING_SIZE;
+  if (timing_ring_count < TIMING_RING_SIZE) {
+    ++timing_ring_count;
+  }
+
+  if (ms > timing_max_ms[phase]) {
+    timing_max_ms[phase] = ms;
+  }
+
+  switch (phase) {
+  case TP_frame:
+    timing_last_frame_ms = ms;
+    timing_max_frame_ms = timing_max_ms[TP_frame];
+    timing_frame_decode_ms = timing_decode_ms;
+    timing_decode_ms = 0;
+    break;
+
+  case TP_rle_decode:
+    timing_decode_ms += ms;
+    break;
+
+  default:
+    break;
+  }
+}
+
+// Marks the start of handle_init().
+void timing_launch_start() {
+  timing_launch_start_ms = timing_now_ms();
+  timing_launch_pending = true;
+}
+
+// Marks the end of a complete frame.  The first one after
+// timing_launch_start() records the time to the first pixel as
+// TP_launch.
+void timing_launch_stop() {
+  if (timing_launch_pending) {
+    timing_launch_pending = false;
+    timing_record(TP_launch, 0, timing_launch_start_ms);
+  }
+}
+
+// Writes the contents of the ring buffer, and the longest time
+// recorded for each phase, to the log.
+void timing_dump_log() {
+  qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "timing: last %d records", timing_ring_count);
+  int index = (timing_ring_next + TIMING_RING_SIZE - timing_ring_count) % TIMING_RING_SIZE;
+  for (int i = 0; i < timing_ring_count; ++i) {
+    struct TimingRecord *record = &timing_ring[index];
+    qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "timing: %u %s %d: %d ms", record->start_ms, timing_phase_names[record->phase], record->detail, record->ms);
+    index = (index + 1) % TIMING_RING_SIZE;
+  }
+  for (int pi = 0; pi < TP_num_phases; ++pi) {
+    qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "timing: max %s: %u ms", timing_phase_names[pi], timing_max_ms[pi]);
+  }
+}
+
+#endif  // NDEBUG
@@ -0,0 +1,54 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <pebble.h>
+#include "../resources/generated_config.h"
+
+// The phases of each update that are timed in a debug build.
+typedef enum {
+  TP_frame,            // a clock_face_layer or second_hand_layer update
+  TP_draw_clock_face,  // draw_clock_face()
+  TP_phase_1_hands,    // draw_phase_1_hands()
+  TP_phase_2_hands,    // draw_phase_2_hands()
+  TP_rle_decode,       // rle_bwd_create() or rle_bwd_draw()
+  TP_update_hands,     // update_hands()
+  TP_launch,           // handle_init() to the end of the first complete frame
+  TP_num_phases,
+} TimingPhase;
+
+#ifndef NDEBUG
+  // The number of recent timings kept for timing_dump_log().
+  #define TIMING_RING_SIZE 64
+
+  // Times the code between TIMER_START(var) and TIMER_STOP(phase,
+  // var), in milliseconds.  TIMER_STOP_DETAIL() also records a small
+  // number that distinguishes one kind of update from another (for
+  // instance, the FrameKind of a frame).
+  #define TIMER_START(var) unsigned int var = timing_now_ms()
+  #define TIMER_STOP(phase, var) timing_record(phase, 0, var)
+  #define TIMER_STOP_DETAIL(phase, detail, var) timing_record(phase, detail, var)
+
+unsigned int timing_now_ms();
+void timing_record(TimingPhase phase, int detail, unsigned int start_ms);
+void timing_launch_start();
+void timing_launch_stop();
+void timing_dump_log();
+
+// The duration of the last frame and of the longest since startup,
+// and the time spent decoding rle resources for the last frame.
+extern unsigned int timing_last_frame_ms;
+extern unsigned int timing_max_frame_ms;
+extern unsigned int timing_frame_decode_ms;
+
+#else  // NDEBUG
+  // In a production build, the timers disappear entirely.
+  #define TIMER_START(var)
+  #define TIMER_STOP(phase, var)
+  #define TIMER_STOP_DETAIL(phase, detail, var) (void)(detail)
+  #define timing_launch_start()
+  #define timing_launch_stop()
+  #define timing_dump_log()
+
+#endif  // NDEBUG
+
+#endif  // TIMING_H
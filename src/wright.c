@@ -2,6 +2,8 @@
 #include "wright_chrono.h"
 #include "hand_table.h"
 #include "qapp_log.h"
+#include "timing.h"
+#include "assets.h"
 #include <ctype.h>
 
 #include "../resources/generated_table.c"
@@ -9,6 +11,14 @@
 
 bool memory_panic_flag = false;
 int memory_panic_count = 0;
+
+// The number of memory panics in a row that reset_memory_panic() has
+// answered by evicting an asset, rather than by giving up a feature.
+// It is cleared by each frame that draws without a panic; if it
+// reaches MAX_PANIC_EVICTIONS, eviction isn't keeping up, and the
+// next panic gives something up after all.
+#define MAX_PANIC_EVICTIONS 8
+static int panic_evictions = 0;
 int draw_face_count = 0;
 bool app_in_focus = true;
 
@@ -18,6 +28,34 @@ BitmapWithData clock_face;
 int face_index = -1;
 Layer *clock_face_layer;
 
+// hands_face is a second render, of clock_face with the phase 1 hands
+// (the hour and minute hands, or the chrono subdial hands) drawn over
+// it.  While the second hand is running, each frame can then restore
+// the face from hands_face and draw only the phase 2 hands, instead
+// of redrawing the phase 1 hands every second.  redraw_hands_face is
+// set when the phase 1 hands have moved; the bitmap's memory is kept
+// to be reused for the next render.  keep_hands_face is cleared if we
+// find we can't afford the memory.  drew_from_hands_face is set by
+// each frame that was restored from hands_face.
+BitmapWithData hands_face;
+bool redraw_hands_face = false;
+bool keep_hands_face = true;
+bool drew_from_hands_face = false;
+
+// When only the second hand has moved, we don't redraw all of
+// clock_face_layer; instead second_hand_layer is placed over the
+// rectangle the second hand swept, and restores just that part of
+// the face from clock_face and redraws the hands over it, clipped by
+// the system to the layer.  frame_intact is true when the frame
+// buffer still holds the last complete frame, which this relies on;
+// partial_redraw is true when the next frame should be drawn this
+// way, and partial_redraw_box is the rectangle to redraw.
+Layer *second_hand_layer;
+bool frame_intact = false;
+bool partial_redraw = false;
+bool partial_redraw_now = false;
+GRect partial_redraw_box;
+
 BitmapWithData date_window;
 BitmapWithData date_window_mask;
 bool date_window_dynamic = false;
@@ -45,6 +83,10 @@ GFont fallback_font = NULL;
 GFont date_numeric_font = NULL;
 GFont date_lang_font = NULL;
 
+// The heap taken by the date fonts when they were loaded, since there
+// is no asking a font its size.
+size_t date_fonts_size = 0;
+
 bool save_framebuffer = true;
 bool any_obstructed_area = false;
 
@@ -62,6 +104,11 @@ bool redraw_clock_face = false;
 
 #define MIN_BYTES_FREE 512  // maybe this is enough?
 
+// We only keep hands_face if this much is still free afterwards, on
+// top of what the resource cache and the rle cache may yet grow into,
+// for the hand bitmaps and whatever else comes along.
+#define HANDS_FACE_MIN_BYTES_FREE 4096
+
 #define DATE_WINDOW_BUFFER_SIZE 16
 
 #define PEBBLE_LABEL_OFFSET_X ((SUBDIAL_SIZE_X - PEBBLE_LABEL_SIZE_X) / 2)
@@ -90,22 +137,52 @@ char *date_names[NUM_DATE_NAMES];
 
 int display_lang = -1;
 
-#if ENABLE_SWEEP_SECONDS
-// Triggered at regular intervals to implement sweep seconds.
-AppTimer *sweep_timer = NULL;
-int sweep_timer_ms = 1000;
-#endif  // ENABLE_SWEEP_SECONDS
+#ifdef SUPPORT_WAKE_TIMER
+// The one timer that wakes us up between ticks, for the things that
+// change more often than the tick service fires (see
+// reset_wake_timer()).
+AppTimer *wake_timer = NULL;
 
-int sweep_seconds_ms = 60 * 1000 / NUM_STEPS_SECOND;
+// If the clock says the next tick is due within this many ms of a
+// call to reset_wake_timer(), it's the tick being handled now.
+#define WAKE_TICK_SLACK_MS 50
+#endif  // SUPPORT_WAKE_TIMER
 
 struct HandCache hour_cache;
 struct HandCache minute_cache;
 struct HandCache second_cache;
 
-#ifdef SUPPORT_RESOURCE_CACHE
-struct ResourceCache second_resource_cache[SECOND_RESOURCE_CACHE_SIZE + SECOND_MASK_RESOURCE_CACHE_SIZE];
-size_t second_resource_cache_size = SECOND_RESOURCE_CACHE_SIZE + SECOND_MASK_RESOURCE_CACHE_SIZE;
-#endif  // SUPPORT_RESOURCE_CACHE
+// When memory runs short, the second hand steps down through these
+// tiers before it is given up altogether (see reset_memory_panic()),
+// and back up again once memory has recovered (see
+// check_second_hand_tier()).  At SHT_reduced, a second hand with a
+// vector form is drawn with that alone, without its bitmaps; one with
+// only bitmaps is drawn at every SECOND_HAND_COARSE_STRIDE'th step,
+// so fewer of its bitmaps are decoded and cached.
+enum SecondHandTier {
+  SHT_full,
+  SHT_reduced,
+  SHT_off,
+};
+enum SecondHandTier second_hand_tier = SHT_full;
+#define SECOND_HAND_COARSE_STRIDE (NUM_STEPS_SECOND / 12)
+
+// The second hand comes back up a tier after second_hand_restore_wait
+// calls to check_memory_usage() in a row have found room for it, plus
+// SECOND_HAND_RESTORE_MIN_BYTES_FREE to spare, in one block.  The
+// wait starts at SECOND_HAND_RESTORE_CHECKS, and doubles (up to
+// SECOND_HAND_RESTORE_MAX_CHECKS) each time a restored tier is lost
+// to another panic, so that a hand that doesn't fit isn't stepped up
+// and down again every hour.
+#define SECOND_HAND_RESTORE_CHECKS 60
+#define SECOND_HAND_RESTORE_MAX_CHECKS (SECOND_HAND_RESTORE_CHECKS << 8)
+#define SECOND_HAND_RESTORE_MIN_BYTES_FREE 2048
+static int second_hand_restore_checks = 0;
+static int second_hand_restore_wait = SECOND_HAND_RESTORE_CHECKS;
+static bool second_hand_restored = false;  // true if a tier has been restored since the last panic took one
+
+// A copy of second_hand_def without its bitmaps, for SHT_reduced.
+static struct HandDef second_hand_vector_def;
 
 struct HandPlacement current_placement;
 
@@ -138,6 +215,9 @@ VibePattern tap = {
 void create_temporal_objects();
 void destroy_temporal_objects();
 void recreate_all_objects();
+static void prepare_date_fonts();
+static void release_bitmaps();
+static void recolor_bitmaps();
 void draw_full_date_window(GContext *ctx, int date_window_index);
 void draw_date_window_dynamic_text(GContext *ctx, int date_window_index);
 void health_event_handler(HealthEventType event, void *context);
@@ -156,7 +236,9 @@ GFont safe_load_custom_font(int resource_id) {
     fallback_font = fonts_get_system_font(FONT_KEY_FONT_FALLBACK);
   }
 
+  HEAP_TRACE_BEGIN("safe_load_custom_font");
   GFont font = fonts_load_custom_font(resource);
+  HEAP_TRACE_END();
   if (font == fallback_font) {
     qapp_log(APP_LOG_LEVEL_WARNING, __FILE__, __LINE__, "font %d failed to load", resource_id);
     //trigger_memory_panic(__LINE__);
@@ -186,10 +268,60 @@ void hand_cache_init(struct HandCache *hand_cache) {
   memset(hand_cache, 0, sizeof(struct HandCache));
 }
 
+// Releases one of the bitmaps held within a HandCache: returns it to
+// the resource cache if it was borrowed from there, or destroys it
+// otherwise.
+static void hand_cache_release_bitmap(BitmapWithData *bwd, bool *borrowed) {
+  if (*borrowed) {
+    bwd_cache_return(bwd);
+    *bwd = bwd_create(NULL, NULL);
+    *borrowed = false;
+  } else {
+    bwd_destroy(bwd);
+  }
+}
+
+// Releases the image and mask held within a HandCache, whether they
+// are borrowed, buffers, or neither.
+static void hand_cache_release_bitmaps(struct HandCache *hand_cache) {
+  hand_cache_release_bitmap(&hand_cache->image, &hand_cache->image_borrowed);
+  hand_cache_release_bitmap(&hand_cache->mask, &hand_cache->mask_borrowed);
+  if (hand_cache->buffered) {
+    hand_cache->image_capacity = 0;
+    hand_cache->mask_capacity = 0;
+    rle_window_destroy(&hand_cache->window);
+    hand_cache->buffered = false;
+  }
+}
+
+// Returns the number of bytes of heap held by the bitmaps of a
+// HandCache, not counting those borrowed from the resource cache.
+size_t hand_cache_get_size(struct HandCache *hand_cache) {
+  size_t size = 0;
+  if (hand_cache->buffered) {
+    size += hand_cache->image_capacity + hand_cache->mask_capacity + hand_cache->window.size;
+  } else {
+    if (!hand_cache->image_borrowed) {
+      size += bwd_get_size(&hand_cache->image);
+    }
+    if (!hand_cache->mask_borrowed) {
+      size += bwd_get_size(&hand_cache->mask);
+    }
+  }
+#ifdef SUPPORT_HAND_ROTATION
+  size += bwd_get_size(&hand_cache->master) + bwd_get_size(&hand_cache->master_mask);
+#endif  // SUPPORT_HAND_ROTATION
+  return size;
+}
+
 // Release any memory held within a HandCache structure.
 void hand_cache_destroy(struct HandCache *hand_cache) {
-  bwd_destroy(&hand_cache->image);
-  bwd_destroy(&hand_cache->mask);
+  hand_cache_release_bitmaps(hand_cache);
+  hand_cache->stale = false;
+#ifdef SUPPORT_HAND_ROTATION
+  bwd_destroy(&hand_cache->master);
+  bwd_destroy(&hand_cache->master_mask);
+#endif  // SUPPORT_HAND_ROTATION
   int gi;
   for (gi = 0; gi < HAND_CACHE_MAX_GROUPS; ++gi) {
     if (hand_cache->path[gi] != NULL) {
@@ -199,6 +331,67 @@ void hand_cache_destroy(struct HandCache *hand_cache) {
   }
 }
 
+// Remaps the bitmaps of a HandCache to new colors, as by
+// bwd_recolor(), or releases them if they can't be.  Bitmaps borrowed
+// from the resource cache are remapped there too.
+void hand_cache_recolor(struct HandCache *hand_cache, const BwdRemap *remap) {
+  bool recolored = bwd_recolor(&hand_cache->image, remap) && bwd_recolor(&hand_cache->mask, remap);
+#ifdef SUPPORT_HAND_ROTATION
+  recolored = recolored && bwd_recolor(&hand_cache->master, remap) && bwd_recolor(&hand_cache->master_mask, remap);
+#endif  // SUPPORT_HAND_ROTATION
+  if (!recolored) {
+    hand_cache_destroy(hand_cache);
+  }
+}
+
+#ifdef FAST_TIME
+// The real time, in ms since the epoch, at which the virtual clock
+// started.
+static int64_t fast_time_start_ms = -1;
+#endif  // FAST_TIME
+
+// Returns the current time, in seconds since the epoch (UTC) plus
+// milliseconds, as time_ms() does.  This is the time source behind
+// compute_hands() and get_time_ms().  In a FAST_TIME build it is a
+// virtual clock instead, which starts at the real time and runs
+// FAST_TIME_RATE times faster, so that the hands, the date windows
+// and the moon all move along together.
+void get_clock_time(time_t *gmt, uint16_t *t_ms) {
+  time_ms(gmt, t_ms);
+
+#ifdef FAST_TIME
+  int64_t now_ms = (int64_t)(*gmt) * 1000 + *t_ms;
+  if (fast_time_start_ms < 0) {
+    fast_time_start_ms = now_ms;
+  }
+  now_ms = fast_time_start_ms + (now_ms - fast_time_start_ms) * FAST_TIME_RATE;
+  *gmt = (time_t)(now_ms / 1000);
+  *t_ms = (uint16_t)(now_ms % 1000);
+#endif  // FAST_TIME
+}
+
+// The local time at the start of the current minute, as last
+// returned by localtime().  We assume the UTC offset only changes on
+// a minute boundary, so that the sub-second updates needn't call
+// localtime() each time.
+static time_t local_minute_gmt = 0;
+static struct tm local_minute_tm;
+static bool got_local_minute = false;
+
+// Returns the local time corresponding to gmt, like localtime(), but
+// only calls localtime() once per minute.
+struct tm *get_local_time(time_t gmt) {
+  static struct tm local_tm;
+  if (!got_local_minute || gmt < local_minute_gmt || gmt >= local_minute_gmt + 60) {
+    local_minute_tm = *localtime(&gmt);
+    local_minute_gmt = gmt - local_minute_tm.tm_sec;
+    got_local_minute = true;
+  }
+  local_tm = local_minute_tm;
+  local_tm.tm_sec = (int)(gmt - local_minute_gmt);
+  return &local_tm;
+}
+
 time_t
 make_gmt_date(int mday, int mon, int year) {
   struct tm t;
@@ -209,6 +402,27 @@ make_gmt_date(int mday, int mon, int year) {
   return mktime(&t);
 }
 
+// Returns the number of steps the second hand moves at once: 1
+// normally, or SECOND_HAND_COARSE_STRIDE when a bitmap-only second
+// hand is reduced.
+static int get_second_hand_stride() {
+  if (second_hand_tier == SHT_reduced && second_hand_def.vector_hand == NULL) {
+    return SECOND_HAND_COARSE_STRIDE;
+  }
+  return 1;
+}
+
+// Returns the HandDef to draw the second hand with, at its current
+// tier.
+static struct HandDef *get_second_hand_def() {
+  if (second_hand_tier == SHT_reduced && second_hand_def.vector_hand != NULL) {
+    second_hand_vector_def = second_hand_def;
+    second_hand_vector_def.bitmap_table = NULL;
+    return &second_hand_vector_def;
+  }
+  return &second_hand_def;
+}
+
 // Determines the specific hand bitmaps that should be displayed based
 // on the current time.
 void compute_hands(struct tm *stime, struct HandPlacement *placement) {
@@ -225,24 +439,29 @@ void compute_hands(struct tm *stime, struct HandPlacement *placement) {
   uint16_t t_ms = 0;
   unsigned int ms;
 
-  if (needs_sub_second || stime == NULL) {
-    // If we do need sub-second precision, it replaces the stime
-    // structure we were passed in.
+  if (needs_sub_second || stime == NULL || CLOCK_IS_VIRTUAL) {
+    // If we do need sub-second precision (or the time we were passed
+    // isn't the time we're showing), it replaces the stime structure
+    // we were passed in.
 
     // Get the Unix time (in UTC).
-    time_ms(&gmt, &t_ms);
+    get_clock_time(&gmt, &t_ms);
 
     // Compute the number of milliseconds elapsed since midnight, local time.
-    struct tm *tm = localtime(&gmt);
+    struct tm *tm = get_local_time(gmt);
     unsigned int s = (unsigned int)(tm->tm_hour * 60 + tm->tm_min) * 60 + tm->tm_sec;
     ms = (unsigned int)(s * 1000 + t_ms);
+    if (stime != NULL) {
+      stime = tm;
+    }
 
   } else {
     // If we don't need sub-second precision, just use the existing
     // stime structure.  We still need UTC time, though, for the lunar
     // phase at least.
     assert(stime != NULL);
-    gmt = time(NULL);
+    uint16_t gmt_ms;
+    get_clock_time(&gmt, &gmt_ms);
     unsigned int s = (unsigned int)(stime->tm_hour * 60 + stime->tm_min) * 60 + stime->tm_sec;
     ms = (unsigned int)(s * 1000);
   }
@@ -253,22 +472,6 @@ void compute_hands(struct tm *stime, struct HandPlacement *placement) {
   unsigned int ms_utc = (unsigned int)((gmt % SECONDS_PER_DAY) * 1000 + t_ms);
 #endif  // MAKE_CHRONOGRAPH
 
-#ifdef FAST_TIME
-  {
-    if (stime != NULL) {
-      int s = ms / 1000;
-      int yday = s % 365;
-
-      gmt = make_gmt_date(yday, 0, stime->tm_year);
-      (*stime) = *gmtime(&gmt);
-    }
-    ms *= 67;
-#ifdef MAKE_CHRONOGRAPH
-    ms_utc *= 67;
-#endif  // MAKE_CHRONOGRAPH
-  }
-#endif  // FAST_TIME
-
 #ifdef SCREENSHOT_BUILD
   // Freeze the time to 10:09 for screenshots.
   {
@@ -310,6 +513,7 @@ void compute_hands(struct tm *stime, struct HandPlacement *placement) {
       use_ms = (use_ms / 1000) * 1000;
     }
     placement->second_hand_index = ((NUM_STEPS_SECOND * use_ms) / (60 * 1000));
+    placement->second_hand_index -= placement->second_hand_index % get_second_hand_stride();
   }
 
   // Record data for date windows.
@@ -357,6 +561,7 @@ void compute_hands(struct tm *stime, struct HandPlacement *placement) {
   }
 
   placement->buzzed_hour = (ms / (SECONDS_PER_HOUR * 1000)) % 24;
+  placement->polled_minute = (ms / (60 * 1000)) % 60;
 
 #ifdef MAKE_CHRONOGRAPH
   compute_chrono_hands(ms_utc, placement);
@@ -517,21 +722,213 @@ void flip_bitmap_y(GBitmap *image, short *cy) {
   }
 }
 
+#ifdef SUPPORT_HAND_ROTATION
+// Returns the value (the bit, or the palette index) of pixel x of a
+// bitmap row with the indicated number of pixels per byte.
+static inline int get_row_pixel(const uint8_t *row, int x, const int pixels_per_byte) {
+  switch (pixels_per_byte) {
+  case 8:
+    return (row[x >> 3] >> (x & 7)) & 0x1;
+  case 4:
+    return (row[x >> 2] >> (6 - ((x & 3) << 1))) & 0x3;
+  case 2:
+    return (row[x >> 1] >> (4 - ((x & 1) << 2))) & 0xf;
+  default:
+    return row[x];
+  }
+}
+
+// Stores value into pixel x of a bitmap row, as above.
+static inline void set_row_pixel(uint8_t *row, int x, int value, const int pixels_per_byte) {
+  int shift;
+  switch (pixels_per_byte) {
+  case 8:
+    shift = x & 7;
+    row[x >> 3] = (row[x >> 3] & ~(0x1 << shift)) | (value << shift);
+    break;
+  case 4:
+    shift = 6 - ((x & 3) << 1);
+    row[x >> 2] = (row[x >> 2] & ~(0x3 << shift)) | (value << shift);
+    break;
+  case 2:
+    shift = 4 - ((x & 1) << 2);
+    row[x >> 1] = (row[x >> 1] & ~(0xf << shift)) | (value << shift);
+    break;
+  default:
+    row[x] = value;
+  }
+}
+
+// Returns the bounding box of a bitmap of the indicated size after
+// it has been rotated clockwise by angle about its pixel (cx, cy).
+// The box is relative to the pivot: the pivot lands on pixel
+// (-origin.x, -origin.y) of the rotated bitmap.
+static GRect get_rotated_bounds(GSize size, int cx, int cy, int32_t angle) {
+  int32_t sine = sin_lookup(angle);
+  int32_t cosine = cos_lookup(angle);
+
+  // These are in 16.16 fixed point; TRIG_MAX_RATIO is near enough to
+  // 1 << 16 for our purposes.
+  int32_t min_x = 0, max_x = 0, min_y = 0, max_y = 0;
+  for (int corner = 0; corner < 4; ++corner) {
+    int dx = ((corner & 1) ? size.w - 1 : 0) - cx;
+    int dy = ((corner & 2) ? size.h - 1 : 0) - cy;
+    int32_t rx = dx * cosine - dy * sine;
+    int32_t ry = dx * sine + dy * cosine;
+    if (corner == 0 || rx < min_x) {
+      min_x = rx;
+    }
+    if (corner == 0 || rx > max_x) {
+      max_x = rx;
+    }
+    if (corner == 0 || ry < min_y) {
+      min_y = ry;
+    }
+    if (corner == 0 || ry > max_y) {
+      max_y = ry;
+    }
+  }
+
+  int x0 = min_x >> 16;
+  int y0 = min_y >> 16;
+  int x1 = (max_x + 0xffff) >> 16;
+  int y1 = (max_y + 0xffff) >> 16;
+  return GRect(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+}
+
+// The inner loop of rotate_bitmap(), specialized on pixels_per_byte.
+// Each destination pixel is mapped back into the source by stepping
+// (u, v), the source coordinates in 16.16 fixed point, along the
+// rotated axes, and takes the value of the nearest source pixel.
+// Destination pixels that map outside the source get clear.
+static inline void rotate_rows(uint8_t *dest_data, int dest_stride, GRect bounds,
+                               const uint8_t *source_data, int source_stride, GSize source_size,
+                               int cx, int cy, int32_t sine, int32_t cosine, int clear,
+                               const int pixels_per_byte) {
+  for (int y = 0; y < bounds.size.h; ++y) {
+    int dy = bounds.origin.y + y;
+    int32_t u = bounds.origin.x * cosine + dy * sine + (cx << 16) + 0x8000;
+    int32_t v = dy * cosine - bounds.origin.x * sine + (cy << 16) + 0x8000;
+    uint8_t *row = dest_data + y * dest_stride;
+    for (int x = 0; x < bounds.size.w; ++x) {
+      // Negative coordinates become very large unsigned ones, so a
+      // single comparison on each axis clips to the source.
+      unsigned int sx = (unsigned int)(u >> 16);
+      unsigned int sy = (unsigned int)(v >> 16);
+      int value = clear;
+      if (sx < (unsigned int)source_size.w && sy < (unsigned int)source_size.h) {
+        value = get_row_pixel(source_data + sy * source_stride, sx, pixels_per_byte);
+      }
+      set_row_pixel(row, x, value, pixels_per_byte);
+      u += cosine;
+      v -= sine;
+    }
+  }
+}
+
+// Draws source into dest, rotated clockwise by angle about the
+// source's pixel (cx, cy), using only integer arithmetic.  bounds
+// should have been computed by get_rotated_bounds(); dest must be at
+// least that large, and have the same format and palette as source.
+// dest's bounds are narrowed to the rotated image.  Pixels outside
+// the source take the value of its pixel (0, 0), which
+// config_watch.py ensures is clear.
+static void rotate_bitmap(GBitmap *dest, GBitmap *source, int cx, int cy, int32_t angle, GRect bounds) {
+  int pixels_per_byte = get_pixels_per_byte(source);
+  assert(pixels_per_byte == get_pixels_per_byte(dest));
+
+  gbitmap_set_bounds(dest, GRect(0, 0, bounds.size.w, bounds.size.h));
+  uint8_t *dest_data = gbitmap_get_data(dest);
+  int dest_stride = gbitmap_get_bytes_per_row(dest);
+  const uint8_t *source_data = gbitmap_get_data(source);
+  int source_stride = gbitmap_get_bytes_per_row(source);
+  GSize source_size = gbitmap_get_bounds(source).size;
+  int clear = get_row_pixel(source_data, 0, pixels_per_byte);
+
+  int32_t sine = sin_lookup(angle);
+  int32_t cosine = cos_lookup(angle);
+
+  // Choose the specialized loop once for the whole image.
+  switch (pixels_per_byte) {
+  case 8:
+    rotate_rows(dest_data, dest_stride, bounds, source_data, source_stride, source_size, cx, cy, sine, cosine, clear, 8);
+    break;
+
+#ifndef PBL_BW
+  case 4:
+    rotate_rows(dest_data, dest_stride, bounds, source_data, source_stride, source_size, cx, cy, sine, cosine, clear, 4);
+    break;
+
+  case 2:
+    rotate_rows(dest_data, dest_stride, bounds, source_data, source_stride, source_size, cx, cy, sine, cosine, clear, 2);
+    break;
+
+  case 1:
+    rotate_rows(dest_data, dest_stride, bounds, source_data, source_stride, source_size, cx, cy, sine, cosine, clear, 1);
+    break;
+#endif  // PBL_BW
+  }
+}
+
+// Creates a blank bitmap of the indicated size, in the same format
+// and with the same palette as source, to receive the rotations of
+// source.
+static BitmapWithData create_rotation_buffer(GBitmap *source, GSize size) {
+  GBitmap *bitmap = NULL;
+#ifdef PBL_BW
+  bitmap = gbitmap_create_blank(size, GBitmapFormat1Bit);
+
+#else  // PBL_BW
+  GBitmapFormat format = gbitmap_get_format(source);
+  size_t palette_count = 0;
+  switch (format) {
+  case GBitmapFormat1BitPalette:
+    palette_count = 2;
+    break;
+
+  case GBitmapFormat2BitPalette:
+    palette_count = 4;
+    break;
+
+  case GBitmapFormat4BitPalette:
+    palette_count = 16;
+    break;
+
+  default:
+    break;
+  }
+
+  if (palette_count != 0) {
+    GColor *palette = (GColor *)malloc(palette_count * sizeof(GColor));
+    if (palette == NULL) {
+      return bwd_create(NULL, NULL);
+    }
+    memcpy(palette, gbitmap_get_palette(source), palette_count * sizeof(GColor));
+    bitmap = gbitmap_create_blank_with_palette(size, format, palette, true);
+    if (bitmap == NULL) {
+      free(palette);
+    }
+  } else {
+    bitmap = gbitmap_create_blank(size, format);
+  }
+#endif  // PBL_BW
+
+  if (bitmap == NULL) {
+    qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "could not create rotation buffer of size %dx%d", size.w, size.h);
+  }
+  return bwd_create(bitmap, NULL);
+}
+#endif  // SUPPORT_HAND_ROTATION
+
 // Draws a given hand on the face, using the vector structures.
 void draw_vector_hand(struct HandCache *hand_cache, struct HandDef *hand_def, int hand_index, GContext *ctx) {
   struct VectorHand *vector_hand = hand_def->vector_hand;
 
   int gi;
-  if (hand_cache->vector_hand_index != hand_index) {
-    // Force a new path.
-    for (gi = 0; gi < vector_hand->num_groups; ++gi) {
-      if (hand_cache->path[gi] != NULL) {
-        gpath_destroy(hand_cache->path[gi]);
-        hand_cache->path[gi] = NULL;
-      }
-    }
-    hand_cache->vector_hand_index = hand_index;
-  }
+  // The paths are created once, and only rotated anew when the hand
+  // moves.
+  bool moved = (hand_cache->vector_hand_index != hand_index);
+  hand_cache->vector_hand_index = hand_index;
 
   GPoint center = { hand_def->place_x, hand_def->place_y };
   int32_t angle = TRIG_MAX_ANGLE * hand_index / hand_def->num_steps;
@@ -574,7 +971,9 @@ void draw_vector_hand(struct HandCache *hand_cache, struct HandDef *hand_def, in
         trigger_memory_panic(__LINE__);
         return;
       }
-
+      moved = true;
+    }
+    if (moved) {
       gpath_rotate_to(hand_cache->path[gi], angle);
       gpath_move_to(hand_cache->path[gi], center);
     }
@@ -582,17 +981,238 @@ void draw_vector_hand(struct HandCache *hand_cache, struct HandDef *hand_def, in
   }
 }
 
-// Clears the mask given hand on the face, using the bitmap
-// structures, if the mask is in use.  This must be called before
-// draw_bitmap_hand_fg().
-void draw_bitmap_hand_mask(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARAMS, struct HandDef *hand_def, int hand_index, bool no_basalt_mask, GContext *ctx) {
+// Loads the indicated bitmap of a hand into *bwd, remapped and
+// flipped as hand requires, ready to draw.  If use_resource_cache is
+// true, the bitmap is borrowed from the resource cache, or added to
+// it, and *borrowed is set true; hand_cache_destroy() then returns it
+// to the cache rather than destroying it.
+static void load_hand_bitmap(BitmapWithData *bwd, bool *borrowed, struct HandDef *hand_def, const struct BitmapHandTableRow *hand, int resource_id RESOURCE_CACHE_FORMAL_PARAMS) {
+  *borrowed = false;
+#ifdef SUPPORT_RESOURCE_CACHE
+  int variant = (hand->flip_x ? 1 : 0) | (hand->flip_y ? 2 : 0);
+  if (use_resource_cache) {
+    const BitmapWithData *cached = bwd_cache_lend(resource_id, variant);
+    if (cached != NULL) {
+      *bwd = *cached;
+      *borrowed = true;
+      return;
+    }
+  }
+#endif  // SUPPORT_RESOURCE_CACHE
+
+  // To minimize wasteful resource usage, if the hand is symmetric we
+  // can store only the bitmaps for the right half of the clock face,
+  // and flip them for the left half.  We can also do this vertically.
+  if (hand_def->use_rle) {
+    // The rle decoder can flip and remap the bitmap as it goes.
+    BwdRemap remap;
+    *bwd = rle_bwd_create_transformed(resource_id, hand->flip_x, hand->flip_y, get_remap_clock(&remap));
+    if (bwd->bitmap == NULL) {
+      return;
+    }
+
+  } else {
+    *bwd = png_bwd_create(resource_id);
+    if (bwd->bitmap == NULL) {
+      return;
+    }
+    remap_colors_clock(bwd);
+    if (hand->flip_x) {
+      flip_bitmap_x(bwd->bitmap, NULL);
+    }
+    if (hand->flip_y) {
+      flip_bitmap_y(bwd->bitmap, NULL);
+    }
+  }
+
+#ifdef SUPPORT_RESOURCE_CACHE
+  if (use_resource_cache && bwd_cache_add(resource_id, variant, bwd) != NULL) {
+    *borrowed = true;
+  }
+#endif  // SUPPORT_RESOURCE_CACHE
+}
+
+// Sets the hand's center point within its (possibly flipped) image.
+static void hand_cache_set_center(struct HandCache *hand_cache, struct BitmapHandTableRow *hand, struct BitmapHandCenterRow *lookup) {
+  GSize size = gbitmap_get_bounds(hand_cache->image.bitmap).size;
+  hand_cache->cx = hand->flip_x ? size.w - 1 - lookup->cx : lookup->cx;
+  hand_cache->cy = hand->flip_y ? size.h - 1 - lookup->cy : lookup->cy;
+}
+
+#ifdef SUPPORT_HAND_ROTATION
+// Rotates the single bitmap of a runtime-rotated hand (and its mask,
+// if with_mask) into hand_cache's image (and mask) at the angle of
+// hand_index.  The first time, this also loads the unrotated
+// bitmaps, and allocates image and mask large enough to hold the
+// hand at any of its steps, so they can be reused for every angle.
+// Returns false on allocation failure.
+static bool rotate_hand_bitmaps(struct HandCache *hand_cache, struct HandDef *hand_def, int hand_index, bool with_mask) {
+  static const struct BitmapHandTableRow unflipped = { 0, false, false };
+  struct BitmapHandCenterRow *lookup = &hand_def->bitmap_centers[0];
+  bool borrowed;
+
+  // The unrotated bitmaps are kept here in the HandCache, rather than
+  // in the resource cache.
+  if (hand_cache->master.bitmap == NULL) {
+    load_hand_bitmap(&hand_cache->master, &borrowed, hand_def, &unflipped, hand_def->resource_id RESOURCE_CACHE_PARAMS(false));
+    if (hand_cache->master.bitmap == NULL) {
+      return false;
+    }
+  }
+  if (with_mask && hand_cache->master_mask.bitmap == NULL) {
+    load_hand_bitmap(&hand_cache->master_mask, &borrowed, hand_def, &unflipped, hand_def->resource_mask_id RESOURCE_CACHE_PARAMS(false));
+    if (hand_cache->master_mask.bitmap == NULL) {
+      return false;
+    }
+  }
+
+  GSize master_size = gbitmap_get_bounds(hand_cache->master.bitmap).size;
+  if (hand_cache->image.bitmap == NULL || (with_mask && hand_cache->mask.bitmap == NULL)) {
+    // Size the buffers for the largest of the rotations.
+    GSize size = GSize(0, 0);
+    for (int i = 0; i < hand_def->num_steps; ++i) {
+      GRect bounds = get_rotated_bounds(master_size, lookup->cx, lookup->cy, TRIG_MAX_ANGLE * i / hand_def->num_steps);
+      if (bounds.size.w > size.w) {
+        size.w = bounds.size.w;
+      }
+      if (bounds.size.h > size.h) {
+        size.h = bounds.size.h;
+      }
+    }
+    if (hand_cache->image.bitmap == NULL) {
+      hand_cache->image = create_rotation_buffer(hand_cache->master.bitmap, size);
+      if (hand_cache->image.bitmap == NULL) {
+        return false;
+      }
+    }
+    if (with_mask && hand_cache->mask.bitmap == NULL) {
+      hand_cache->mask = create_rotation_buffer(hand_cache->master_mask.bitmap, size);
+      if (hand_cache->mask.bitmap == NULL) {
+        return false;
+      }
+    }
+  }
+
+  int32_t angle = TRIG_MAX_ANGLE * hand_index / hand_def->num_steps;
+  GRect bounds = get_rotated_bounds(master_size, lookup->cx, lookup->cy, angle);
+  rotate_bitmap(hand_cache->image.bitmap, hand_cache->master.bitmap, lookup->cx, lookup->cy, angle, bounds);
+  if (with_mask) {
+    rotate_bitmap(hand_cache->mask.bitmap, hand_cache->master_mask.bitmap, lookup->cx, lookup->cy, angle, bounds);
+  }
+  hand_cache->cx = -bounds.origin.x;
+  hand_cache->cy = -bounds.origin.y;
+  hand_cache->stale = false;
+  return true;
+}
+#endif  // SUPPORT_HAND_ROTATION
+
+// Returns true if hand_cache does not yet hold the bitmaps for its
+// hand at bitmap_hand_index.
+static bool hand_cache_needs_bitmap(struct HandCache *hand_cache) {
+  return hand_cache->stale || hand_cache->image.bitmap == NULL;
+}
+
+// Decodes the bitmap of the hand at hand (and its mask, if
+// with_mask) into hand_cache's image and mask, which are buffers
+// allocated the first time at the largest size of any of the hand's
+// bitmaps, and then kept from one step to the next, so that a moving
+// hand doesn't go back to the heap each time.  The same goes for the
+// window the resources are read through.  Returns false on failure.
+static bool hand_cache_load_buffered(struct HandCache *hand_cache, struct HandDef *hand_def, struct BitmapHandTableRow *hand, bool with_mask) {
+  if (!hand_cache->buffered) {
+    hand_cache_release_bitmaps(hand_cache);
+    hand_cache->buffered = true;
+  }
+
+  if (hand_cache->window.data == NULL) {
+    int num_bitmaps = 0;
+    for (int i = 0; i < hand_def->num_steps; ++i) {
+      if (hand_def->bitmap_table[i].bitmap_index >= num_bitmaps) {
+        num_bitmaps = hand_def->bitmap_table[i].bitmap_index + 1;
+      }
+    }
+    size_t window_size = rle_max_resource_size(hand_def->resource_id, num_bitmaps);
+    if (hand_def->resource_mask_id != hand_def->resource_id) {
+      size_t mask_size = rle_max_resource_size(hand_def->resource_mask_id, num_bitmaps);
+      if (mask_size > window_size) {
+        window_size = mask_size;
+      }
+    }
+    if (!rle_window_reserve(&hand_cache->window, window_size)) {
+      return false;
+    }
+  }
+
+  GSize max_size = GSize(hand_def->max_w, hand_def->max_h);
+  int bitmap_index = hand->bitmap_index;
+  BwdRemap remap_storage;
+  const BwdRemap *remap = get_remap_clock(&remap_storage);
+  if (!rle_bwd_create_into(&hand_cache->image, &hand_cache->image_capacity, max_size, &hand_cache->window, hand_def->resource_id + bitmap_index, hand->flip_x, hand->flip_y, remap)) {
+    return false;
+  }
+  if (with_mask && !rle_bwd_create_into(&hand_cache->mask, &hand_cache->mask_capacity, max_size, &hand_cache->window, hand_def->resource_mask_id + bitmap_index, hand->flip_x, hand->flip_y, remap)) {
+    return false;
+  }
+  return true;
+}
+
+// Loads the image of the hand at hand_index into hand_cache (and the
+// mask too, if with_mask), and sets its center point.  Returns false
+// on allocation failure.
+static bool hand_cache_load(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARAMS, struct HandDef *hand_def, int hand_index, bool with_mask) {
+#ifdef SUPPORT_HAND_ROTATION
+  if (hand_def->rotate) {
+    return rotate_hand_bitmaps(hand_cache, hand_def, hand_index, with_mask);
+  }
+#endif  // SUPPORT_HAND_ROTATION
+
   struct BitmapHandTableRow *hand = &hand_def->bitmap_table[hand_index];
   int bitmap_index = hand->bitmap_index;
   struct BitmapHandCenterRow *lookup = &hand_def->bitmap_centers[bitmap_index];
+  hand_cache->stale = false;
 
-  int hand_resource_id = hand_def->resource_id + bitmap_index;
-  int hand_resource_mask_id = hand_def->resource_mask_id + bitmap_index;
+  // Bitmaps that would only be thrown away again when the hand moves
+  // are decoded into buffers instead; those shared with the resource
+  // cache are not.
+  bool use_buffers = hand_def->use_rle && hand_def->max_w != 0;
+#ifdef SUPPORT_RESOURCE_CACHE
+  use_buffers = use_buffers && !use_resource_cache;
+#endif  // SUPPORT_RESOURCE_CACHE
+  if (use_buffers && hand_cache_load_buffered(hand_cache, hand_def, hand, with_mask)) {
+    hand_cache_set_center(hand_cache, hand, lookup);
+    return true;
+  }
 
+  hand_cache_release_bitmaps(hand_cache);
+  load_hand_bitmap(&hand_cache->image, &hand_cache->image_borrowed, hand_def, hand, hand_def->resource_id + bitmap_index RESOURCE_CACHE_PARAMS(use_resource_cache));
+  if (with_mask) {
+    load_hand_bitmap(&hand_cache->mask, &hand_cache->mask_borrowed, hand_def, hand, hand_def->resource_mask_id + bitmap_index RESOURCE_CACHE_PARAMS(use_resource_cache));
+  }
+  if (hand_cache->image.bitmap == NULL || (with_mask && hand_cache->mask.bitmap == NULL)) {
+    return false;
+  }
+  hand_cache_set_center(hand_cache, hand, lookup);
+  return true;
+}
+
+// As hand_cache_load(), but if that fails, evicts other assets one at
+// a time (see asset_evict_one()) and tries again, until it succeeds or
+// there is nothing left to evict.
+static bool hand_cache_load_evicting(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARAMS, struct HandDef *hand_def, int hand_index, bool with_mask) {
+  asset_pin(hand_cache);
+  while (!hand_cache_load(hand_cache RESOURCE_CACHE_PARAMS(use_resource_cache), hand_def, hand_index, with_mask)) {
+    hand_cache_destroy(hand_cache);
+    if (!asset_evict_one()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Clears the mask given hand on the face, using the bitmap
+// structures, if the mask is in use.  This must be called before
+// draw_bitmap_hand_fg().
+void draw_bitmap_hand_mask(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARAMS, struct HandDef *hand_def, int hand_index, bool no_basalt_mask, GContext *ctx) {
 #ifdef PBL_BW
   if (hand_def->resource_id == hand_def->resource_mask_id)
 #else
@@ -602,38 +1222,12 @@ void draw_bitmap_hand_mask(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PA
     // The draw-without-a-mask case.  Do nothing here.
   } else {
     // The hand has a mask, so use it to draw the hand opaquely.
-    if (hand_cache->image.bitmap == NULL) {
-      if (hand_def->use_rle) {
-        hand_cache->image = rle_bwd_create_with_cache(hand_def->resource_id, hand_resource_id RESOURCE_CACHE_PARAMS(resource_cache, resource_cache_size));
-        hand_cache->mask = rle_bwd_create_with_cache(hand_def->resource_id, hand_resource_mask_id RESOURCE_CACHE_PARAMS(resource_cache, resource_cache_size));
-      } else {
-        hand_cache->image = png_bwd_create_with_cache(hand_def->resource_id, hand_resource_id RESOURCE_CACHE_PARAMS(resource_cache, resource_cache_size));
-        hand_cache->mask = png_bwd_create_with_cache(hand_def->resource_id, hand_resource_mask_id RESOURCE_CACHE_PARAMS(resource_cache, resource_cache_size));
-      }
-      if (hand_cache->image.bitmap == NULL || hand_cache->mask.bitmap == NULL) {
+    if (hand_cache_needs_bitmap(hand_cache)) {
+      if (!hand_cache_load_evicting(hand_cache RESOURCE_CACHE_PARAMS(use_resource_cache), hand_def, hand_index, true)) {
         hand_cache_destroy(hand_cache);
         trigger_memory_panic(__LINE__);
         return;
       }
-      remap_colors_clock(&hand_cache->image);
-      remap_colors_clock(&hand_cache->mask);
-
-      hand_cache->cx = lookup->cx;
-      hand_cache->cy = lookup->cy;
-
-      if (hand->flip_x) {
-        // To minimize wasteful resource usage, if the hand is symmetric
-        // we can store only the bitmaps for the right half of the clock
-        // face, and flip them for the left half.
-        flip_bitmap_x(hand_cache->image.bitmap, &hand_cache->cx);
-        flip_bitmap_x(hand_cache->mask.bitmap, NULL);
-      }
-
-      if (hand->flip_y) {
-        // We can also do this vertically.
-        flip_bitmap_y(hand_cache->image.bitmap, &hand_cache->cy);
-        flip_bitmap_y(hand_cache->mask.bitmap, NULL);
-      }
     }
 
     GRect destination = gbitmap_get_bounds(hand_cache->image.bitmap);
@@ -648,12 +1242,6 @@ void draw_bitmap_hand_mask(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PA
 // Draws a given hand on the face, using the bitmap structures.  You
 // must have already called draw_bitmap_hand_mask().
 void draw_bitmap_hand_fg(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARAMS, struct HandDef *hand_def, int hand_index, bool no_basalt_mask, GContext *ctx) {
-  struct BitmapHandTableRow *hand = &hand_def->bitmap_table[hand_index];
-  int bitmap_index = hand->bitmap_index;
-  struct BitmapHandCenterRow *lookup = &hand_def->bitmap_centers[bitmap_index];
-
-  int hand_resource_id = hand_def->resource_id + bitmap_index;
-
 #ifdef PBL_BW
   if (hand_def->resource_id == hand_def->resource_mask_id)
 #else
@@ -661,34 +1249,13 @@ void draw_bitmap_hand_fg(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARA
 #endif  // PBL_BW
   {
     // The hand does not have a mask.  Draw the hand on top of the scene.
-    if (hand_cache->image.bitmap == NULL) {
+    if (hand_cache_needs_bitmap(hand_cache)) {
       // All right, load it from the resource file.
-      if (hand_def->use_rle) {
-        hand_cache->image = rle_bwd_create_with_cache(hand_def->resource_id, hand_resource_id RESOURCE_CACHE_PARAMS(resource_cache, resource_cache_size));
-      } else {
-        hand_cache->image = png_bwd_create_with_cache(hand_def->resource_id, hand_resource_id RESOURCE_CACHE_PARAMS(resource_cache, resource_cache_size));
-      }
-      if (hand_cache->image.bitmap == NULL) {
+      if (!hand_cache_load_evicting(hand_cache RESOURCE_CACHE_PARAMS(use_resource_cache), hand_def, hand_index, false)) {
         hand_cache_destroy(hand_cache);
         trigger_memory_panic(__LINE__);
         return;
       }
-      remap_colors_clock(&hand_cache->image);
-
-      hand_cache->cx = lookup->cx;
-      hand_cache->cy = lookup->cy;
-
-      if (hand->flip_x) {
-        // To minimize wasteful resource usage, if the hand is symmetric
-        // we can store only the bitmaps for the right half of the clock
-        // face, and flip them for the left half.
-        flip_bitmap_x(hand_cache->image.bitmap, &hand_cache->cx);
-      }
-
-      if (hand->flip_y) {
-        // We can also do this vertically.
-        flip_bitmap_y(hand_cache->image.bitmap, &hand_cache->cy);
-      }
     }
 
     // We make sure the dimensions of the GRect to draw into
@@ -729,19 +1296,21 @@ void draw_bitmap_hand_fg(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARA
 // In general, prepares a hand for being drawn.  Specifically, this
 // clears the background behind a hand, if necessary.
 void draw_hand_mask(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARAMS, struct HandDef *hand_def, int hand_index, bool no_basalt_mask, GContext *ctx) {
+  // The hand's bitmaps must last until draw_hand_fg().
+  asset_pin(hand_cache);
   if (hand_def->bitmap_table != NULL) {
     if (hand_cache->bitmap_hand_index != hand_index) {
-      // Force a new bitmap.
-      if (hand_cache->image.bitmap != NULL) {
-        bwd_destroy(&hand_cache->image);
-      }
-      if (hand_cache->mask.bitmap != NULL) {
-        bwd_destroy(&hand_cache->mask);
+      if (hand_def->rotate || hand_cache->buffered) {
+        // Keep the bitmaps, but rotate them or decode them anew.
+        hand_cache->stale = true;
+      } else {
+        // Force a new bitmap.
+        hand_cache_release_bitmaps(hand_cache);
       }
       hand_cache->bitmap_hand_index = hand_index;
     }
 
-    draw_bitmap_hand_mask(hand_cache RESOURCE_CACHE_PARAMS(resource_cache, resource_cache_size), hand_def, hand_index, no_basalt_mask, ctx);
+    draw_bitmap_hand_mask(hand_cache RESOURCE_CACHE_PARAMS(use_resource_cache), hand_def, hand_index, no_basalt_mask, ctx);
   }
 }
 
@@ -754,33 +1323,98 @@ void draw_hand_fg(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARAMS, str
   }
 
   if (hand_def->bitmap_table != NULL) {
-    draw_bitmap_hand_fg(hand_cache RESOURCE_CACHE_PARAMS(resource_cache, resource_cache_size), hand_def, hand_index, no_basalt_mask, ctx);
+    draw_bitmap_hand_fg(hand_cache RESOURCE_CACHE_PARAMS(use_resource_cache), hand_def, hand_index, no_basalt_mask, ctx);
   }
 }
 
 void draw_hand(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARAMS, struct HandDef *hand_def, int hand_index, GContext *ctx) {
-  draw_hand_mask(hand_cache RESOURCE_CACHE_PARAMS(resource_cache, resource_cache_size), hand_def, hand_index, true, ctx);
-  draw_hand_fg(hand_cache RESOURCE_CACHE_PARAMS(resource_cache, resource_cache_size), hand_def, hand_index, true, ctx);
+  draw_hand_mask(hand_cache RESOURCE_CACHE_PARAMS(use_resource_cache), hand_def, hand_index, true, ctx);
+  draw_hand_fg(hand_cache RESOURCE_CACHE_PARAMS(use_resource_cache), hand_def, hand_index, true, ctx);
 }
 
-// Applies the appropriate color-remapping according to the selected
-// color mode, for the indicated clock-face or clock-hands bitmap.
-void remap_colors_clock(BitmapWithData *bwd) {
+// Returns the smallest rectangle containing both a and b.  An empty
+// rectangle contributes nothing.
+static GRect union_boxes(GRect a, GRect b) {
+  if (a.size.w <= 0 || a.size.h <= 0) {
+    return b;
+  }
+  if (b.size.w <= 0 || b.size.h <= 0) {
+    return a;
+  }
+  int x0 = (a.origin.x < b.origin.x) ? a.origin.x : b.origin.x;
+  int y0 = (a.origin.y < b.origin.y) ? a.origin.y : b.origin.y;
+  int ax1 = a.origin.x + a.size.w, bx1 = b.origin.x + b.size.w;
+  int ay1 = a.origin.y + a.size.h, by1 = b.origin.y + b.size.h;
+  int x1 = (ax1 > bx1) ? ax1 : bx1;
+  int y1 = (ay1 > by1) ? ay1 : by1;
+  return GRect(x0, y0, x1 - x0, y1 - y0);
+}
+
+// Returns the rectangle of the face that the hand covers at
+// hand_index, from the bitmap sizes in the generated tables and the
+// points of its vector paths, without loading anything.
+static GRect get_hand_box(struct HandDef *hand_def, int hand_index) {
+  GRect box = GRect(0, 0, 0, 0);
+  int32_t angle = TRIG_MAX_ANGLE * hand_index / hand_def->num_steps;
+
+  if (hand_def->bitmap_table != NULL) {
+#ifdef SUPPORT_HAND_ROTATION
+    if (hand_def->rotate) {
+      struct BitmapHandCenterRow *lookup = &hand_def->bitmap_centers[0];
+      box = get_rotated_bounds(GSize(lookup->w, lookup->h), lookup->cx, lookup->cy, angle);
+      box.origin.x += hand_def->place_x;
+      box.origin.y += hand_def->place_y;
+    } else
+#endif  // SUPPORT_HAND_ROTATION
+    {
+      struct BitmapHandTableRow *hand = &hand_def->bitmap_table[hand_index];
+      struct BitmapHandCenterRow *lookup = &hand_def->bitmap_centers[hand->bitmap_index];
+      int cx = hand->flip_x ? lookup->w - 1 - lookup->cx : lookup->cx;
+      int cy = hand->flip_y ? lookup->h - 1 - lookup->cy : lookup->cy;
+      box = GRect(hand_def->place_x - cx, hand_def->place_y - cy, lookup->w, lookup->h);
+    }
+  }
+
+  if (hand_def->vector_hand != NULL) {
+    // Rotate the points as gpath_rotate_to() will, and allow a pixel
+    // on each side for the stroke and the rounding.
+    int32_t sine = sin_lookup(angle);
+    int32_t cosine = cos_lookup(angle);
+    struct VectorHand *vector_hand = hand_def->vector_hand;
+    for (int gi = 0; gi < vector_hand->num_groups; ++gi) {
+      GPathInfo *path_info = &vector_hand->group[gi].path_info;
+      for (uint32_t pi = 0; pi < path_info->num_points; ++pi) {
+        GPoint p = path_info->points[pi];
+        int x = hand_def->place_x + (p.x * cosine - p.y * sine) / TRIG_MAX_RATIO;
+        int y = hand_def->place_y + (p.x * sine + p.y * cosine) / TRIG_MAX_RATIO;
+        box = union_boxes(box, GRect(x - 1, y - 1, 3, 3));
+      }
+    }
+  }
+
+  return box;
+}
+
+// Fills in the color-remapping appropriate to the selected color
+// mode for a clock-face or clock-hands bitmap.  Returns remap, or NULL
+// on B&W watches, where there is no remapping.
+const BwdRemap *get_remap_clock(BwdRemap *remap) {
 #ifndef PBL_BW
   struct FaceColorDef *cd = &clock_face_color_table[config.color_mode];
-  GColor cb, c1, c2, c3;
-  cb.argb = cd->cb_argb8;
-  c1.argb = cd->c1_argb8;
-  c2.argb = cd->c2_argb8;
-  c3.argb = cd->c3_argb8;
-
-  bwd_remap_colors(bwd, cb, c1, c2, c3, config.draw_mode);
+  remap->cb.argb = cd->cb_argb8;
+  remap->c1.argb = cd->c1_argb8;
+  remap->c2.argb = cd->c2_argb8;
+  remap->c3.argb = cd->c3_argb8;
+  remap->bank = clock_face_remap_bank[config.color_mode][REMAP_BANK_CLOCK];
+  remap->invert_colors = config.draw_mode;
+  return remap;
+#else  // PBL_BW
+  return NULL;
 #endif  // PBL_BW
 }
 
-// Applies the appropriate color-remapping according to the selected
-// color mode, for the indicated date-window bitmap.
-void remap_colors_date(BitmapWithData *bwd) {
+// As above, for a date-window bitmap.
+static const BwdRemap *get_remap_date(BwdRemap *remap) {
 #ifndef PBL_BW
   struct FaceColorDef *cd = &clock_face_color_table[config.color_mode];
   GColor db, d1;
@@ -790,13 +1424,21 @@ void remap_colors_date(BitmapWithData *bwd) {
   // I've experimented with using the blue channel for something
   // interesting, but couldn't really make it work.  So now only the
   // red channel is used in the date window (and battery gauge).
-  bwd_remap_colors(bwd, db, d1, db, db, config.draw_mode);
+  remap->cb = db;
+  remap->c1 = d1;
+  remap->c2 = db;
+  remap->c3 = db;
+  remap->bank = clock_face_remap_bank[config.color_mode][REMAP_BANK_DATE];
+  remap->invert_colors = config.draw_mode;
+  return remap;
+#else  // PBL_BW
+  return NULL;
 #endif  // PBL_BW
 }
 
-// Applies the appropriate color-remapping according to the selected
-// color mode, for the indicated lunar bitmap.
-static void remap_colors_moon(BitmapWithData *bwd) {
+#ifdef TOP_SUBDIAL
+// As above, for a lunar bitmap.
+static const BwdRemap *get_remap_moon(BwdRemap *remap) {
 #ifndef PBL_BW
   struct FaceColorDef *cd = &clock_face_color_table[config.color_mode];
   GColor bg, fg;
@@ -812,9 +1454,71 @@ static void remap_colors_moon(BitmapWithData *bwd) {
     bg.argb ^= 0x3f;
   }
 
-  bwd_remap_colors(bwd, bg, fg, GColorBlack, GColorPastelYellow, false);
+  remap->cb = bg;
+  remap->c1 = fg;
+  remap->c2 = GColorBlack;
+  remap->c3 = GColorPastelYellow;
+  remap->bank = NULL;
+  remap->invert_colors = false;
+  return remap;
+#else  // PBL_BW
+  return NULL;
 #endif  // PBL_BW
 }
+#endif  // TOP_SUBDIAL
+
+static void apply_remap(BitmapWithData *bwd, const BwdRemap *remap) {
+  if (remap != NULL) {
+    bwd_remap_colors(bwd, remap);
+  }
+}
+
+// Applies the appropriate color-remapping according to the selected
+// color mode, for the indicated clock-face or clock-hands bitmap.
+void remap_colors_clock(BitmapWithData *bwd) {
+  BwdRemap remap;
+  apply_remap(bwd, get_remap_clock(&remap));
+}
+
+// Applies the appropriate color-remapping according to the selected
+// color mode, for the indicated date-window bitmap.
+void remap_colors_date(BitmapWithData *bwd) {
+  BwdRemap remap;
+  apply_remap(bwd, get_remap_date(&remap));
+}
+
+// Draws the indicated rle asset into destination on the clock face
+// layer.  If bwd already holds the decoded bitmap, that is drawn.
+// Otherwise, if keep is true, the asset is decoded (and remapped) into
+// bwd first, so that it is there next time; if keep is false, it is
+// decoded straight into the frame buffer with rle_bwd_draw(), and bwd
+// remains empty.  Returns false on allocation failure.
+static bool draw_asset(GContext *ctx, BitmapWithData *bwd, int resource_id, GRect destination, GCompOp op, const BwdRemap *remap, bool keep) {
+  if (bwd->bitmap == NULL) {
+    // If there isn't room, evict other assets until there is (or
+    // there's nothing left to evict).
+    if (!keep) {
+      while (!rle_bwd_draw(clock_face_layer, ctx, resource_id, destination, op, remap)) {
+        if (!asset_evict_one()) {
+          return false;
+        }
+      }
+      return true;
+    }
+    *bwd = rle_bwd_create_transformed(resource_id, false, false, remap);
+    while (bwd->bitmap == NULL) {
+      if (!asset_evict_one()) {
+        return false;
+      }
+      *bwd = rle_bwd_create_transformed(resource_id, false, false, remap);
+    }
+  }
+  asset_touch(bwd);
+
+  graphics_context_set_compositing_mode(ctx, op);
+  graphics_draw_bitmap_in_rect(ctx, bwd->bitmap, destination);
+  return true;
+}
 
 #ifndef PREBAKE_LABEL
 void draw_pebble_label(Layer *me, GContext *ctx, bool invert) {
@@ -836,14 +1540,12 @@ void draw_pebble_label(Layer *me, GContext *ctx, bool invert) {
 #endif  // PBL_BW
 
   if (pebble_label.bitmap == NULL) {
-    pebble_label = rle_bwd_create(RESOURCE_ID_PEBBLE_LABEL);
+    BwdRemap remap;
+    pebble_label = rle_bwd_create_transformed(RESOURCE_ID_PEBBLE_LABEL, false, false, get_remap_clock(&remap));
     if (pebble_label.bitmap == NULL) {
       trigger_memory_panic(__LINE__);
       return;
     }
-#ifndef PBL_BW
-    remap_colors_clock(&pebble_label);
-#endif  // PBL_BW
   }
 
   graphics_context_set_compositing_mode(ctx, draw_mode_table[draw_mode].paint_fg);
@@ -871,47 +1573,32 @@ void draw_moon_phase_subdial(Layer *me, GContext *ctx, bool invert) {
   GRect destination = GRect(window->x, window->y, SUBDIAL_SIZE_X, SUBDIAL_SIZE_Y);
 
   // First draw the subdial details (including the background).
+  BwdRemap remap;
 #ifdef PBL_BW
-  if (top_subdial_frame_mask.bitmap == NULL) {
-    top_subdial_frame_mask = rle_bwd_create(RESOURCE_ID_TOP_SUBDIAL_FRAME_MASK);
-    if (top_subdial_frame_mask.bitmap == NULL) {
-      trigger_memory_panic(__LINE__);
-      return;
-    }
+  if (!draw_asset(ctx, &top_subdial_frame_mask, RESOURCE_ID_TOP_SUBDIAL_FRAME_MASK, destination,
+                  draw_mode_table[draw_mode].paint_bg, NULL, keep_assets)) {
+    trigger_memory_panic(__LINE__);
+    return;
   }
-  graphics_context_set_compositing_mode(ctx, draw_mode_table[draw_mode].paint_bg);
-  graphics_draw_bitmap_in_rect(ctx, top_subdial_frame_mask.bitmap, destination);
   if (!keep_assets) {
     bwd_destroy(&top_subdial_frame_mask);
   }
 
-  if (top_subdial_mask.bitmap == NULL) {
-    top_subdial_mask = rle_bwd_create(RESOURCE_ID_TOP_SUBDIAL_MASK);
-    if (top_subdial_mask.bitmap == NULL) {
-      trigger_memory_panic(__LINE__);
-      return;
-    }
+  if (!draw_asset(ctx, &top_subdial_mask, RESOURCE_ID_TOP_SUBDIAL_MASK, destination,
+                  draw_mode_table[moon_draw_mode].paint_bg, NULL, keep_assets)) {
+    trigger_memory_panic(__LINE__);
+    return;
   }
-  graphics_context_set_compositing_mode(ctx, draw_mode_table[moon_draw_mode].paint_bg);
-  graphics_draw_bitmap_in_rect(ctx, top_subdial_mask.bitmap, destination);
   if (!keep_assets) {
     bwd_destroy(&top_subdial_mask);
   }
 #endif  // PBL_BW
 
-  if (top_subdial_bitmap.bitmap == NULL) {
-    top_subdial_bitmap = rle_bwd_create(RESOURCE_ID_TOP_SUBDIAL);
-    if (top_subdial_bitmap.bitmap == NULL) {
-      trigger_memory_panic(__LINE__);
-      return;
-    }
-#ifndef PBL_BW
-    remap_colors_clock(&top_subdial_bitmap);
-#endif  // PBL_BW
+  if (!draw_asset(ctx, &top_subdial_bitmap, RESOURCE_ID_TOP_SUBDIAL, destination,
+                  draw_mode_table[draw_mode].paint_fg, get_remap_clock(&remap), keep_assets)) {
+    trigger_memory_panic(__LINE__);
+    return;
   }
-
-  graphics_context_set_compositing_mode(ctx, draw_mode_table[draw_mode].paint_fg);
-  graphics_draw_bitmap_in_rect(ctx, top_subdial_bitmap.bitmap, destination);
   if (!keep_assets) {
     bwd_destroy(&top_subdial_bitmap);
   }
@@ -931,26 +1618,15 @@ void draw_moon_phase_subdial(Layer *me, GContext *ctx, bool invert) {
     index = NUM_STEPS_MOON - 1 - index;
   }
 
-  if (moon_wheel_bitmap.bitmap == NULL) {
 #ifdef PBL_BW
-    // On B&W watches, we load either "black" or "white" icons,
-    // according to what color we need the background to be.
-    if (moon_draw_mode == 0) {
-      moon_wheel_bitmap = rle_bwd_create(RESOURCE_ID_MOON_WHEEL_WHITE_0 + index);
-    } else {
-      moon_wheel_bitmap = rle_bwd_create(RESOURCE_ID_MOON_WHEEL_BLACK_0 + index);
-    }
+  // On B&W watches, we load either "black" or "white" icons,
+  // according to what color we need the background to be.
+  int moon_resource_id = (moon_draw_mode == 0) ? RESOURCE_ID_MOON_WHEEL_WHITE_0 + index : RESOURCE_ID_MOON_WHEEL_BLACK_0 + index;
 #else  // PBL_BW
-    // On color watches, we only use the "black" icons, and we remap
-    // the colors at load time.
-    moon_wheel_bitmap = rle_bwd_create(RESOURCE_ID_MOON_WHEEL_BLACK_0 + index);
-    remap_colors_moon(&moon_wheel_bitmap);
+  // On color watches, we only use the "black" icons, and we remap
+  // the colors at load time.
+  int moon_resource_id = RESOURCE_ID_MOON_WHEEL_BLACK_0 + index;
 #endif  // PBL_BW
-    if (moon_wheel_bitmap.bitmap == NULL) {
-      trigger_memory_panic(__LINE__);
-      return;
-    }
-  }
 
   // In the B&W case, we draw the moon in the fg color.  This will
   // be black-on-white if moon_draw_mode = 0, or white-on-black if
@@ -962,8 +1638,11 @@ void draw_moon_phase_subdial(Layer *me, GContext *ctx, bool invert) {
   // In the color case, the only difference between moon_black and
   // moon_white is the background color; in either case we draw them
   // both in GCompOpSet.
-  graphics_context_set_compositing_mode(ctx, draw_mode_table[moon_draw_mode].paint_fg);
-  graphics_draw_bitmap_in_rect(ctx, moon_wheel_bitmap.bitmap, destination);
+  if (!draw_asset(ctx, &moon_wheel_bitmap, moon_resource_id, destination,
+                  draw_mode_table[moon_draw_mode].paint_fg, get_remap_moon(&remap), keep_assets)) {
+    trigger_memory_panic(__LINE__);
+    return;
+  }
   if (!keep_assets) {
     bwd_destroy(&moon_wheel_bitmap);
   }
@@ -983,31 +1662,29 @@ int get_indicator_face_index() {
 void draw_clock_face(Layer *me, GContext *ctx) {
   qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "draw_clock_face");
   ++draw_face_count;
+  TIMER_START(start_ms);
 
-  // Reload the face bitmap from the resource file, if we don't
-  // already have it.
-  if (face_bitmap.bitmap == NULL) {
-    int resource_id = clock_face_table[config.face_index].resource_id;
+  int resource_id = clock_face_table[config.face_index].resource_id;
 #ifdef PREBAKE_LABEL
-    // If the pebble_label is enabled (and we've prebaked the labels
-    // into the faces), we load the next consecutive resource instead.
-    resource_id += (config.top_subdial == TSM_pebble_label);
+  // If the pebble_label is enabled (and we've prebaked the labels
+  // into the faces), we load the next consecutive resource instead.
+  resource_id += (config.top_subdial == TSM_pebble_label);
 #endif  // PREBAKE_LABEL
 
-    face_bitmap = rle_bwd_create(resource_id);
-    if (face_bitmap.bitmap == NULL) {
-      trigger_memory_panic(__LINE__);
-      return;
-    }
-    remap_colors_clock(&face_bitmap);
-  }
-
-  // Draw the clock face into the layer.
+  // Draw the clock face into the layer.  If we're not keeping the
+  // face bitmap around, we don't need to load it at all; it gets
+  // decoded right into the frame buffer.
   GRect destination = layer_get_bounds(me);
   destination.origin.x = 0;
   destination.origin.y = 0;
-  graphics_context_set_compositing_mode(ctx, draw_mode_table[config.draw_mode ^ BW_INVERT].paint_assign);
-  graphics_draw_bitmap_in_rect(ctx, face_bitmap.bitmap, destination);
+  BwdRemap remap;
+  if (!draw_asset(ctx, &face_bitmap, resource_id, destination,
+                  draw_mode_table[config.draw_mode ^ BW_INVERT].paint_assign,
+                  get_remap_clock(&remap), keep_face_asset)) {
+    trigger_memory_panic(__LINE__);
+    TIMER_STOP(TP_draw_clock_face, start_ms);
+    return;
+  }
 
   // Draw the top subdial if enabled.
   {
@@ -1054,12 +1731,16 @@ void draw_clock_face(Layer *me, GContext *ctx) {
     const struct IndicatorTable *window = &bluetooth_table[indicator_face_index];
     draw_bluetooth_indicator(ctx, window->x, window->y, window->invert);
   }
+
+  TIMER_STOP(TP_draw_clock_face, start_ms);
 }
 
 // Draws the hands that aren't the second hand--the hands that update
 // once a minute or slower, and which may potentially be cached along
 // with the clock face background.
 void draw_phase_1_hands(GContext *ctx) {
+  TIMER_START(start_ms);
+
 #ifdef MAKE_CHRONOGRAPH
 
   // A special case for Chronograph support.  All six hands are drawn
@@ -1067,12 +1748,12 @@ void draw_phase_1_hands(GContext *ctx) {
   // the non-chrono order--we draw the three subdials first, and this
   // includes the normal second hand).
   if (config.second_hand || chrono_data.running || chrono_data.hold_ms != 0) {
-    draw_hand(&chrono_minute_cache RESOURCE_CACHE_PARAMS(NULL, 0), &chrono_minute_hand_def, current_placement.chrono_minute_hand_index, ctx);
+    draw_hand(&chrono_minute_cache RESOURCE_CACHE_PARAMS(false), &chrono_minute_hand_def, current_placement.chrono_minute_hand_index, ctx);
   }
 
   if (config.chrono_dial != CDM_off) {
     if (config.second_hand || chrono_data.running || chrono_data.hold_ms != 0) {
-      draw_hand(&chrono_tenth_cache RESOURCE_CACHE_PARAMS(NULL, 0), &chrono_tenth_hand_def, current_placement.chrono_tenth_hand_index, ctx);
+      draw_hand(&chrono_tenth_cache RESOURCE_CACHE_PARAMS(false), &chrono_tenth_hand_def, current_placement.chrono_tenth_hand_index, ctx);
     }
   }
 
@@ -1085,12 +1766,12 @@ void draw_phase_1_hands(GContext *ctx) {
   // but we want to look like a chonograph, so draw the minute and
   // tenth hands at 0.
   if (config.second_hand) {
-    draw_hand(&chrono_minute_cache RESOURCE_CACHE_PARAMS(NULL, 0), &chrono_minute_hand_def, 0, ctx);
+    draw_hand(&chrono_minute_cache RESOURCE_CACHE_PARAMS(false), &chrono_minute_hand_def, 0, ctx);
   }
 
   if (config.chrono_dial != CDM_off) {
     if (config.second_hand) {
-      draw_hand(&chrono_tenth_cache RESOURCE_CACHE_PARAMS(NULL, 0), &chrono_tenth_hand_def, 0, ctx);
+      draw_hand(&chrono_tenth_cache RESOURCE_CACHE_PARAMS(false), &chrono_tenth_hand_def, 0, ctx);
     }
   }
 
@@ -1106,11 +1787,11 @@ void draw_phase_1_hands(GContext *ctx) {
   // their hands are relatively thin, and their hand masks define an
   // invisible halo that erases to the background color around the
   // hands, but we don't want the hands to erase each other.
-  draw_hand_mask(&hour_cache RESOURCE_CACHE_PARAMS(NULL, 0), &hour_hand_def, current_placement.hour_hand_index, false, ctx);
-  draw_hand_mask(&minute_cache RESOURCE_CACHE_PARAMS(NULL, 0), &minute_hand_def, current_placement.minute_hand_index, false, ctx);
+  draw_hand_mask(&hour_cache RESOURCE_CACHE_PARAMS(false), &hour_hand_def, current_placement.hour_hand_index, false, ctx);
+  draw_hand_mask(&minute_cache RESOURCE_CACHE_PARAMS(false), &minute_hand_def, current_placement.minute_hand_index, false, ctx);
 
-  draw_hand_fg(&hour_cache RESOURCE_CACHE_PARAMS(NULL, 0), &hour_hand_def, current_placement.hour_hand_index, false, ctx);
-  draw_hand_fg(&minute_cache RESOURCE_CACHE_PARAMS(NULL, 0), &minute_hand_def, current_placement.minute_hand_index, false, ctx);
+  draw_hand_fg(&hour_cache RESOURCE_CACHE_PARAMS(false), &hour_hand_def, current_placement.hour_hand_index, false, ctx);
+  draw_hand_fg(&minute_cache RESOURCE_CACHE_PARAMS(false), &minute_hand_def, current_placement.minute_hand_index, false, ctx);
 
 #else  //  HOUR_MINUTE_OVERLAP
 
@@ -1119,60 +1800,129 @@ void draw_phase_1_hands(GContext *ctx) {
   // with complex interiors that must be erased; and their haloes (if
   // present) are comparatively thinner and don't threaten to erase
   // overlapping hands.
-  draw_hand(&hour_cache RESOURCE_CACHE_PARAMS(NULL, 0), &hour_hand_def, current_placement.hour_hand_index, ctx);
+  draw_hand(&hour_cache RESOURCE_CACHE_PARAMS(false), &hour_hand_def, current_placement.hour_hand_index, ctx);
 
-  draw_hand(&minute_cache RESOURCE_CACHE_PARAMS(NULL, 0), &minute_hand_def, current_placement.minute_hand_index, ctx);
+  draw_hand(&minute_cache RESOURCE_CACHE_PARAMS(false), &minute_hand_def, current_placement.minute_hand_index, ctx);
 #endif  //  HOUR_MINUTE_OVERLAP
 
 #endif  // MAKE_CHRONOGRAPH
+
+  TIMER_STOP(TP_phase_1_hands, start_ms);
 }
 
 // Draws the second hand or any other hands which must be redrawn once
 // per second.  These are the hands that are never cached.
 void draw_phase_2_hands(GContext *ctx) {
+  TIMER_START(start_ms);
+
 #ifdef MAKE_CHRONOGRAPH
 
   // The Chrono case.  Lots of hands end up here because it's the
   // second hand and everything that might overlay it.
   if (config.second_hand) {
-    draw_hand(&second_cache RESOURCE_CACHE_PARAMS(second_resource_cache, second_resource_cache_size), &second_hand_def, current_placement.second_hand_index, ctx);
+    draw_hand(&second_cache RESOURCE_CACHE_PARAMS(true), get_second_hand_def(), current_placement.second_hand_index, ctx);
   }
 
-  draw_hand(&hour_cache RESOURCE_CACHE_PARAMS(NULL, 0), &hour_hand_def, current_placement.hour_hand_index, ctx);
+  draw_hand(&hour_cache RESOURCE_CACHE_PARAMS(false), &hour_hand_def, current_placement.hour_hand_index, ctx);
 
-  draw_hand(&minute_cache RESOURCE_CACHE_PARAMS(NULL, 0), &minute_hand_def, current_placement.minute_hand_index, ctx);
+  draw_hand(&minute_cache RESOURCE_CACHE_PARAMS(false), &minute_hand_def, current_placement.minute_hand_index, ctx);
 
   if (config.second_hand || chrono_data.running || chrono_data.hold_ms != 0) {
-    draw_hand(&chrono_second_cache RESOURCE_CACHE_PARAMS(chrono_second_resource_cache, chrono_second_resource_cache_size), &chrono_second_hand_def, current_placement.chrono_second_hand_index, ctx);
+    draw_hand(&chrono_second_cache RESOURCE_CACHE_PARAMS(true), &chrono_second_hand_def, current_placement.chrono_second_hand_index, ctx);
   }
 
 #elif defined(ENABLE_CHRONO_DIAL)
   // In this case, we're not implementing full chrono functionality,
   // but we still have to deal with that little second hand.
   if (config.second_hand) {
-    draw_hand(&second_cache RESOURCE_CACHE_PARAMS(second_resource_cache, second_resource_cache_size), &second_hand_def, current_placement.second_hand_index, ctx);
+    draw_hand(&second_cache RESOURCE_CACHE_PARAMS(true), get_second_hand_def(), current_placement.second_hand_index, ctx);
   }
 
-  draw_hand(&hour_cache RESOURCE_CACHE_PARAMS(NULL, 0), &hour_hand_def, current_placement.hour_hand_index, ctx);
+  draw_hand(&hour_cache RESOURCE_CACHE_PARAMS(false), &hour_hand_def, current_placement.hour_hand_index, ctx);
 
-  draw_hand(&minute_cache RESOURCE_CACHE_PARAMS(NULL, 0), &minute_hand_def, current_placement.minute_hand_index, ctx);
+  draw_hand(&minute_cache RESOURCE_CACHE_PARAMS(false), &minute_hand_def, current_placement.minute_hand_index, ctx);
 
 #else  // MAKE_CHRONOGRAPH
   // The normal, non-chrono implementation; and here in phase 2 we
   // only need to draw the second hand.
 
   if (config.second_hand) {
-    draw_hand(&second_cache RESOURCE_CACHE_PARAMS(second_resource_cache, second_resource_cache_size), &second_hand_def, current_placement.second_hand_index, ctx);
+    draw_hand(&second_cache RESOURCE_CACHE_PARAMS(true), get_second_hand_def(), current_placement.second_hand_index, ctx);
   }
 
 #endif  // MAKE_CHRONOGRAPH
+
+  TIMER_STOP(TP_phase_2_hands, start_ms);
+}
+
+// Moves the second hand to the indicated tier, releasing whatever it
+// no longer needs.
+static void set_second_hand_tier(enum SecondHandTier tier) {
+  qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "second_hand_tier %d -> %d", second_hand_tier, tier);
+  second_hand_tier = tier;
+  second_hand_restore_checks = 0;
+  hand_cache_destroy(&second_cache);
+  invalidate_clock_face();
+}
+
+// Returns the bytes of heap taken by the largest bitmap of the hand
+// and its mask.
+static size_t get_hand_bitmap_bytes(struct HandDef *hand_def) {
+#ifdef PBL_BW
+  size_t bytes = (size_t)((hand_def->max_w + 31) / 32 * 4) * hand_def->max_h;
+#else  // PBL_BW
+  size_t bytes = (size_t)hand_def->max_w * hand_def->max_h;
+#endif  // PBL_BW
+  return bytes * 2;
+}
+
+// Called from check_memory_usage().  If the second hand has been
+// reduced or stopped to save memory, and there has lately been room
+// enough to bring it back up a tier, do so.  Another panic will step
+// it back down.
+static void check_second_hand_tier() {
+  if (second_hand_tier == SHT_full) {
+    return;
+  }
+
+  // As in check_min_bytes_free(), we insist on the room being
+  // contiguous, though here we don't evict anything to find it.
+  char *buffer = malloc(get_hand_bitmap_bytes(&second_hand_def) + SECOND_HAND_RESTORE_MIN_BYTES_FREE);
+  if (buffer == NULL) {
+    second_hand_restore_checks = 0;
+    return;
+  }
+  free(buffer);
+  if (++second_hand_restore_checks < second_hand_restore_wait) {
+    return;
+  }
+
+  // Move the panic count back to just below the second hand's rung
+  // in reset_memory_panic(), so that the next panic steps the second
+  // hand down again, rather than giving up whatever follows it.
+  if (memory_panic_count > 3) {
+    memory_panic_count = 3;
+  }
+  second_hand_restored = true;
+
+  if (second_hand_tier == SHT_off) {
+    config.second_hand = true;
+    set_second_hand_tier(SHT_reduced);
+    reset_tick_timer();
+  } else {
+    set_second_hand_tier(SHT_full);
+  }
 }
 
 // Triggers a memory panic if at least MIN_BYTES_FREE are not available.
 void check_min_bytes_free() {
   // We insist on checking for contiguous bytes free, which we do by
-  // attempting to allocate a buffer of MIN_BYTES_FREE.
+  // attempting to allocate a buffer of MIN_BYTES_FREE, evicting assets
+  // until it fits if need be.
   char *buffer = malloc(MIN_BYTES_FREE);
+  while (buffer == NULL && asset_evict_one()) {
+    buffer = malloc(MIN_BYTES_FREE);
+  }
   if (buffer != NULL) {
     // It's available, great!
     free(buffer);
@@ -1194,6 +1944,8 @@ void check_memory_usage() {
     reset_memory_panic();
     check_min_bytes_free();
   }
+
+  check_second_hand_tier();
 }
 
 #if !defined(PBL_PLATFORM_APLITE) && PBL_API_EXISTS(layer_get_unobstructed_bounds)
@@ -1211,13 +1963,157 @@ void root_layer_update_callback(Layer *me, GContext *ctx) {
 }
 #endif  // PBL_API_EXISTS(layer_get_unobstructed_bounds)
 
+// The kinds of frame clock_face_layer_update_callback() and
+// second_hand_layer_update_callback() draw.  This is recorded as the
+// detail of each TP_frame timing (see timing.h).
+enum FrameKind {
+  FK_draw_face,           // drew the clock face from its assets
+  FK_clock_face,          // restored clock_face, drew all the hands
+  FK_hands_face,          // restored hands_face, drew the phase 2 hands
+  FK_partial_clock_face,  // as FK_clock_face, in second_hand_layer
+  FK_partial_hands_face,  // as FK_hands_face, in second_hand_layer
+  FK_num_kinds,
+};
+
+
+// Draws the parts of the frame that go on top of the rendered clock
+// face: the dynamic text of the date windows, and the hands.  The
+// phase 1 hands are omitted if the face was restored from hands_face
+// (or they have already been drawn).
+static void draw_clock_face_overlay(GContext *ctx, bool with_phase_1) {
+  if (date_window_dynamic) {
+    // Now fill in the per-frame dynamic text, if needed.
+    for (int i = 0; i < NUM_DATE_WINDOWS; ++i) {
+      draw_date_window_dynamic_text(ctx, i);
+    }
+  }
+
+  if (with_phase_1) {
+    draw_phase_1_hands(ctx);
+  }
+
+  // And we always draw the phase_2 hands last, each update.  These
+  // are the most dynamic hands that are never part of the captured
+  // framebuffer.
+  draw_phase_2_hands(ctx);
+}
+
+// Restores the frame buffer from a saved render of the whole screen,
+// clock_face or hands_face.
+static void draw_saved_face(Layer *me, GContext *ctx, BitmapWithData *saved) {
+  asset_touch(saved);
+  GRect destination = layer_get_frame(me);
+  destination.origin.x = -destination.origin.x;
+  destination.origin.y = -destination.origin.y;
+  graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+  graphics_draw_bitmap_in_rect(ctx, saved->bitmap, destination);
+}
+
+// Returns true if the phase 1 hands should be cached in hands_face:
+// if the frame is redrawn more often than they move, and nothing
+// beneath them (like the dynamic date window text) changes each frame.
+static bool want_hands_face() {
+  if (!keep_hands_face || !save_framebuffer || date_window_dynamic) {
+    return false;
+  }
+#ifdef MAKE_CHRONOGRAPH
+  if (chrono_data.running) {
+    return true;
+  }
+#endif  // MAKE_CHRONOGRAPH
+  return config.second_hand;
+}
+
+// Returns the number of bytes the resource cache and the rle cache
+// may still grow by before they reach their budgets.
+static size_t get_cache_headroom() {
+  size_t headroom = 0;
+#ifdef SUPPORT_RESOURCE_CACHE
+  if (resource_cache_bytes < RESOURCE_CACHE_BUDGET) {
+    headroom += RESOURCE_CACHE_BUDGET - resource_cache_bytes;
+  }
+#endif  // SUPPORT_RESOURCE_CACHE
+#ifdef SUPPORT_RLE_CACHE
+  if (rle_cache_bytes < RLE_CACHE_BUDGET) {
+    headroom += RLE_CACHE_BUDGET - rle_cache_bytes;
+  }
+#endif  // SUPPORT_RLE_CACHE
+  return headroom;
+}
+
+// Saves the frame buffer, which now holds the clock face with the
+// phase 1 hands drawn over it, into hands_face.  This cache is only
+// an optimization, so if we can't spare the memory for it we do
+// without, rather than triggering a memory panic.
+static void save_hands_face(GContext *ctx) {
+  GBitmap *fb = graphics_capture_frame_buffer(ctx);
+  if (hands_face.bitmap != NULL) {
+    // Reuse the memory from the last time.
+    bwd_copy_into_from_bitmap(&hands_face, fb);
+  } else {
+    hands_face = bwd_copy_bitmap(fb);
+    asset_touch(&hands_face);
+    if (hands_face.bitmap != NULL && heap_bytes_free() < HANDS_FACE_MIN_BYTES_FREE + get_cache_headroom()) {
+      // That would leave too little for everything else.
+      bwd_destroy(&hands_face);
+    }
+    if (hands_face.bitmap == NULL) {
+      qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "no room for hands_face, heap_bytes_free = %d", heap_bytes_free());
+      keep_hands_face = false;
+    }
+  }
+  graphics_release_frame_buffer(ctx, fb);
+  redraw_hands_face = (hands_face.bitmap == NULL);
+}
+
+// Releases hands_face to make room for something else (see
+// asset_evict_one()).  It will be saved again on a later frame if
+// want_hands_face() still asks for it and save_hands_face() finds
+// room for it then.
+void release_hands_face() {
+  bwd_destroy(&hands_face);
+  redraw_hands_face = true;
+}
+
+// Saves a copy of the frame buffer in clock_face, evicting other
+// assets to make room if need be.  The copy is pinned for the rest of
+// the frame; if the hands then can't find room too, it's better to
+// panic (and let reset_memory_panic() choose) than to throw away the
+// copy we just made.
+static void save_clock_face(GBitmap *fb) {
+  clock_face = bwd_copy_bitmap(fb);
+  while (clock_face.bitmap == NULL && asset_evict_one()) {
+    clock_face = bwd_copy_bitmap(fb);
+  }
+  if (clock_face.bitmap == NULL) {
+    trigger_memory_panic(__LINE__);
+  }
+  asset_pin(&clock_face);
+}
+
 void clock_face_layer_update_callback(Layer *me, GContext *ctx) {
+  TIMER_START(frame_start_ms);
+
   // Make sure we have reset our memory usage before we start to draw.
   check_memory_usage();
 
+  // If only the second hand has moved, leave the frame buffer as it
+  // is, and let second_hand_layer redraw the part that changed.
+  partial_redraw_now = (partial_redraw && frame_intact && clock_face.bitmap != NULL);
+  partial_redraw = false;
+  if (partial_redraw_now) {
+    return;
+  }
+  frame_intact = false;
+  asset_frame_begin();
+  prepare_date_fonts();
+
   do {
     qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "clock_face_layer, memory_panic_count = %d, heap_bytes_free = %d", memory_panic_count, heap_bytes_free());
 
+    enum FrameKind frame_kind = FK_clock_face;
+    bool phase_1_drawn = false;
+
     // In case we're in extreme memory panic mode--too little
     // available memory to even keep the clock face resident--we don't
     // draw any clock background.
@@ -1226,22 +2122,15 @@ void clock_face_layer_update_callback(Layer *me, GContext *ctx) {
       if (clock_face.bitmap == NULL || redraw_clock_face) {
         // The clock face needs to be redrawn (or drawn for the first
         // time).  This is every part of the display except for the
-        // hands, including the date windows and top subdial.  If the
-        // second hand is enabled, it also includes the hour and minute
-        // hands.
+        // hands, including the date windows and top subdial.
+        frame_kind = FK_draw_face;
         bwd_destroy(&clock_face);
         redraw_clock_face = false;
+        redraw_hands_face = true;
 
         // Draw the clock face into the frame buffer.
         draw_clock_face(me, ctx);
 
-        if (SEPARATE_PHASE_HANDS) {
-          // If the second hand is enabled, then we also draw the
-          // phase_1 hands at this time, so they get cached in the clock
-          // face buffer.
-          draw_phase_1_hands(ctx);
-        }
-
         if (save_framebuffer) {
           // Now save the render for next time.
           GBitmap *fb = graphics_capture_frame_buffer(ctx);
@@ -1257,75 +2146,160 @@ void clock_face_layer_update_callback(Layer *me, GContext *ctx) {
             // the *same* memory for framebuffer that we had already
             // allocated for face_bitmap, because they will be the
             // same bitmap format and size.
-            clock_face = face_bitmap;
-            face_bitmap.bitmap = NULL;
-            bwd_copy_into_from_bitmap(&clock_face, fb);
+            if (face_bitmap.bitmap != NULL) {
+              clock_face = face_bitmap;
+              face_bitmap.bitmap = NULL;
+              bwd_copy_into_from_bitmap(&clock_face, fb);
+            } else {
+              // The face was decoded straight into the frame buffer,
+              // so there's nothing to reuse.
+              save_clock_face(fb);
+            }
 
 #else  //  PBL_BW
             // On other platforms, they are likely to have a different
             // format (the clock face will be 4-bit palette), so we have
             // to deallocate and reallocate.
             bwd_destroy(&face_bitmap);
-            clock_face = bwd_copy_bitmap(fb);
-            if (clock_face.bitmap == NULL) {
-              trigger_memory_panic(__LINE__);
-            }
+            save_clock_face(fb);
 #endif  //  PBL_BW
           } else {
             // If we're confident we can keep both the face_bitmap and
             // clock_face around together, do so.
-            clock_face = bwd_copy_bitmap(fb);
-            if (clock_face.bitmap == NULL) {
-              trigger_memory_panic(__LINE__);
-            }
+            save_clock_face(fb);
           }
 
           graphics_release_frame_buffer(ctx, fb);
         }
 
+      } else if (hands_face.bitmap != NULL && !redraw_hands_face) {
+        // The clock face and the phase 1 hands are already saved
+        // from a previous update; redraw them now.
+        frame_kind = FK_hands_face;
+        draw_saved_face(me, ctx, &hands_face);
+        phase_1_drawn = true;
+
       } else {
         // The rendered clock face is already saved from a previous
         // update; redraw it now.
-        GRect destination = layer_get_frame(me);
-        destination.origin.x = -destination.origin.x;
-        destination.origin.y = -destination.origin.y;
-        graphics_context_set_compositing_mode(ctx, GCompOpAssign);
-        graphics_draw_bitmap_in_rect(ctx, clock_face.bitmap, destination);
+        draw_saved_face(me, ctx, &clock_face);
       }
-    }
 
-    if (date_window_dynamic) {
-      // Now fill in the per-frame dynamic text, if needed.
-      for (int i = 0; i < NUM_DATE_WINDOWS; ++i) {
-        draw_date_window_dynamic_text(ctx, i);
+      if (!phase_1_drawn && clock_face.bitmap != NULL && want_hands_face()) {
+        // Draw the phase 1 hands now, and save the result in
+        // hands_face for the frames to come.
+        draw_phase_1_hands(ctx);
+        phase_1_drawn = true;
+        if (!memory_panic_flag) {
+          save_hands_face(ctx);
+        }
       }
+    } else {
+      // The window doesn't clear itself (see second_hand_layer), so
+      // clear the layer to white, as the window would have.
+      graphics_context_set_fill_color(ctx, GColorWhite);
+      graphics_fill_rect(ctx, layer_get_bounds(me), 0, GCornerNone);
     }
 
-    if (!SEPARATE_PHASE_HANDS || hide_clock_face) {
-      // If the second hand is *not* enabled, then we draw the phase_1
-      // hands at this time, so we don't have to invalidate the buffer
-      // each minute.
-      draw_phase_1_hands(ctx);
-    }
-
-    // And we always draw the phase_2 hands last, each update.  These
-    // are the most dynamic hands that are never part of the captured
-    // framebuffer.
-    draw_phase_2_hands(ctx);
+    draw_clock_face_overlay(ctx, !phase_1_drawn);
 
     if (!memory_panic_flag) {
       // If we successfully drew the clock face without memory
-      // panicking, return.
+      // panicking, return.  The next frame can redraw just the second
+      // hand, if we have the face to restore it from.
+      frame_intact = (!hide_clock_face && clock_face.bitmap != NULL);
+      drew_from_hands_face = (frame_kind == FK_hands_face);
+      asset_frame_end();
+      panic_evictions = 0;
       check_memory_usage();
+      TIMER_STOP_DETAIL(TP_frame, frame_kind, frame_start_ms);
+      timing_launch_stop();
       return;
     }
 
     // In this case we hit a memory_panic_flag while drawing.  Reset
     // and try again.
+    asset_frame_end();
     reset_memory_panic();
+    asset_frame_begin();
   } while (true);
 }
 
+// Redraws the part of the face that the second hand has swept since
+// the last frame, when clock_face_layer_update_callback() has left
+// the rest of the frame buffer alone.  The layer's bounds are offset
+// so that we draw in the coordinates of clock_face_layer, and the
+// system clips everything we draw to the layer's frame.
+void second_hand_layer_update_callback(Layer *me, GContext *ctx) {
+  if (!partial_redraw_now) {
+    return;
+  }
+  partial_redraw_now = false;
+  TIMER_START(frame_start_ms);
+  asset_frame_begin();
+
+  // Restore the face beneath the hands from the saved render.
+  bool from_hands_face = (hands_face.bitmap != NULL && !redraw_hands_face);
+  draw_saved_face(clock_face_layer, ctx, from_hands_face ? &hands_face : &clock_face);
+  draw_clock_face_overlay(ctx, !from_hands_face);
+  drew_from_hands_face = from_hands_face;
+  asset_frame_end();
+
+  if (memory_panic_flag) {
+    // Something didn't get drawn; start over with a complete frame.
+    reset_memory_panic();
+    mark_clock_face_dirty();
+  }
+  check_memory_usage();
+  TIMER_STOP_DETAIL(TP_frame, from_hands_face ? FK_partial_hands_face : FK_partial_clock_face, frame_start_ms);
+}
+
+// Requests a complete redraw of clock_face_layer next frame.
+void mark_clock_face_dirty() {
+  partial_redraw = false;
+  frame_intact = false;
+  if (clock_face_layer != NULL) {
+    layer_mark_dirty(clock_face_layer);
+  }
+}
+
+// Requests a redraw of the part of the face covered by the second
+// hand at old_index and at new_index (and by any dynamic date window
+// text, which is redrawn every frame), if the frame buffer still
+// holds the rest of the face; or a complete redraw otherwise.  While
+// part of the screen is obstructed, root_layer fills the whole window
+// on every redraw, so the frame buffer never holds the face then.
+static void mark_second_hand_dirty(int old_index, int new_index) {
+  if (!frame_intact || !config.second_hand || second_hand_layer == NULL ||
+      any_obstructed_area) {
+    mark_clock_face_dirty();
+    return;
+  }
+
+  struct HandDef *hand_def = get_second_hand_def();
+  GRect box = union_boxes(get_hand_box(hand_def, old_index),
+                          get_hand_box(hand_def, new_index));
+  if (date_window_dynamic) {
+    int indicator_face_index = get_indicator_face_index();
+    for (int i = 0; i < NUM_DATE_WINDOWS; ++i) {
+      const struct IndicatorTable *window = &date_windows[i][indicator_face_index];
+      box = union_boxes(box, GRect(window->x, window->y, DATE_WINDOW_SIZE_X, DATE_WINDOW_SIZE_Y));
+    }
+  }
+  if (partial_redraw) {
+    // Another second-hand move is still waiting to be drawn.
+    box = union_boxes(box, partial_redraw_box);
+  }
+  GRect bounds = layer_get_bounds(clock_face_layer);
+  grect_clip(&box, &bounds);
+
+  partial_redraw = true;
+  partial_redraw_box = box;
+  layer_set_frame(second_hand_layer, box);
+  layer_set_bounds(second_hand_layer, GRect(-box.origin.x, -box.origin.y, bounds.size.w, bounds.size.h));
+  layer_mark_dirty(second_hand_layer);
+}
+
 // Draws the frame and optionally fills the background of the current date window.
 void draw_date_window_background(GContext *ctx, int date_window_index, unsigned int fg_draw_mode, unsigned int bg_draw_mode) {
   int indicator_face_index = get_indicator_face_index();
@@ -1334,31 +2308,20 @@ void draw_date_window_background(GContext *ctx, int date_window_index, unsigned
 
 #ifdef PBL_BW
   // We only need the mask on B&W watches.
-  if (date_window_mask.bitmap == NULL) {
-    date_window_mask = rle_bwd_create(RESOURCE_ID_DATE_WINDOW_MASK);
-    if (date_window_mask.bitmap == NULL) {
-      trigger_memory_panic(__LINE__);
-      return;
-    }
+  if (!draw_asset(ctx, &date_window_mask, RESOURCE_ID_DATE_WINDOW_MASK, box,
+                  draw_mode_table[bg_draw_mode].paint_bg, NULL, keep_assets)) {
+    trigger_memory_panic(__LINE__);
+    return;
   }
-  graphics_context_set_compositing_mode(ctx, draw_mode_table[bg_draw_mode].paint_bg);
-  graphics_draw_bitmap_in_rect(ctx, date_window_mask.bitmap, box);
 #endif  // PBL_BW
 
-  if (date_window.bitmap == NULL) {
-    date_window = rle_bwd_create(RESOURCE_ID_DATE_WINDOW);
-    if (date_window.bitmap == NULL) {
-      bwd_destroy(&date_window_mask);
-      trigger_memory_panic(__LINE__);
-      return;
-    }
-#ifndef PBL_BW
-    remap_colors_date(&date_window);
-#endif  // PBL_BW
+  BwdRemap remap;
+  if (!draw_asset(ctx, &date_window, RESOURCE_ID_DATE_WINDOW, box,
+                  draw_mode_table[fg_draw_mode].paint_fg, get_remap_date(&remap), keep_assets)) {
+    bwd_destroy(&date_window_mask);
+    trigger_memory_panic(__LINE__);
+    return;
   }
-
-  graphics_context_set_compositing_mode(ctx, draw_mode_table[fg_draw_mode].paint_fg);
-  graphics_draw_bitmap_in_rect(ctx, date_window.bitmap, box);
 }
 
 // Draws a date window with the specified text contents.  Usually this is
@@ -1396,25 +2359,103 @@ void draw_date_window_text(GContext *ctx, int date_window_index, const char *tex
   box.size.w += 8;
   box.size.h += 4;
 
-  graphics_draw_text(ctx, text, font, box,
-                     GTextOverflowModeTrailingEllipsis, GTextAlignmentCenter,
-                     NULL);
+  graphics_draw_text(ctx, text, font, box,
+                     GTextOverflowModeTrailingEllipsis, GTextAlignmentCenter,
+                     NULL);
+}
+
+void format_date_number(char buffer[DATE_WINDOW_BUFFER_SIZE], int value) {
+  snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d", value);
+}
+
+#ifndef PBL_PLATFORM_APLITE
+// Returns the current value of the health metric shown by the
+// indicated date window mode, in the units it is displayed in.
+static int get_health_value(DateWindowMode dwm) {
+  switch (dwm) {
+  case DWM_step_count:
+    return (int)health_service_sum_today(HealthMetricStepCount);
+
+  case DWM_step_count_10:
+    return (int)health_service_sum_today(HealthMetricStepCount) / 10;
+
+  case DWM_active_time:
+    return (int)health_service_sum_today(HealthMetricActiveSeconds) / 60;
+
+  case DWM_sleep_time:
+    return (int)health_service_sum_today(HealthMetricSleepSeconds) / 60;
+
+  case DWM_sleep_restful_time:
+    return (int)health_service_sum_today(HealthMetricSleepRestfulSeconds) / 60;
+
+  case DWM_walked_distance:
+    {
+      int meters = (int)health_service_sum_today(HealthMetricWalkedDistanceMeters);
+      switch (health_service_get_measurement_system_for_display(HealthMetricWalkedDistanceMeters)) {
+      case MeasurementSystemImperial:
+        return ((meters * 1000 + 80467) / 160934);  // 0.1 miles
+
+      case MeasurementSystemMetric:
+      default:
+        return (meters + 50) / 100;  // "hectometers", 0.1 kilometers
+      }
+    }
+
+  case DWM_calories_burned:
+    return (int)(health_service_sum_today(HealthMetricRestingKCalories) + health_service_sum_today(HealthMetricActiveKCalories));
+
+#ifdef SUPPORT_HEART_RATE
+  case DWM_heart_rate:
+    return (int)health_service_peek_current_value(HealthMetricHeartRateBPM);
+#endif  // SUPPORT_HEART_RATE
+
+  default:
+    return 0;
+  }
 }
 
-void format_date_number(char buffer[DATE_WINDOW_BUFFER_SIZE], int value) {
-  snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d", value);
+// Returns the value shown by the indicated date window mode, from
+// *cached_value if it is there, or else fetching it into
+// *cached_value.  It stays cached until health_event_handler() finds
+// it has changed.
+static int get_cached_health_value(int *cached_value, DateWindowMode dwm) {
+  if (*cached_value < 0) {
+    *cached_value = get_health_value(dwm);
+  }
+  return *cached_value;
 }
 
-#ifndef PBL_PLATFORM_APLITE
-void format_health_metric_count_today(char buffer[DATE_WINDOW_BUFFER_SIZE], HealthMetric metric, int *cached_value, int scale_factor) {
-  int value;
-  if (*cached_value >= 0) {
-    value = *cached_value;
-  } else {
-    value = (int)health_service_sum_today(metric) / scale_factor;
-    *cached_value = value;
+// Called when a health event says the value shown by the indicated
+// date window mode may have changed.  If the value in *cached_value
+// was drawn into the clock face and is now different, updates it and
+// returns true.
+static bool refresh_cached_health_value(int *cached_value, DateWindowMode dwm) {
+  if (*cached_value < 0) {
+    // Not drawn.
+    return false;
+  }
+  int value = get_health_value(dwm);
+  if (value == *cached_value) {
+    return false;
   }
+  *cached_value = value;
+  return true;
+}
+
+// Forgets the health values drawn so far, when the date windows are
+// to show something else.
+static void clear_cached_health_values() {
+  cached_sleep_time = -1;
+  cached_sleep_restful_time = -1;
+  cached_step_count = -1;
+  cached_step_count_10 = -1;
+  cached_active_time = -1;
+  cached_walked_distance = -1;
+  cached_calories_burned = -1;
+  cached_heart_rate = -1;
+}
 
+void format_health_count(char buffer[DATE_WINDOW_BUFFER_SIZE], int value) {
   // Show only the bottom four digits.
   if (value < 10000) {
     snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d", value);
@@ -1423,74 +2464,17 @@ void format_health_metric_count_today(char buffer[DATE_WINDOW_BUFFER_SIZE], Heal
   }
 }
 
-void format_health_metric_calories_today(char buffer[DATE_WINDOW_BUFFER_SIZE], int *cached_value) {
-  int value;
-  if (*cached_value >= 0) {
-    value = *cached_value;
-  } else {
-    value = (int)(health_service_sum_today(HealthMetricRestingKCalories) + health_service_sum_today(HealthMetricActiveKCalories));
-    *cached_value = value;
-  }
-  snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d", value);
-}
-
-void format_health_metric_time_today(char buffer[DATE_WINDOW_BUFFER_SIZE], HealthMetric metric, int *cached_value) {
-  int value;
-  if (*cached_value >= 0) {
-    value = *cached_value;
-  } else {
-    value = (int)health_service_sum_today(metric);
-    *cached_value = value;
-  }
-  int minutes = value / 60;
+void format_health_time(char buffer[DATE_WINDOW_BUFFER_SIZE], int minutes) {
   int hours = minutes / 60;
-
   snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d:%02d", hours, minutes % 60);
 }
 
-void format_health_metric_distance_today(char buffer[DATE_WINDOW_BUFFER_SIZE], HealthMetric metric, int *cached_value) {
-  int value;
-  if (*cached_value >= 0) {
-    value = *cached_value;
-  } else {
-    int meters = (int)health_service_sum_today(metric);
-    switch (health_service_get_measurement_system_for_display(metric)) {
-    case MeasurementSystemImperial:
-      {
-        value = ((meters * 1000 + 80467) / 160934);  // 0.1 miles
-      }
-      break;
-
-    case MeasurementSystemMetric:
-    default:
-      {
-        value = (meters + 50) / 100;  // "hectometers", 0.1 kilometers
-      }
-      break;
-    }
-    *cached_value = value;
-  }
-
+void format_health_distance(char buffer[DATE_WINDOW_BUFFER_SIZE], int value) {
   snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d.%01d", value / 10, value % 10);
 }
 
 #endif  // PBL_PLATFORM_APLITE
 
-#ifdef SUPPORT_HEART_RATE
-
-void format_health_metric_count_peek(char buffer[DATE_WINDOW_BUFFER_SIZE], HealthMetric metric, int *cached_value) {
-  int value;
-  if (*cached_value >= 0) {
-    value = *cached_value;
-  } else {
-    value = (int)health_service_peek_current_value(metric);
-    *cached_value = value;
-  }
-  snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d", value);
-}
-
-#endif  // SUPPORT_HEART_RATE
-
 // yday is the current ordinal date [0..365], wday is the current day
 // of the week [0..6], 0 = Sunday.  year is the current year less 1900.
 
@@ -1568,6 +2552,13 @@ void draw_full_date_window(GContext *ctx, int date_window_index) {
   // Format the date or weekday or whatever text for display.
   char buffer[DATE_WINDOW_BUFFER_SIZE];
 
+  if (date_lang_font == NULL) {
+    // The fonts were evicted to make room for something else, or
+    // the window was switched on mid-frame.
+    load_date_fonts();
+  }
+  asset_touch(&date_lang_font);
+
   GFont font = date_numeric_font;
   struct FontPlacement *font_placement = &date_lang_font_placement[0];
   if (dwm >= DWM_weekday && dwm <= DWM_ampm) {
@@ -1616,6 +2607,13 @@ void draw_full_date_window(GContext *ctx, int date_window_index) {
   case DWM_debug_memory_panic_count:
   case DWM_debug_resource_reads:
   case DWM_debug_draw_face_count:
+  case DWM_debug_resource_load_calls:
+  case DWM_debug_resource_load_bytes:
+  case DWM_debug_resource_load_bytes_reread:
+  case DWM_debug_rle_cache_hit_rate:
+  case DWM_debug_last_frame_ms:
+  case DWM_debug_max_frame_ms:
+  case DWM_debug_decode_ms:
     // We have some dynamic text that will need a separate pass to
     // re-render each frame.
     date_window_dynamic = true;
@@ -1634,28 +2632,44 @@ void draw_full_date_window(GContext *ctx, int date_window_index) {
     break;
 
 #ifndef PBL_PLATFORM_APLITE
+    // The health metrics change only when health_event_handler() is
+    // told so, and it invalidates the clock face then; so they are
+    // drawn into the clock face along with everything else, rather
+    // than redrawn every frame.
   case DWM_step_count:
+    format_health_count(buffer, get_cached_health_value(&cached_step_count, dwm));
+    break;
+
   case DWM_step_count_10:
+    format_health_count(buffer, get_cached_health_value(&cached_step_count_10, dwm));
+    break;
+
   case DWM_active_time:
+    format_health_time(buffer, get_cached_health_value(&cached_active_time, dwm));
+    break;
+
   case DWM_walked_distance:
+    format_health_distance(buffer, get_cached_health_value(&cached_walked_distance, dwm));
+    break;
+
   case DWM_calories_burned:
-    date_window_dynamic = true;
-    return;
+    snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d", get_cached_health_value(&cached_calories_burned, dwm));
+    break;
 
   case DWM_sleep_time:
-    format_health_metric_time_today(buffer, HealthMetricSleepSeconds, &cached_sleep_time);
+    format_health_time(buffer, get_cached_health_value(&cached_sleep_time, dwm));
     break;
 
   case DWM_sleep_restful_time:
-    format_health_metric_time_today(buffer, HealthMetricSleepRestfulSeconds, &cached_sleep_restful_time);
+    format_health_time(buffer, get_cached_health_value(&cached_sleep_restful_time, dwm));
     break;
 #endif  // PBL_PLATFORM_APLITE
 
-#ifdef PBL_PLATFORM_DIORITE
+#ifdef SUPPORT_HEART_RATE
   case DWM_heart_rate:
-    date_window_dynamic = true;
-    return;
-#endif  // PBL_PLATFORM_DIORITE
+    snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d", get_cached_health_value(&cached_heart_rate, dwm));
+    break;
+#endif  // SUPPORT_HEART_RATE
 
   case DWM_moon_unused:
   default:
@@ -1696,44 +2710,74 @@ void draw_date_window_dynamic_text(GContext *ctx, int date_window_index) {
     snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d", draw_face_count);
     break;
 
-#ifndef PBL_PLATFORM_APLITE
-  case DWM_step_count:
-    format_health_metric_count_today(buffer, HealthMetricStepCount, &cached_step_count, 1);
+  case DWM_debug_resource_load_calls:
+    snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d", bwd_load_calls);
     break;
 
-  case DWM_step_count_10:
-    format_health_metric_count_today(buffer, HealthMetricStepCount, &cached_step_count_10, 10);
+  case DWM_debug_resource_load_bytes:
+    snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%dk", bwd_load_bytes / 1024);
     break;
 
-  case DWM_active_time:
-    format_health_metric_time_today(buffer, HealthMetricActiveSeconds, &cached_active_time);
+  case DWM_debug_resource_load_bytes_reread:
+    snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d", bwd_load_bytes_reread);
     break;
 
-  case DWM_walked_distance:
-    format_health_metric_distance_today(buffer, HealthMetricWalkedDistanceMeters, &cached_walked_distance);
+  case DWM_debug_rle_cache_hit_rate:
+#ifdef SUPPORT_RLE_CACHE
+    snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%d%%", rle_cache_hits * 100 / (rle_cache_hits + rle_cache_misses + 1));
+#else  // SUPPORT_RLE_CACHE
+    snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "-");
+#endif  // SUPPORT_RLE_CACHE
     break;
 
-  case DWM_calories_burned:
-    format_health_metric_calories_today(buffer, &cached_calories_burned);
+    // The frame timings (see timing.h) are only measured in a debug
+    // build.
+#ifndef NDEBUG
+  case DWM_debug_last_frame_ms:
+    snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%u", timing_last_frame_ms);
     break;
-#endif  // PBL_PLATFORM_APLITE
 
-#ifdef SUPPORT_HEART_RATE
-  case DWM_heart_rate:
-    format_health_metric_count_peek(buffer, HealthMetricHeartRateBPM, &cached_heart_rate);
+  case DWM_debug_max_frame_ms:
+    snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%u", timing_max_frame_ms);
     break;
-#endif  // SUPPORT_HEART_RATE
+
+  case DWM_debug_decode_ms:
+    snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "%u", timing_frame_decode_ms);
+    break;
+#else  // NDEBUG
+  case DWM_debug_last_frame_ms:
+  case DWM_debug_max_frame_ms:
+  case DWM_debug_decode_ms:
+    snprintf(buffer, DATE_WINDOW_BUFFER_SIZE, "-");
+    break;
+#endif  // NDEBUG
 
   default:
     // Not a dynamic element.  Do nothing.
     return;
   }
 
+  if (date_lang_font == NULL) {
+    load_date_fonts();
+  }
+  asset_touch(&date_lang_font);
+
   GFont font = date_numeric_font;
   struct FontPlacement *font_placement = &date_lang_font_placement[0];
   draw_date_window_text(ctx, date_window_index, text, font_placement, font);
 }
 
+// Called when the hour or minute hand has moved.  These are phase 1
+// hands, cached in hands_face, except in the chronograph faces, which
+// draw them over the second hand.
+static void hour_minute_hand_moved() {
+#if defined(MAKE_CHRONOGRAPH) || defined(ENABLE_CHRONO_DIAL)
+  mark_clock_face_dirty();
+#else  // MAKE_CHRONOGRAPH
+  invalidate_hands_face();
+#endif  // MAKE_CHRONOGRAPH
+}
+
 // Called once per epoch (e.g. once per second, or once per minute) to
 // compute the new positions for all of the hands on the watch based
 // on the current time.  This does not actually draw the hands; it
@@ -1741,37 +2785,29 @@ void draw_date_window_dynamic_text(GContext *ctx, int date_window_index) {
 // the appropriate layers dirty, to eventually redraw the hands that
 // have moved since the last call.
 void update_hands(struct tm *time) {
-  (void)poll_quiet_time_state();
+  TIMER_START(start_ms);
   struct HandPlacement new_placement = current_placement;
 
   compute_hands(time, &new_placement);
+  if (new_placement.polled_minute != current_placement.polled_minute) {
+    current_placement.polled_minute = new_placement.polled_minute;
+    (void)poll_quiet_time_state();
+  }
+
   if (new_placement.hour_hand_index != current_placement.hour_hand_index) {
     current_placement.hour_hand_index = new_placement.hour_hand_index;
-    layer_mark_dirty(clock_face_layer);
-
-    if (SEPARATE_PHASE_HANDS) {
-      // If the hour and minute hands are baked into the clock face
-      // cache, it must be redrawn now.
-      qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "hour hand changed with SEPARATE_PHASE_HANDS");
-      invalidate_clock_face();
-    }
+    hour_minute_hand_moved();
   }
 
   if (new_placement.minute_hand_index != current_placement.minute_hand_index) {
     current_placement.minute_hand_index = new_placement.minute_hand_index;
-    layer_mark_dirty(clock_face_layer);
-
-    if (SEPARATE_PHASE_HANDS) {
-      // If the hour and minute hands are baked into the clock face
-      // cache, it must be redrawn now.
-      qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "minute hand changed with SEPARATE_PHASE_HANDS");
-      invalidate_clock_face();
-    }
+    hour_minute_hand_moved();
   }
 
   if (new_placement.second_hand_index != current_placement.second_hand_index) {
+    int old_index = current_placement.second_hand_index;
     current_placement.second_hand_index = new_placement.second_hand_index;
-    layer_mark_dirty(clock_face_layer);
+    mark_second_hand_dirty(old_index, new_placement.second_hand_index);
   }
 
   if (new_placement.buzzed_hour != current_placement.buzzed_hour) {
@@ -1784,15 +2820,6 @@ void update_hands(struct tm *time) {
     }
   }
 
-#if ENABLE_SWEEP_SECONDS
-  // Make sure the sweep timer is fast enough to capture the second
-  // hand.
-  sweep_timer_ms = 1000;
-  if (config.sweep_seconds) {
-    sweep_timer_ms = sweep_seconds_ms;
-  }
-#endif  // ENABLE_SWEEP_SECONDS
-
 #ifdef MAKE_CHRONOGRAPH
   update_chrono_hands(&new_placement);
 #endif  // MAKE_CHRONOGRAPH
@@ -1823,45 +2850,100 @@ void update_hands(struct tm *time) {
     invalidate_clock_face();
   }
 #endif  // TOP_SUBDIAL
+
+  TIMER_STOP(TP_update_hands, start_ms);
+}
+
+#ifdef SUPPORT_WAKE_TIMER
+// Returns the number of ms from ms until a hand that takes num_steps
+// steps each period_ms, counting from 0, moves on to its next step;
+// that is, until (num_steps * ms) / period_ms, as computed in
+// compute_hands(), next changes.
+unsigned int get_next_step_ms(unsigned int ms, unsigned int period_ms, unsigned int num_steps) {
+  unsigned int use_ms = ms % period_ms;
+  unsigned int index = (num_steps * use_ms) / period_ms;
+  unsigned int next_ms = ((index + 1) * period_ms + num_steps - 1) / num_steps;
+  return next_ms - use_ms;
+}
+
+// Triggered by reset_wake_timer() at the next step of whatever is
+// moving faster than the tick service.
+void handle_wake_timer(void *data) {
+  wake_timer = NULL;  // When the timer is handled, it is implicitly canceled.
+#ifdef MAKE_CHRONOGRAPH
+  update_chrono_current_time();
+#endif  // MAKE_CHRONOGRAPH
+  update_hands(NULL);
+  reset_wake_timer();
 }
 
+// Sets the wake_timer for the next time anything on the screen needs
+// to change before the next tick: the next step of the sweep-second
+// hand, or of the chronograph, if they are moving.  The time is
+// computed anew from the clock each time, so that the wakeups land
+// on the step boundaries instead of drifting.  If nothing needs to
+// change before the next tick, the wake_timer is not used.
+void reset_wake_timer() {
+  if (wake_timer != NULL) {
+    app_timer_cancel(wake_timer);
+    wake_timer = NULL;
+  }
+
+  time_t gmt;
+  uint16_t t_ms;
+  get_clock_time(&gmt, &t_ms);
+
+  // The number of ms until the next step, or 0 if there isn't one.
+  unsigned int wake_ms = 0;
+
 #if ENABLE_SWEEP_SECONDS
-// Triggered at sweep_timer_ms intervals to run the sweep-second hand
-// (that is, when sweep_seconds is enabled, this timer runs faster
-// than 1 second to update the second hand smoothly).
-void handle_sweep(void *data) {
-  sweep_timer = NULL;  // When the timer is handled, it is implicitly canceled.
-  if (sweep_timer_ms < 1000) {
-    update_hands(NULL);
-    sweep_timer = app_timer_register(sweep_timer_ms, &handle_sweep, 0);
+  if (config.second_hand && config.sweep_seconds) {
+    unsigned int ms = (unsigned int)(gmt % 60) * 1000 + t_ms;
+    wake_ms = get_next_step_ms(ms, 60 * 1000, NUM_STEPS_SECOND / get_second_hand_stride());
   }
-}
 #endif  // ENABLE_SWEEP_SECONDS
 
-// Reset the sweep_timer according to the configured settings.  If
-// sweep_seconds is enabled, this sets the sweep_timer to wake us up
-// at the next sub-second interval.  If sweep_seconds is not enabled,
-// the sweep_timer is not used.
-#if ENABLE_SWEEP_SECONDS
-void reset_sweep() {
-  if (sweep_timer != NULL) {
-    app_timer_cancel(sweep_timer);
-    sweep_timer = NULL;
+#ifdef MAKE_CHRONOGRAPH
+  {
+    unsigned int ms_utc = (unsigned int)((gmt % SECONDS_PER_DAY) * 1000 + t_ms);
+    unsigned int chrono_wake_ms = get_chrono_wake_ms(ms_utc);
+    if (chrono_wake_ms != 0 && (wake_ms == 0 || chrono_wake_ms < wake_ms)) {
+      wake_ms = chrono_wake_ms;
+    }
+  }
+#endif  // MAKE_CHRONOGRAPH
+
+  if (wake_ms == 0) {
+    return;
+  }
+
+#ifdef FAST_TIME
+  // The tick service runs on the real clock, not the virtual one.
+  wake_ms = (wake_ms + FAST_TIME_RATE - 1) / FAST_TIME_RATE;
+  time_ms(&gmt, &t_ms);
+#endif  // FAST_TIME
+
+  // Anything due by the next tick can wait for it; handle_tick()
+  // resets this timer anyway.
+  unsigned int tick_unit_ms = tick_seconds_subscribed ? 1000 : 60 * 1000;
+  unsigned int tick_ms = tick_unit_ms - ((unsigned int)(gmt % 60) * 1000 + t_ms) % tick_unit_ms;
+  if (tick_ms < WAKE_TICK_SLACK_MS) {
+    tick_ms += tick_unit_ms;
   }
-  if (sweep_timer_ms < 1000) {
-    sweep_timer = app_timer_register(sweep_timer_ms, &handle_sweep, 0);
+  if (wake_ms < tick_ms) {
+    wake_timer = app_timer_register(wake_ms, &handle_wake_timer, 0);
   }
 }
-#endif  // ENABLE_SWEEP_SECONDS
+#endif  // SUPPORT_WAKE_TIMER
 
 // The callback on the per-second (or per-minute) system timer that
 // handles most mundane tasks.
 void handle_tick(struct tm *tick_time, TimeUnits units_changed) {
   update_hands(tick_time);
 
-#if ENABLE_SWEEP_SECONDS
-  reset_sweep();
-#endif   //ENABLE_SWEEP_SECONDS
+#ifdef SUPPORT_WAKE_TIMER
+  reset_wake_timer();
+#endif  // SUPPORT_WAKE_TIMER
 
   check_memory_usage();
 }
@@ -1870,82 +2952,53 @@ void handle_tick(struct tm *tick_time, TimeUnits units_changed) {
 void health_event_handler(HealthEventType event, void *context) {
   qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "health event");
 
+  // Check each value the event may have changed.  Only the values
+  // drawn into the clock face are cached, and only those are checked.
+  bool changed = false;
   switch (event) {
   case HealthEventSignificantUpdate:
-    // Invalidate everything.
-    if (cached_sleep_time < 0 &&
-        cached_sleep_restful_time < 0 &&
-        cached_step_count < 0 &&
-        cached_step_count_10 < 0 &&
-        cached_active_time < 0 &&
-        cached_walked_distance < 0 &&
-        cached_calories_burned < 0 &&
-        cached_heart_rate < 0) {
-      // No changes.
-      return;
-    }
-
-    cached_sleep_time = -1;
-    cached_sleep_restful_time = -1;
-    cached_step_count = -1;
-    cached_step_count_10 = -1;
-    cached_active_time = -1;
-    cached_walked_distance = -1;
-    cached_calories_burned = -1;
-    cached_heart_rate = -1;
+    // Check everything.
+    changed |= refresh_cached_health_value(&cached_sleep_time, DWM_sleep_time);
+    changed |= refresh_cached_health_value(&cached_sleep_restful_time, DWM_sleep_restful_time);
+    changed |= refresh_cached_health_value(&cached_step_count, DWM_step_count);
+    changed |= refresh_cached_health_value(&cached_step_count_10, DWM_step_count_10);
+    changed |= refresh_cached_health_value(&cached_active_time, DWM_active_time);
+    changed |= refresh_cached_health_value(&cached_walked_distance, DWM_walked_distance);
+    changed |= refresh_cached_health_value(&cached_calories_burned, DWM_calories_burned);
+    changed |= refresh_cached_health_value(&cached_heart_rate, DWM_heart_rate);
     break;
 
   case HealthEventMovementUpdate:
-    // Invalidate step count, active time, and distance walked.
-    if (cached_step_count < 0 &&
-        cached_step_count_10 < 0 &&
-        cached_active_time < 0 &&
-        cached_walked_distance < 0 &&
-        cached_calories_burned < 0) {
-      // No changes.
-      return;
-    }
-    cached_step_count = -1;
-    cached_step_count_10 = -1;
-    cached_active_time = -1;
-    cached_walked_distance = -1;
-    cached_calories_burned = -1;
+    // Check step count, active time, distance walked, and calories.
+    changed |= refresh_cached_health_value(&cached_step_count, DWM_step_count);
+    changed |= refresh_cached_health_value(&cached_step_count_10, DWM_step_count_10);
+    changed |= refresh_cached_health_value(&cached_active_time, DWM_active_time);
+    changed |= refresh_cached_health_value(&cached_walked_distance, DWM_walked_distance);
+    changed |= refresh_cached_health_value(&cached_calories_burned, DWM_calories_burned);
     break;
 
   case HealthEventSleepUpdate:
-    // Invalidate sleep time.
-    if (cached_sleep_time < 0 &&
-        cached_sleep_restful_time < 0) {
-      // No changes.
-      return;
-    }
-    cached_sleep_time = -1;
-    cached_sleep_restful_time = -1;
+    // Check sleep time.
+    changed |= refresh_cached_health_value(&cached_sleep_time, DWM_sleep_time);
+    changed |= refresh_cached_health_value(&cached_sleep_restful_time, DWM_sleep_restful_time);
     break;
 
 #ifdef SUPPORT_HEART_RATE
   case HealthEventHeartRateUpdate:
-    // Invalidate heart rate.
-    if (cached_heart_rate < 0) {
-      // No changes.
-      return;
-    }
-    cached_heart_rate = -1;
+    // Check heart rate.
+    changed |= refresh_cached_health_value(&cached_heart_rate, DWM_heart_rate);
     break;
 #endif  // SUPPORT_HEART_RATE
 
   default:
     // Some other event we don't care about.
-    return;
+    break;
   }
 
-  if (!tick_seconds_subscribed) {
-    // If we have a second hand update, we don't need to explicitly
-    // redraw the watchface now (because redrawing on the next second
-    // will be good enough); but if we're only updating on the minute,
-    // then we should redraw so the user can see his new step count or
-    // heart rate or whatever.
-    layer_mark_dirty(clock_face_layer);
+  if (changed) {
+    // The face must be drawn again, showing the user their new step
+    // count or heart rate or whatever.
+    invalidate_clock_face();
   }
 }
 #endif  // PBL_PLATFORM_APLITE
@@ -1980,11 +3033,15 @@ void window_appear_handler(struct Window *window) {
 #elif defined(MAKE_CHRONOGRAPH)
   chrono_set_click_config(window);
 #endif  // MAKE_CHRONOGRAPH
+
+  // Another window may have drawn over the frame buffer.
+  mark_clock_face_dirty();
   check_memory_usage();
 }
 
 void window_disappear_handler(struct Window *window) {
   qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "main window disappears");
+  frame_intact = false;
   check_memory_usage();
 }
 
@@ -2011,7 +3068,7 @@ void reset_tick_timer() {
     tick_seconds_subscribed = false;
   }
 
-  reset_chrono_digital_timer();
+  update_chrono_current_time();
 
 #else
   if (config.second_hand) {
@@ -2022,6 +3079,10 @@ void reset_tick_timer() {
     tick_seconds_subscribed = false;
   }
 #endif
+
+#ifdef SUPPORT_WAKE_TIMER
+  reset_wake_timer();
+#endif  // SUPPORT_WAKE_TIMER
 }
 
 void reset_clock_face() {
@@ -2055,12 +3116,8 @@ void fill_date_names(char *date_names[], int num_date_names, char date_names_buf
 void reset_memory_panic_count() {
   memory_panic_count = 0;
 
-#ifdef SUPPORT_RESOURCE_CACHE
-  second_resource_cache_size = SECOND_RESOURCE_CACHE_SIZE + SECOND_MASK_RESOURCE_CACHE_SIZE;
-#ifdef MAKE_CHRONOGRAPH
-  chrono_second_resource_cache_size = CHRONO_SECOND_RESOURCE_CACHE_SIZE +  + CHRONO_SECOND_MASK_RESOURCE_CACHE_SIZE;
-#endif  // MAKE_CHRONOGRAPH
-#endif  // SUPPORT_RESOURCE_CACHE
+  bwd_set_cache_budget(RESOURCE_CACHE_BUDGET);
+  rle_cache_set_budget(RLE_CACHE_BUDGET);
 
   // Confidently start out with the expectation that we keep keep all
   // of this cached in RAM, until proven otherwise.
@@ -2071,14 +3128,18 @@ void reset_memory_panic_count() {
   keep_face_asset = true;
 #endif  // NEVER_KEEP_FACE_ASSET
 
+  keep_hands_face = true;
   hide_date_windows = false;
   hide_clock_face = false;
+  second_hand_tier = SHT_full;
+  second_hand_restore_checks = 0;
+  second_hand_restore_wait = SECOND_HAND_RESTORE_CHECKS;
+  second_hand_restored = false;
 }
 
-// Updates any runtime settings as needed when the config changes.
-void apply_config() {
-  qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "apply_config");
-
+// Updates the settings that follow from the config, short of
+// recreating the objects that depend on it.
+static void apply_config_settings() {
   // Reset the memory panic count when we get a new config setting.
   // Maybe the user knows what he's doing.
   reset_memory_panic_count();
@@ -2094,11 +3155,67 @@ void apply_config() {
     fill_date_names(date_names, NUM_DATE_NAMES, date_names_buffer, DATE_NAMES_MAX_BUFFER, lang_table[config.display_lang].date_name_id);
     display_lang = config.display_lang;
   }
+}
 
-  // Reload all bitmaps just for good measure.  Maybe the user changed
-  // the draw mode or something else.
-  recreate_all_objects();
-  reset_tick_timer();
+// Updates the runtime settings after the config has changed from
+// orig_config, doing only the work that the changed fields call for,
+// rather than recreating everything.
+void apply_config_changes(const ConfigOptions *orig_config) {
+  // The buzzers are consulted only when they go off, so a change to
+  // them alone needs nothing else.
+  ConfigOptions other_config = *orig_config;
+  other_config.hour_buzzer = config.hour_buzzer;
+  other_config.bluetooth_buzzer = config.bluetooth_buzzer;
+  if (memcmp(&other_config, &config, sizeof(config)) == 0) {
+    qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "apply_config_changes: buzzers only");
+    return;
+  }
+
+  qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "apply_config_changes");
+  enum SecondHandTier orig_tier = second_hand_tier;
+  apply_config_settings();
+
+  if (config.color_mode != orig_config->color_mode || config.draw_mode != orig_config->draw_mode) {
+    // Everything drawn has been remapped to the old colors.
+    recolor_bitmaps();
+  }
+
+  if (config.face_index != orig_config->face_index || config.top_subdial != orig_config->top_subdial) {
+    bwd_destroy(&face_bitmap);
+    bwd_destroy(&top_subdial_frame_mask);
+    bwd_destroy(&top_subdial_mask);
+    bwd_destroy(&top_subdial_bitmap);
+  }
+
+  if (config.lunar_background != orig_config->lunar_background || config.lunar_direction != orig_config->lunar_direction) {
+    bwd_destroy(&moon_wheel_bitmap);
+  }
+
+  if (config.display_lang != orig_config->display_lang) {
+    // The names have already been refilled; the font may differ too.
+    // prepare_date_fonts() loads it again when it's next needed.
+    unload_date_fonts();
+  }
+
+#ifndef PBL_PLATFORM_APLITE
+  if (memcmp(config.date_windows, orig_config->date_windows, sizeof(config.date_windows)) != 0) {
+    // Don't go on redrawing for a health value no longer shown.
+    clear_cached_health_values();
+  }
+#endif  // PBL_PLATFORM_APLITE
+
+  if (second_hand_tier != orig_tier || (orig_config->second_hand && !config.second_hand)) {
+    // The second hand cache holds a hand we won't be drawing now.
+    hand_cache_destroy(&second_cache);
+  }
+
+  if (config.second_hand != orig_config->second_hand || config.sweep_seconds != orig_config->sweep_seconds || config.chrono_dial != orig_config->chrono_dial) {
+    reset_tick_timer();
+  }
+
+  // The date windows, indicators, and everything else are read anew
+  // as the face is redrawn.
+  invalidate_clock_face();
 }
 
 // Call this to force the clock_face bitmap cache to be recomputed and
@@ -2108,9 +3225,15 @@ void invalidate_clock_face() {
   qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "invalidate_clock_face");
   redraw_clock_face = true;
   bwd_destroy(&clock_face);
-  if (clock_face_layer != NULL) {
-    layer_mark_dirty(clock_face_layer);
-  }
+  bwd_destroy(&hands_face);
+  mark_clock_face_dirty();
+}
+
+// Call this when the phase 1 hands have moved, to rebuild hands_face
+// from clock_face next frame.
+void invalidate_hands_face() {
+  redraw_hands_face = true;
+  mark_clock_face_dirty();
 }
 
 void unload_date_fonts() {
@@ -2124,6 +3247,7 @@ void unload_date_fonts() {
   if (date_lang_font != NULL) {
     safe_unload_custom_font(&date_lang_font);
   }
+  date_fonts_size = 0;
 }
 
 void load_date_fonts() {
@@ -2133,21 +3257,40 @@ void load_date_fonts() {
     // threshold.
 
   } else {
-    // Load the date_window fonts up early, and keep them loaded, so
-    // they're always here in the top of memory.  (Fonts seem to
-    // sometimes fail to load correctly, with no reported error, when
-    // memory is fragmented, so better to load them up front to avoid
-    // this problem.)
+    // Load the date_window fonts at the start of the first frame
+    // that needs them (see prepare_date_fonts()), and keep them
+    // loaded, so they're always here in the top of memory.  (Fonts
+    // seem to sometimes fail to load correctly, with no reported
+    // error, when memory is fragmented, so better to load them before
+    // the frame's bitmaps to avoid this problem.)
 
     const LangDef *lang = &lang_table[config.display_lang];
     int lang_font_resource_id = date_lang_font_placement[lang->font_index].resource_id;
     int numeric_font_resource_id = date_lang_font_placement[0].resource_id;
+    size_t bytes_free = heap_bytes_free();
     date_lang_font = safe_load_custom_font(lang_font_resource_id);
     if (numeric_font_resource_id == lang_font_resource_id) {
       date_numeric_font = date_lang_font;
     } else {
       date_numeric_font = safe_load_custom_font(numeric_font_resource_id);
     }
+    date_fonts_size = bytes_free - heap_bytes_free();
+  }
+}
+
+// Loads the date fonts, if they aren't loaded already and any date
+// window is showing.  This is called at the start of each complete
+// frame, so the fonts are loaded on first use, but ahead of the
+// frame's bitmaps.
+static void prepare_date_fonts() {
+  if (date_lang_font != NULL || hide_date_windows) {
+    return;
+  }
+  for (int i = 0; i < NUM_DATE_WINDOWS; ++i) {
+    if (config.date_windows[i] != DWM_off) {
+      load_date_fonts();
+      return;
+    }
   }
 }
 
@@ -2185,6 +3328,36 @@ void unobstructed_area_change_handler(AnimationProgress progress, void *context)
 }
 #endif  // PBL_API_EXISTS(layer_get_unobstructed_bounds)
 
+// Adds the assets of this module to the asset registry (see
+// assets.h).  This is called only once, at startup.
+void register_assets() {
+  asset_register(&clock_face, AK_bitmap, AC_render);
+  asset_register(&hands_face, AK_hands_face, AC_decode);
+  asset_register(&face_bitmap, AK_bitmap, AC_decode);
+  asset_register(&date_window, AK_bitmap, AC_decode);
+  asset_register(&date_window_mask, AK_bitmap, AC_decode);
+  asset_register(&top_subdial_frame_mask, AK_bitmap, AC_decode);
+  asset_register(&top_subdial_mask, AK_bitmap, AC_decode);
+  asset_register(&top_subdial_bitmap, AK_bitmap, AC_decode);
+  asset_register(&moon_wheel_bitmap, AK_bitmap, AC_decode);
+#ifndef PREBAKE_LABEL
+  asset_register(&pebble_label, AK_bitmap, AC_decode);
+#endif  // PREBAKE_LABEL
+  asset_register(&hour_cache, AK_hand_cache, AC_decode);
+  asset_register(&minute_cache, AK_hand_cache, AC_decode);
+  asset_register(&second_cache, AK_hand_cache, AC_decode);
+  asset_register(&date_lang_font, AK_date_fonts, AC_font);
+
+  // The caches are registered by the address of their byte counts,
+  // which is as good a key as any.
+#ifdef SUPPORT_RESOURCE_CACHE
+  asset_register(&resource_cache_bytes, AK_resource_cache, AC_cache);
+#endif  // SUPPORT_RESOURCE_CACHE
+#ifdef SUPPORT_RLE_CACHE
+  asset_register(&rle_cache_bytes, AK_rle_cache, AC_cache);
+#endif  // SUPPORT_RLE_CACHE
+}
+
 // This is called only once, at startup.
 void create_permanent_objects() {
   window = window_create();
@@ -2210,6 +3383,15 @@ void create_permanent_objects() {
   layer_set_update_proc(clock_face_layer, &clock_face_layer_update_callback);
   layer_add_child(window_layer, clock_face_layer);
 
+  // second_hand_layer starts out empty; mark_second_hand_dirty() moves
+  // it over the part of the face to redraw.  For this to work, the
+  // window must not clear the frame buffer before each frame.
+  second_hand_layer = layer_create(GRect(0, 0, 0, 0));
+  assert(second_hand_layer != NULL);
+  layer_set_update_proc(second_hand_layer, &second_hand_layer_update_callback);
+  layer_add_child(clock_face_layer, second_hand_layer);
+  window_set_background_color(window, GColorClear);
+
 #if !defined(PBL_PLATFORM_APLITE) && PBL_API_EXISTS(layer_get_unobstructed_bounds)
   layer_set_update_proc(window_layer, &root_layer_update_callback);
 
@@ -2223,6 +3405,8 @@ void create_permanent_objects() {
 
 // This is, of course, called only once, at shutdown.
 void destroy_permanent_objects() {
+  layer_destroy(second_hand_layer);
+  second_hand_layer = NULL;
   layer_destroy(clock_face_layer);
   clock_face_layer = NULL;
 
@@ -2253,12 +3437,16 @@ void create_temporal_objects() {
 }
 
 // Destroys the objects created by create_temporal_objects().
-void destroy_temporal_objects() {
-  qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "destroy_temporal_objects");
-
+// Releases every bitmap drawn in the face's colors, along with the
+// resource cache that lends them, so they will be loaded and remapped
+// again as they are next needed.  The fonts and the compressed rle
+// cache are not affected.
+static void release_bitmaps() {
   bwd_destroy(&date_window);
   bwd_destroy(&date_window_mask);
   bwd_destroy(&face_bitmap);
+  bwd_destroy(&top_subdial_frame_mask);
+  bwd_destroy(&top_subdial_mask);
   bwd_destroy(&top_subdial_bitmap);
   bwd_destroy(&moon_wheel_bitmap);
 
@@ -2267,6 +3455,73 @@ void destroy_temporal_objects() {
 #endif  // PREBAKE_LABEL
 
   bwd_destroy(&clock_face);
+  bwd_destroy(&hands_face);
+
+#ifdef ENABLE_CHRONO_DIAL
+  release_chrono_bitmaps();
+#endif  // ENABLE_CHRONO_DIAL
+
+  destroy_battery_gauge_bitmaps();
+  destroy_bluetooth_bitmaps();
+
+  hand_cache_destroy(&hour_cache);
+  hand_cache_destroy(&minute_cache);
+  hand_cache_destroy(&second_cache);
+
+  // This must follow hand_cache_destroy(), which returns the bitmaps
+  // the hands borrowed from the resource cache.
+  bwd_clear_cache();
+}
+
+#ifndef PBL_BW
+// As bwd_recolor(), or releases the bitmap if it can't be recolored.
+static void recolor_bwd(BitmapWithData *bwd, const BwdRemap *remap) {
+  if (!bwd_recolor(bwd, remap)) {
+    bwd_destroy(bwd);
+  }
+}
+#endif  // PBL_BW
+
+// Remaps the bitmaps in memory to the current color_mode and
+// draw_mode, after they have changed, from the original palettes
+// they keep (see bwd_recolor()), rather than loading them all again.
+// The few that can't be remapped that way are released instead.
+static void recolor_bitmaps() {
+#ifndef PBL_BW
+  BwdRemap remap_clock, remap_date;
+  get_remap_clock(&remap_clock);
+  get_remap_date(&remap_date);
+
+  recolor_bwd(&face_bitmap, &remap_clock);
+  recolor_bwd(&top_subdial_bitmap, &remap_clock);
+#ifndef PREBAKE_LABEL
+  recolor_bwd(&pebble_label, &remap_clock);
+#endif  // PREBAKE_LABEL
+  recolor_bwd(&date_window, &remap_date);
+
+  // The moon has its own colors, and is reloaded with each phase
+  // anyway; and the battery gauge bitmaps are small.
+  bwd_destroy(&moon_wheel_bitmap);
+  destroy_battery_gauge_bitmaps();
+
+#ifdef ENABLE_CHRONO_DIAL
+  recolor_chrono_bitmaps(&remap_clock);
+#endif  // ENABLE_CHRONO_DIAL
+
+  hand_cache_recolor(&hour_cache, &remap_clock);
+  hand_cache_recolor(&minute_cache, &remap_clock);
+  hand_cache_recolor(&second_cache, &remap_clock);
+
+  // This must follow hand_cache_recolor(), which returns the bitmaps
+  // it couldn't recolor to the resource cache.
+  bwd_cache_recolor(&remap_clock);
+#endif  // PBL_BW
+}
+
+void destroy_temporal_objects() {
+  qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "destroy_temporal_objects");
+
+  release_bitmaps();
   face_index = -1;
 
 #ifdef ENABLE_CHRONO_DIAL
@@ -2276,15 +3531,7 @@ void destroy_temporal_objects() {
   deinit_battery_gauge();
   deinit_bluetooth_indicator();
 
-  bwd_clear_cache(second_resource_cache, SECOND_RESOURCE_CACHE_SIZE + SECOND_MASK_RESOURCE_CACHE_SIZE);
-
-#ifdef MAKE_CHRONOGRAPH
-  bwd_clear_cache(chrono_second_resource_cache, CHRONO_SECOND_RESOURCE_CACHE_SIZE + CHRONO_SECOND_MASK_RESOURCE_CACHE_SIZE);
-#endif  // MAKE_CHRONOGRAPH
-
-  hand_cache_destroy(&hour_cache);
-  hand_cache_destroy(&minute_cache);
-  hand_cache_destroy(&second_cache);
+  rle_cache_clear();
 
   display_lang = -1;
 }
@@ -2293,17 +3540,27 @@ void recreate_all_objects() {
   unload_date_fonts();
   destroy_temporal_objects();
   create_temporal_objects();
-  load_date_fonts();
   qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "recreate_all_objects");
   invalidate_clock_face();
 }
 
 // Called at program exit to cleanly shut everything down.
+#if !defined(NDEBUG) && !defined(SCREENSHOT_BUILD)
+// In a debug build, tapping the watch writes the recent frame timings
+// to the log.  (The screenshot build uses the tap for itself.)
+static void timing_tap_handler(AccelAxisType axis, int32_t direction) {
+  timing_dump_log();
+}
+#endif  // NDEBUG
+
 void handle_deinit() {
 #ifdef MAKE_CHRONOGRAPH
   save_chrono_data();
 #endif  // MAKE_CHRONOGRAPH
   tick_timer_service_unsubscribe();
+#if !defined(NDEBUG) && !defined(SCREENSHOT_BUILD)
+  accel_tap_service_unsubscribe();
+#endif  // NDEBUG
 
   unload_date_fonts();
   destroy_temporal_objects();
@@ -2312,6 +3569,7 @@ void handle_deinit() {
 
 // Called at program start to bootstrap everything.
 void handle_init() {
+  timing_launch_start();
   qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "handle_init");
 
   load_config();
@@ -2344,15 +3602,21 @@ void handle_init() {
   app_message_open(INBOX_MESSAGE_SIZE, OUTBOX_MESSAGE_SIZE);
 #endif  // NDEBUG
 
-  reset_memory_panic_count();
+  register_assets();
   create_permanent_objects();
   create_temporal_objects();
 
-  time_t now = time(NULL);
+  time_t now;
+  uint16_t now_ms;
+  get_clock_time(&now, &now_ms);
   struct tm *startup_time = localtime(&now);
   compute_hands(startup_time, &current_placement);
 
-  apply_config();
+  // The temporal objects were just created under the loaded config,
+  // so unlike apply_config_changes(), there's nothing to release.  Nothing
+  // else is loaded until the first frame asks for it.
+  apply_config_settings();
+  reset_tick_timer();
   check_memory_usage();
 
   AppFocusHandlers focus_handlers;
@@ -2363,6 +3627,10 @@ void handle_init() {
 #ifndef PBL_PLATFORM_APLITE
   health_service_events_subscribe(health_event_handler, NULL);
 #endif  // PBL_PLATFORM_APLITE
+
+#if !defined(NDEBUG) && !defined(SCREENSHOT_BUILD)
+  accel_tap_service_subscribe(timing_tap_handler);
+#endif  // NDEBUG
 }
 
 void trigger_memory_panic(int line_number) {
@@ -2376,38 +3644,60 @@ void trigger_memory_panic(int line_number) {
 
 void reset_memory_panic() {
   // The memory_panic_flag was set, indicating that something
-  // somewhere failed to allocate memory.  Destroy and recreate
-  // everything, in the hopes this will clear out memory
-  // fragmentation.
+  // somewhere failed to allocate memory.  If there's an asset we can
+  // evict, do that and let the caller try again; otherwise destroy
+  // and recreate everything, in the hopes this will clear out memory
+  // fragmentation, and give up features one at a time as the panics
+  // mount.
 
   memory_panic_flag = false;
+
+  // First, see if giving up a cached asset is enough.
+  if (panic_evictions < MAX_PANIC_EVICTIONS && asset_evict_one()) {
+    ++panic_evictions;
+    qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "reset_memory_panic evicted, panic_evictions = %d", panic_evictions);
+    return;
+  }
+  panic_evictions = 0;
+
   ++memory_panic_count;
 
   qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "reset_memory_panic begin, count = %d", memory_panic_count);
 
   recreate_all_objects();
 
+  // The compressed rle cache and the resource cache each give up half
+  // of their budget with each panic.
+  rle_cache_set_budget((memory_panic_count < 8) ? RLE_CACHE_BUDGET >> memory_panic_count : 0);
+  bwd_set_cache_budget((memory_panic_count < 8) ? RESOURCE_CACHE_BUDGET >> memory_panic_count : 0);
+
   // Start resetting some options if the memory panic count grows too high.
   if (memory_panic_count > 0) {
 #ifndef NEVER_KEEP_FACE_ASSET
     keep_face_asset = false;
 #endif  // NEVER_KEEP_FACE_ASSET
+    keep_hands_face = false;
   }
   if (memory_panic_count > 1) {
 #ifndef NEVER_KEEP_ASSETS
     keep_assets = false;
 #endif  // NEVER_KEEP_ASSETS
   }
-#ifdef SUPPORT_RESOURCE_CACHE
-  if (memory_panic_count > 2) {
-    second_resource_cache_size = 0;
-#ifdef MAKE_CHRONOGRAPH
-    chrono_second_resource_cache_size = 0;
-#endif  // MAKE_CHRONOGRAPH
-  }
-#endif  // SUPPORT_RESOURCE_CACHE
-  if (memory_panic_count > 3) {
-    config.second_hand = false;
+  if (memory_panic_count > 3 && config.second_hand) {
+    // Each panic from here on takes the second hand down a tier.
+    if (second_hand_restored) {
+      // It wasn't ready to come back after all; wait longer next time.
+      second_hand_restored = false;
+      if (second_hand_restore_wait < SECOND_HAND_RESTORE_MAX_CHECKS) {
+        second_hand_restore_wait *= 2;
+      }
+    }
+    if (second_hand_tier == SHT_full) {
+      set_second_hand_tier(SHT_reduced);
+    } else {
+      config.second_hand = false;
+      set_second_hand_tier(SHT_off);
+    }
   }
   if (memory_panic_count > 4) {
     save_framebuffer = false;
@@ -2442,4 +3732,5 @@ int main(void) {
   handle_init();
   app_event_loop();
   handle_deinit();
+  return 0;
 }
@@ -16,6 +16,7 @@
 #include "assert.h"
 
 #include "bwd.h"
+#include "assets.h"
 
 //#define SECONDS_PER_DAY 86400
 //#define SECONDS_PER_HOUR 3600
@@ -40,10 +41,20 @@
 #define SUPPORT_HEART_RATE
 #endif  // PBL_PLATFORM_DIORITE
 
-// Drawing the phase hands separately doesn't seem to be a performance
-// win for some reason.
-#define SEPARATE_PHASE_HANDS 0
-//#define SEPARATE_PHASE_HANDS (config.second_hand)
+#ifdef FAST_TIME
+// In a FAST_TIME build, the clock runs this many times faster than
+// real time (see get_clock_time()).
+#define FAST_TIME_RATE 67
+#define CLOCK_IS_VIRTUAL true
+#else  // FAST_TIME
+#define CLOCK_IS_VIRTUAL false
+#endif  // FAST_TIME
+
+#if ENABLE_SWEEP_SECONDS || defined(MAKE_CHRONOGRAPH)
+// Something may need to wake us up between ticks (see
+// reset_wake_timer()).
+#define SUPPORT_WAKE_TIMER 1
+#endif  // ENABLE_SWEEP_SECONDS || MAKE_CHRONOGRAPH
 
 // This structure keeps track of the things that change on the visible
 // watch face and their current state.
@@ -73,6 +84,10 @@ struct __attribute__((__packed__)) HandPlacement {
   // Not really a hand placement, but this is the hour at which we
   // last rang (or should next ring) the buzzer.
   unsigned char buzzed_hour;
+
+  // Similarly, the minute at which we last polled the quiet time
+  // state, which we only check once a minute.
+  unsigned char polled_minute;
 };
 
 // Keeps track of the current bitmap and/or path for a particular
@@ -83,6 +98,19 @@ struct __attribute__((__packed__)) HandCache {
   unsigned char bitmap_hand_index;
   BitmapWithData image;
   BitmapWithData mask;
+  bool image_borrowed;  // true if image belongs to the resource cache
+  bool mask_borrowed;   // likewise for mask
+  bool buffered;        // true if image and mask are reusable buffers
+  bool stale;           // true if image and mask need to be refilled
+  uint16_t image_capacity;  // the room in image's buffer, if buffered
+  uint16_t mask_capacity;   // likewise for mask
+  RleWindow window;         // what the buffers are decoded from, if buffered
+#ifdef SUPPORT_HAND_ROTATION
+  // For a hand rotated at runtime, the unrotated bitmaps it is drawn
+  // from; image and mask are then reused for each new angle.
+  BitmapWithData master;
+  BitmapWithData master_mask;
+#endif  // SUPPORT_HAND_ROTATION
   unsigned char vector_hand_index;
   short cx, cy;
   GPath *path[HAND_CACHE_MAX_GROUPS];
@@ -104,6 +132,9 @@ typedef struct {
 extern bool memory_panic_flag;
 extern int memory_panic_count;
 
+// The heap taken by the date window fonts while they are loaded.
+extern size_t date_fonts_size;
+
 #ifdef NEVER_KEEP_ASSETS
 #define keep_assets false
 #else
@@ -117,19 +148,20 @@ extern bool keep_face_asset;
 #endif  // NEVER_KEEP_FACE_ASSET
 
 extern DrawModeTable draw_mode_table[2];
-extern int sweep_timer_ms;
 
 extern struct HandPlacement current_placement;
 extern Window *window;
 
 extern Layer *clock_face_layer;
 
+// These pass along whether a hand's bitmaps should be kept in the
+// shared resource cache (see bwd.c).
 #ifdef SUPPORT_RESOURCE_CACHE
-#define RESOURCE_CACHE_PARAMS(a, b) , a, b
-#define RESOURCE_CACHE_FORMAL_PARAMS , struct ResourceCache *resource_cache, size_t resource_cache_size
+#define RESOURCE_CACHE_PARAMS(use_cache) , use_cache
+#define RESOURCE_CACHE_FORMAL_PARAMS , bool use_resource_cache
 
 #else
-#define RESOURCE_CACHE_PARAMS(a, b)
+#define RESOURCE_CACHE_PARAMS(use_cache)
 #define RESOURCE_CACHE_FORMAL_PARAMS
 
 #endif
@@ -140,16 +172,29 @@ void started_click_config_provider(void *context);
 
 void trigger_memory_panic(int line_number);
 void reset_memory_panic();
+void get_clock_time(time_t *gmt, uint16_t *t_ms);
 void update_hands(struct tm *time);
 void hand_cache_init(struct HandCache *hand_cache);
 void hand_cache_destroy(struct HandCache *hand_cache);
+void hand_cache_recolor(struct HandCache *hand_cache, const BwdRemap *remap);
+size_t hand_cache_get_size(struct HandCache *hand_cache);
+void release_hands_face();
+void load_date_fonts();
+void unload_date_fonts();
 void reset_tick_timer();
+#ifdef SUPPORT_WAKE_TIMER
+unsigned int get_next_step_ms(unsigned int ms, unsigned int period_ms, unsigned int num_steps);
+void reset_wake_timer();
+#endif  // SUPPORT_WAKE_TIMER
 void draw_hand_mask(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARAMS, struct HandDef *hand_def, int hand_index, bool no_basalt_mask, GContext *ctx);
 void draw_hand_fg(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARAMS, struct HandDef *hand_def, int hand_index, bool no_basalt_mask, GContext *ctx);
 void draw_hand(struct HandCache *hand_cache RESOURCE_CACHE_FORMAL_PARAMS, struct HandDef *hand_def, int hand_index, GContext *ctx);
+const BwdRemap *get_remap_clock(BwdRemap *remap);
 void remap_colors_clock(BitmapWithData *bwd);
 void remap_colors_date(BitmapWithData *bwd);
 void invalidate_clock_face();
+void invalidate_hands_face();
+void mark_clock_face_dirty();
 void destroy_objects();
 void create_objects();
 void recreate_all_objects();
@@ -45,9 +45,6 @@ bool chrono_dial_shows_tenths = false;
 
 struct HandCache chrono_second_cache;
 
-struct ResourceCache chrono_second_resource_cache[CHRONO_SECOND_RESOURCE_CACHE_SIZE + CHRONO_SECOND_MASK_RESOURCE_CACHE_SIZE];
-size_t chrono_second_resource_cache_size = CHRONO_SECOND_RESOURCE_CACHE_SIZE +  + CHRONO_SECOND_MASK_RESOURCE_CACHE_SIZE;
-
 // This window is pushed on top of the chrono dial to display the
 // readout in digital form for ease of recording.
 Window *chrono_digital_window;
@@ -57,7 +54,6 @@ TextLayer *chrono_digital_current_layer = NULL;
 TextLayer *chrono_digital_laps_layer[CHRONO_MAX_LAPS];
 Layer *chrono_digital_line_layer = NULL;
 bool chrono_digital_window_showing = false;
-AppTimer *chrono_digital_timer = NULL;
 
 #define CHRONO_DIGITAL_BUFFER_SIZE 11 // Enough space for "hh:mm:ss.d" plus a null byte
 char chrono_current_buffer[CHRONO_DIGITAL_BUFFER_SIZE];
@@ -65,8 +61,6 @@ char chrono_laps_buffer[CHRONO_MAX_LAPS][CHRONO_DIGITAL_BUFFER_SIZE];
 
 #define CHRONO_DIGITAL_TICK_MS 100 // Every 0.1 seconds
 
-int sweep_chrono_seconds_ms = 60 * 1000 / NUM_STEPS_CHRONO_SECOND;
-
 ChronoData chrono_data = { false, false, 0, 0, { 0, 0, 0, 0 } };
 ChronoData saved_chrono_data;
 
@@ -134,19 +128,19 @@ void draw_chrono_dial(GContext *ctx) {
 
     // On color watches, we only load the "white" image.
     if (chrono_dial_white.bitmap == NULL) {
+      // We apply the color scheme as it is decoded.
+      BwdRemap remap;
       if (chrono_dial_shows_tenths) {
-        chrono_dial_white = rle_bwd_create(RESOURCE_ID_CHRONO_DIAL_TENTHS_WHITE);
+        chrono_dial_white = rle_bwd_create_transformed(RESOURCE_ID_CHRONO_DIAL_TENTHS_WHITE, false, false, get_remap_clock(&remap));
       } else {
-        chrono_dial_white = rle_bwd_create(RESOURCE_ID_CHRONO_DIAL_HOURS_WHITE);
+        chrono_dial_white = rle_bwd_create_transformed(RESOURCE_ID_CHRONO_DIAL_HOURS_WHITE, false, false, get_remap_clock(&remap));
       }
       if (chrono_dial_white.bitmap == NULL) {
         trigger_memory_panic(__LINE__);
         return;
       }
-
-      // We apply the color scheme as needed.
-      remap_colors_clock(&chrono_dial_white);
     }
+    asset_touch(&chrono_dial_white);
 
     int x = chrono_tenth_hand_def.place_x - CHRONO_DIAL_SIZE_X / 2;
     int y = chrono_tenth_hand_def.place_y - CHRONO_DIAL_SIZE_Y / 2;
@@ -176,27 +170,54 @@ void create_chrono_objects() {
   qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "create_chrono_objects");
   hand_cache_init(&chrono_minute_cache);
   hand_cache_init(&chrono_tenth_cache);
+  asset_register(&chrono_minute_cache, AK_hand_cache, AC_decode);
+  asset_register(&chrono_tenth_cache, AK_hand_cache, AC_decode);
+  asset_register(&chrono_dial_white, AK_bitmap, AC_decode);
 
 #ifdef MAKE_CHRONOGRAPH
   hand_cache_init(&chrono_second_cache);
+  asset_register(&chrono_second_cache, AK_hand_cache, AC_decode);
   update_chrono_laps_time();
 #endif  // MAKE_CHRONOGRAPH
 }
 
 
-void destroy_chrono_objects() {
-  qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "destroy_chrono_objects");
-
+// Releases the chrono bitmaps, which are remapped to the face's
+// colors, so they will be loaded again when next drawn.
+void release_chrono_bitmaps() {
   hand_cache_destroy(&chrono_minute_cache);
   hand_cache_destroy(&chrono_tenth_cache);
   bwd_destroy(&chrono_dial_white);
 
+#ifdef MAKE_CHRONOGRAPH
+  hand_cache_destroy(&chrono_second_cache);
+#endif  // MAKE_CHRONOGRAPH
+}
+
+// Remaps the chrono bitmaps to the current color mode, as by
+// recolor_bitmaps().
+void recolor_chrono_bitmaps(const BwdRemap *remap) {
+  hand_cache_recolor(&chrono_minute_cache, remap);
+  hand_cache_recolor(&chrono_tenth_cache, remap);
+  if (!bwd_recolor(&chrono_dial_white, remap)) {
+    bwd_destroy(&chrono_dial_white);
+  }
+
+#ifdef MAKE_CHRONOGRAPH
+  hand_cache_recolor(&chrono_second_cache, remap);
+#endif  // MAKE_CHRONOGRAPH
+}
+
+void destroy_chrono_objects() {
+  qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "destroy_chrono_objects");
+
+  release_chrono_bitmaps();
+
 #ifdef MAKE_CHRONOGRAPH
   if (chrono_digital_window != NULL) {
     window_destroy(chrono_digital_window);
     chrono_digital_window = NULL;
   }
-  hand_cache_destroy(&chrono_second_cache);
 #endif  // MAKE_CHRONOGRAPH
 }
 
@@ -210,13 +231,9 @@ unsigned int get_time_ms() {
   uint16_t t_ms;
   unsigned int ms_utc;
 
-  time_ms(&gmt, &t_ms);
+  get_clock_time(&gmt, &t_ms);
   ms_utc = (unsigned int)((gmt % SECONDS_PER_DAY) * 1000 + t_ms);
 
-#ifdef FAST_TIME
-  ms_utc *= 67;
-#endif  // FAST_TIME
-
   return ms_utc;
 }
 
@@ -296,49 +313,47 @@ void update_chrono_hands(struct HandPlacement *new_placement) {
 #ifdef ENABLE_CHRONO_MINUTE_HAND
   if (new_placement->chrono_minute_hand_index != current_placement.chrono_minute_hand_index) {
     current_placement.chrono_minute_hand_index = new_placement->chrono_minute_hand_index;
-    layer_mark_dirty(clock_face_layer);
-
-    if (SEPARATE_PHASE_HANDS) {
-      // If the second hand is enabled, the hour and minute hands are
-      // baked into the clock face cache, which must be redrawn now.
-      qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "chrono minute hand changed with SEPARATE_PHASE_HANDS");
-      invalidate_clock_face();
-    }
+    invalidate_hands_face();
   }
 #endif  // ENABLE_CHRONO_MINUTE_HAND
 
 #ifdef ENABLE_CHRONO_SECOND_HAND
   if (new_placement->chrono_second_hand_index != current_placement.chrono_second_hand_index) {
     current_placement.chrono_second_hand_index = new_placement->chrono_second_hand_index;
-    layer_mark_dirty(clock_face_layer);
+    mark_clock_face_dirty();
   }
 #endif  // ENABLE_CHRONO_SECOND_HAND
 
 #ifdef ENABLE_CHRONO_TENTH_HAND
   if (new_placement->chrono_tenth_hand_index != current_placement.chrono_tenth_hand_index) {
     current_placement.chrono_tenth_hand_index = new_placement->chrono_tenth_hand_index;
-    layer_mark_dirty(clock_face_layer);
-
-    if (SEPARATE_PHASE_HANDS) {
-      // If the second hand is enabled, the hour and minute hands are
-      // baked into the clock face cache, which must be redrawn now.
-      qapp_log(APP_LOG_LEVEL_INFO, __FILE__, __LINE__, "chrono tenth hand changed with SEPARATE_PHASE_HANDS");
-      invalidate_clock_face();
-    }
+    invalidate_hands_face();
   }
 #endif  // ENABLE_CHRONO_TENTH_HAND
+}
+
+// Returns the number of ms from ms (as returned by get_time_ms())
+// until the chronograph next needs to be updated between ticks: the
+// next step of its sweep-second hand, or the next tenth of a second
+// in the digital readout.  Returns 0 if it doesn't need to be.
+unsigned int get_chrono_wake_ms(unsigned int ms) {
+  if (!chrono_data.running || chrono_data.lap_paused) {
+    // The chronograph isn't moving.
+    return 0;
+  }
+
+  unsigned int chrono_ms = get_chrono_ms(ms);
+  if (chrono_digital_window_showing) {
+    return get_next_step_ms(chrono_ms, CHRONO_DIGITAL_TICK_MS, 1);
+  }
 
-#if ENABLE_SWEEP_SECONDS
+#if ENABLE_SWEEP_SECONDS && defined(ENABLE_CHRONO_SECOND_HAND)
   if (config.sweep_seconds) {
-    if (chrono_data.running && !chrono_data.lap_paused && !chrono_digital_window_showing) {
-      // With the chronograph running, the sweep timer must be fast
-      // enough to capture the chrono second hand.
-      if (sweep_chrono_seconds_ms < sweep_timer_ms) {
-        sweep_timer_ms = sweep_chrono_seconds_ms;
-      }
-    }
+    return get_next_step_ms(chrono_ms, 60 * 1000, NUM_STEPS_CHRONO_SECOND);
   }
-#endif  // ENABLE_SWEEP_SECONDS
+#endif  // ENABLE_SWEEP_SECONDS && ENABLE_CHRONO_SECOND_HAND
+
+  return 0;
 }
 
 void chrono_start_stop_handler(ClickRecognizerRef recognizer, void *context) {
@@ -368,13 +383,6 @@ void chrono_start_stop_handler(ClickRecognizerRef recognizer, void *context) {
     // start, from the currently showing Chronograph time.
     chrono_data.start_ms = ms - chrono_data.hold_ms;
     chrono_data.running = true;
-#if ENABLE_SWEEP_SECONDS
-    if (config.sweep_seconds) {
-      if (sweep_chrono_seconds_ms < sweep_timer_ms) {
-        sweep_timer_ms = sweep_chrono_seconds_ms;
-      }
-    }
-#endif  // ENABLE_SWEEP_SECONDS
     vibes_enqueue_custom_pattern(chrono_tap);
     update_hands(NULL);
     reset_tick_timer();
@@ -397,6 +405,7 @@ void chrono_lap_button() {
     chrono_data.lap_paused = false;
     vibes_enqueue_custom_pattern(chrono_tap);
     update_hands(NULL);
+    reset_wake_timer();
   } else {
     // If we were not already paused, this pauses the hands here (but
     // does not stop the timer).
@@ -410,15 +419,17 @@ void chrono_lap_button() {
     }
     vibes_enqueue_custom_pattern(chrono_tap);
     update_hands(NULL);
+    reset_wake_timer();
   }
 }
 
 void chrono_reset_button() {
   // Resets the chronometer to 0 time.
   time_t now;
+  uint16_t now_ms;
   struct tm *this_time;
 
-  now = time(NULL);
+  get_clock_time(&now, &now_ms);
   this_time = localtime(&now);
   chrono_data.running = false;
   chrono_data.lap_paused = false;
@@ -691,22 +702,11 @@ void update_chrono_current_time() {
   }
 }
 
-void handle_chrono_digital_timer(void *data) {
-  chrono_digital_timer = NULL;  // When the timer is handled, it is implicitly canceled.
-
-  reset_chrono_digital_timer();
-}
-
+// Updates the digital readout, and the wake_timer that keeps it
+// running while it's showing.
 void reset_chrono_digital_timer() {
-  if (chrono_digital_timer != NULL) {
-    app_timer_cancel(chrono_digital_timer);
-    chrono_digital_timer = NULL;
-  }
   update_chrono_current_time();
-  if (chrono_digital_window_showing && chrono_data.running) {
-    // Set the timer for the next update.
-    chrono_digital_timer = app_timer_register(CHRONO_DIGITAL_TICK_MS, &handle_chrono_digital_timer, 0);
-  }
+  reset_wake_timer();
 }
 
 void
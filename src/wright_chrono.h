@@ -10,6 +10,8 @@ extern struct HandCache chrono_minute_cache;
 void draw_chrono_dial(GContext *ctx);
 void create_chrono_objects();
 void destroy_chrono_objects();
+void release_chrono_bitmaps();
+void recolor_chrono_bitmaps(const BwdRemap *remap);
 
 #endif // ENABLE_CHRONO_DIAL
 
@@ -30,15 +32,14 @@ extern ChronoData chrono_data;
 
 extern struct HandCache chrono_second_cache;
 
-extern struct ResourceCache chrono_second_resource_cache[CHRONO_SECOND_RESOURCE_CACHE_SIZE];
-extern size_t chrono_second_resource_cache_size;
-
 extern Layer *chrono_minute_layer;
 extern Layer *chrono_second_layer;
 extern Layer *chrono_tenth_layer;
 
 void compute_chrono_hands(unsigned int ms, struct HandPlacement *placement);
 void update_chrono_hands(struct HandPlacement *new_placement);
+unsigned int get_chrono_wake_ms(unsigned int ms);
+void update_chrono_current_time();
 void reset_chrono_digital_timer();
 void record_chrono_lap(int chrono_ms);
 void update_chrono_laps_time();